@@ -0,0 +1,471 @@
+#include "bench_vdc.h"
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <new>
+
+std::atomic<std::size_t> bench_allocations{0};
+
+// Counting replacements of the global allocation functions. The array and
+// nothrow forms forward to these by default.
+void *operator new(std::size_t size)
+{
+    bench_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void print_message()
+{
+    std::cout << "Usage: bench_vdc [vdc OPTIONS] <isovalue> <(nhdr/nrrd) raw data file path>\n";
+    std::cout << "- Runs the vdc pipeline on the input and reports per-stage timings and memory figures.\n";
+    std::cout << "- Accepts the same options as vdc (see vdc --help). Use -multi_isov to exercise Voronoi cells.\n";
+    std::cout << "- -peak_rss {staged|retained}: only run the pipeline and write the mesh, then report the peak RSS,\n";
+    std::cout << "  either releasing each stage as vdc does (staged) or keeping every stage until the mesh is written\n";
+    std::cout << "  (retained). Peak RSS is per process, so compare two runs.\n";
+}
+
+//! @brief Prints a single benchmark result line.
+static void report(const std::string &name, double value, const std::string &unit)
+{
+    std::cout << "[BENCH] " << std::left << std::setw(40) << name << " "
+              << std::right << std::fixed << std::setprecision(3) << value << " " << unit << "\n";
+}
+
+//! @brief Reports the per-cell storage no longer spent on embedded polyhedra.
+/*!
+ * Cells used to embed a CGAL::Polyhedron_3 by value. The figure reported is the
+ * footprint of those (mostly empty) members; heap allocations of populated
+ * polyhedra are not included. Also times building a few polyhedra on demand.
+ */
+static void bench_cell_polyhedra(const VoronoiDiagram &vd)
+{
+    const size_t numCells = vd.cells.size();
+    report("cells", numCells, "");
+    report("sizeof(VoronoiCell)", sizeof(VoronoiCell), "bytes");
+    report("sizeof(Polyhedron_3)", sizeof(Polyhedron_3), "bytes");
+    report("embedded polyhedra avoided", numCells * sizeof(Polyhedron_3) / 1024.0, "KiB");
+
+    const size_t sample = std::min<size_t>(numCells, 100);
+    size_t halfedges = 0;
+    BenchTimer timer;
+    for (size_t i = 0; i < sample; ++i)
+    {
+        halfedges += vd.cellPolyhedron(static_cast<int>(i)).size_of_halfedges();
+    }
+    if (sample > 0)
+    {
+        report("lazy cellPolyhedron() per cell", timer.elapsed_ms() / sample, "ms");
+        report("halfedges per cached cell", static_cast<double>(halfedges) / sample, "");
+    }
+    vd.clearPolyhedronCache();
+}
+
+//! @brief Reports Voronoi edge storage and times a standalone dual-triangle pass.
+/*!
+ * Edges are compact records (vertex indices plus a direction); the dual
+ * Delaunay facets and the other adjacency relations are CSR arrays and are
+ * reported separately.
+ */
+static void bench_voronoi_edges(VoronoiDiagram &vd, VDC_PARAM &vdc_param, Delaunay &dt)
+{
+    const size_t numEdges = vd.edges.size();
+
+    report("voronoi edges", numEdges, "");
+    report("sizeof(VoronoiEdge)", sizeof(VoronoiEdge), "bytes");
+    report("edge records", numEdges * sizeof(VoronoiEdge) / 1024.0, "KiB");
+    report("edge delaunay facets (CSR)", vd.edgeFacets.bytes() / 1024.0, "KiB");
+    report("facet vertices (CSR)", vd.facetVertices.bytes() / 1024.0, "KiB");
+    report("cell vertices (CSR)", vd.cellVertices.bytes() / 1024.0, "KiB");
+    report("cell facets (CSR)", vd.cellFacets.bytes() / 1024.0, "KiB");
+    report("vertex cells (CSR)", vd.vertexCells.bytes() / 1024.0, "KiB");
+
+    IsoSurface scratch;
+    BenchTimer timer;
+    if (vdc_param.multi_isov)
+        computeDualTrianglesMulti(vd, vdc_param.isovalue, scratch);
+    else
+        computeDualTriangles(scratch, vd, dt, vdc_param.isovalue);
+    report("dual triangles", timer.elapsed_ms(), "ms");
+}
+
+//! @brief Reports Voronoi vertex storage and times a value-only bipolarity pass.
+/*!
+ * Vertices are stored as separate coordinate and value arrays; the pass
+ * classifies every vertex against the isovalue and counts bipolar segments.
+ */
+static void bench_vertices(const VoronoiDiagram &vd, float isovalue)
+{
+    report("voronoi vertices", vd.vertices.size(), "");
+    report("vertex arrays (SoA)", vd.vertices.bytes() / 1024.0, "KiB");
+
+    std::vector<unsigned char> above;
+    size_t bipolar = 0;
+    BenchTimer timer;
+    vd.vertices.classify(isovalue, above);
+    for (const auto &edge : vd.edges)
+    {
+        if (edge.type == 0)
+            bipolar += (above[edge.vertex1] != above[edge.vertex2]);
+    }
+    report("classify vertices + bipolar segments", timer.elapsed_ms(), "ms");
+    report("bipolar segments", bipolar, "");
+}
+
+//! @brief Times a bulk build of the vertex weld index and one lookup per vertex.
+/*!
+ * Reports the lookup rate and the probe/collision statistics of the table.
+ */
+static void bench_weld(const VoronoiDiagram &vd)
+{
+    const std::vector<Point> &coords = vd.vertices.coords;
+    VertexWeldIndex weld(vd.vertexWeld.tolerance());
+
+    BenchTimer timer;
+    weld.build(coords);
+    report("weld index bulk build", timer.elapsed_ms(), "ms");
+    report("weld index", weld.bytes() / 1024.0, "KiB");
+    report("weld index load factor", weld.loadFactor(), "");
+
+    size_t mismatches = 0;
+    timer.reset();
+    for (size_t i = 0; i < coords.size(); ++i)
+        mismatches += (weld.find(coords[i], coords) < 0);
+    const double ms = timer.elapsed_ms();
+
+    const WeldStats &st = weld.stats();
+    const double lookups = std::max<double>(1.0, st.lookups);
+    report("weld lookups", st.lookups, "");
+    report("weld lookup rate", ms > 0 ? st.lookups / ms / 1000.0 : 0.0, "M/s");
+    report("weld cells per lookup", st.cells / lookups, "");
+    report("weld probes per lookup", st.probes / lookups, "");
+    report("weld collisions per lookup", st.collisions / lookups, "");
+    if (mismatches > 0)
+        std::cout << "[WARNING] " << mismatches << " vertices not found in the weld index\n";
+}
+
+//! @brief Times the vertex-pair and cell-edge lookups against ordered-map equivalents.
+/*!
+ * Queries every segment edge in segmentVertexPairToEdgeIndex and every cell
+ * edge through findCellEdge(), then repeats the same queries on a std::map
+ * built from the same keys. The checksums guard against dead-code elimination.
+ */
+static void bench_lookups(const VoronoiDiagram &vd)
+{
+    const int rounds = 10;
+
+    std::vector<std::pair<int, int>> segmentKeys;
+    for (const auto &edge : vd.edges)
+    {
+        if (edge.type == 0)
+            segmentKeys.emplace_back(std::min(edge.vertex1, edge.vertex2), std::max(edge.vertex1, edge.vertex2));
+    }
+    std::map<std::pair<int, int>, int> segmentMap;
+    vd.segmentVertexPairToEdgeIndex.forEach([&](int v1, int v2, int edgeIndex)
+                                            { segmentMap[{v1, v2}] = edgeIndex; });
+
+    long long checksum = 0;
+    BenchTimer timer;
+    for (int r = 0; r < rounds; ++r)
+        for (const auto &key : segmentKeys)
+            checksum += vd.segmentVertexPairToEdgeIndex.find(key.first, key.second);
+    const double hashMs = timer.elapsed_ms();
+    timer.reset();
+    for (int r = 0; r < rounds; ++r)
+        for (const auto &key : segmentKeys)
+        {
+            auto it = segmentMap.find(key);
+            checksum -= (it == segmentMap.end()) ? -1 : it->second;
+        }
+    const double mapMs = timer.elapsed_ms();
+    const double segmentQueries = std::max<double>(1.0, rounds * segmentKeys.size());
+    report("vertex pair lookups", segmentQueries, "");
+    report("vertex pair hash lookup", hashMs * 1e6 / segmentQueries, "ns");
+    report("vertex pair std::map lookup", mapMs * 1e6 / segmentQueries, "ns");
+    report("vertex pair hash table", vd.segmentVertexPairToEdgeIndex.bytes() / 1024.0, "KiB");
+
+    if (!vd.cellEdges.empty())
+    {
+        std::map<std::pair<int, int>, int> cellEdgeMap;
+        for (int ceIdx = 0; ceIdx < static_cast<int>(vd.cellEdges.size()); ++ceIdx)
+            cellEdgeMap[{vd.cellEdges[ceIdx].cellIndex, vd.cellEdges[ceIdx].edgeIndex}] = ceIdx;
+
+        timer.reset();
+        for (int r = 0; r < rounds; ++r)
+            for (const auto &ce : vd.cellEdges)
+                checksum += vd.findCellEdge(ce.cellIndex, ce.edgeIndex);
+        const double csrMs = timer.elapsed_ms();
+        timer.reset();
+        for (int r = 0; r < rounds; ++r)
+            for (const auto &ce : vd.cellEdges)
+                checksum -= cellEdgeMap.find({ce.cellIndex, ce.edgeIndex})->second;
+        const double cellMapMs = timer.elapsed_ms();
+        const double cellQueries = static_cast<double>(rounds) * vd.cellEdges.size();
+        report("cell edge lookups", cellQueries, "");
+        report("cell edge per-cell sorted lookup", csrMs * 1e6 / cellQueries, "ns");
+        report("cell edge std::map lookup", cellMapMs * 1e6 / cellQueries, "ns");
+        report("cell edge lookup table", vd.cellEdgeLookup.bytes() / 1024.0, "KiB");
+    }
+
+    if (checksum != 0)
+        std::cout << "[WARNING] Lookup results differ between the tables and std::map\n";
+}
+
+//! @brief Counts heap allocations of multi-isovertex cycle extraction in steady state.
+/*!
+ * Runs Compute_Isosurface_Vertices_Multi() once to warm up its scratch and the
+ * output arrays, then again with the allocation counter running. The second
+ * run should only allocate a fixed handful of times per call, not per cell.
+ */
+static void bench_cycle_allocations(VoronoiDiagram &vd, float isovalue)
+{
+    if (vd.cells.empty())
+        return;
+
+    IsoSurface scratch;
+    Compute_Isosurface_Vertices_Multi(vd, isovalue, scratch);
+
+    const std::size_t before = bench_allocations.load();
+    BenchTimer timer;
+    Compute_Isosurface_Vertices_Multi(vd, isovalue, scratch);
+    const double ms = timer.elapsed_ms();
+    const std::size_t allocations = bench_allocations.load() - before;
+
+    report("cycle extraction (warm)", ms, "ms");
+    report("cycle extraction allocations", allocations, "");
+    report("cycle extraction allocations per cell", static_cast<double>(allocations) / vd.cells.size(), "");
+}
+
+//! @brief Times writing the mesh uncompressed and gzip-compressed at several levels.
+/*!
+ * Throughput is measured in uncompressed megabytes per second, so the figures
+ * of different levels compare directly. The files are written to the current
+ * directory and removed afterwards.
+ */
+static void bench_output(const IsoMesh &mesh)
+{
+    const std::string base = "bench_vdc_output";
+    const struct
+    {
+        const char *name;
+        void (*write)(const std::string &, const IsoMesh &);
+    } formats[] = {
+        {"off", [](const std::string &f, const IsoMesh &m) { writeOFF(f, m); }},
+        {"ply", [](const std::string &f, const IsoMesh &m) { writePLYBinary(f, m); }},
+    };
+
+    for (const auto &format : formats)
+    {
+        const std::string plainName = base + "." + format.name;
+        BenchTimer timer;
+        format.write(plainName, mesh);
+        double ms = timer.elapsed_ms();
+        const double plainBytes = static_cast<double>(std::filesystem::file_size(plainName));
+        std::remove(plainName.c_str());
+        const std::string label = std::string("write ") + format.name;
+        report(label, ms, "ms");
+        report(label + " throughput", ms > 0 ? plainBytes / ms / 1000.0 : 0.0, "MB/s");
+
+        for (int level : {1, 6, 9})
+        {
+            BufferedFileWriter::setGzipLevel(level);
+            const std::string gzName = plainName + ".gz";
+            timer.reset();
+            format.write(gzName, mesh);
+            ms = timer.elapsed_ms();
+            const double gzBytes = static_cast<double>(std::filesystem::file_size(gzName));
+            std::remove(gzName.c_str());
+            const std::string gzLabel = label + ".gz level " + std::to_string(level);
+            report(gzLabel, ms, "ms");
+            report(gzLabel + " throughput", ms > 0 ? plainBytes / ms / 1000.0 : 0.0, "MB/s");
+            report(gzLabel + " ratio", gzBytes > 0 ? plainBytes / gzBytes : 0.0, "");
+        }
+    }
+    BufferedFileWriter::setGzipLevel(6);
+}
+
+//! @brief Compares the isosurface storage with the output mesh and times compaction.
+static void bench_mesh(const IsoSurface &iso_surface, bool multi_isov)
+{
+    const double isoBytes = iso_surface.isosurfaceVertices.size() * sizeof(Point) +
+                            (multi_isov ? iso_surface.isosurfaceTrianglesMulti.size() * sizeof(std::tuple<int, int, int>)
+                                        : iso_surface.isosurfaceTrianglesSingle.size() * sizeof(DelaunayTriangle));
+    report("iso surface vertices + triangles", isoBytes / 1024.0, "KiB");
+
+    IsoMesh mesh;
+    BenchTimer timer;
+    build_iso_mesh(iso_surface, multi_isov, mesh, true); // bench_output() writes OFF
+    report("build output mesh", timer.elapsed_ms(), "ms");
+    report("output mesh", mesh.bytes() / 1024.0, "KiB");
+
+    timer.reset();
+    const size_t removed = mesh.compact();
+    report("mesh compaction", timer.elapsed_ms(), "ms");
+    report("unreferenced isovertices removed", removed, "");
+    report("compacted mesh", mesh.bytes() / 1024.0, "KiB");
+
+    bench_output(mesh);
+}
+
+//! @brief Runs the vdc pipeline once and reports the peak resident set size.
+/*!
+ * With `retain`, the grid, the triangulation, the Voronoi diagram and the
+ * isosurface stay alive until the mesh is written, as they did before the
+ * driver released each stage early; otherwise they are released at the
+ * same points as in vdc. The mesh is written to the current directory and
+ * removed afterwards.
+ */
+static void bench_peak_rss(VDC_PARAM &vdc_param, bool retain)
+{
+    UnifiedGrid data_grid = load_nrrd_data(vdc_param.file_path);
+    if (vdc_param.supersample)
+    {
+        data_grid = supersample_grid(data_grid, vdc_param.supersample_r);
+    }
+
+    std::vector<std::vector<GRID_FACETS>> grid_facets;
+    std::vector<Point> activeCubeCenters;
+    {
+        std::vector<Cube> activeCubes;
+        find_active_cubes(data_grid, vdc_param.isovalue, activeCubes);
+        if (vdc_param.sep_isov)
+        {
+            activeCubes = separate_active_cubes_greedy(activeCubes, data_grid);
+        }
+        grid_facets = create_grid_facets(activeCubes);
+        activeCubeCenters = get_cube_centers(activeCubes);
+    }
+
+    Point p_min(0, 0, 0);
+    Point p_max(data_grid.max_x, data_grid.max_y, data_grid.max_z);
+    K::Iso_cuboid_3 bbox(p_min, p_max);
+
+    auto dt = std::make_unique<Delaunay>();
+    auto vd = std::make_unique<VoronoiDiagram>();
+    construct_delaunay_triangulation(*dt, data_grid, grid_facets, vdc_param, activeCubeCenters);
+    if (!retain)
+        release_memory(grid_facets);
+    if (needs_voronoi_diagram(vdc_param))
+        construct_voronoi_diagram(*vd, vdc_param, data_grid, bbox, *dt);
+
+    IsoSurface iso_surface;
+    construct_iso_surface(*dt, *vd, vdc_param, iso_surface, data_grid, activeCubeCenters, bbox);
+    if (!retain)
+    {
+        vd.reset();
+        dt.reset();
+        data_grid = UnifiedGrid();
+        release_memory(activeCubeCenters);
+    }
+
+    IsoMesh mesh;
+    build_iso_mesh(iso_surface, vdc_param.multi_isov, mesh, is_ascii_mesh_output(vdc_param));
+    if (!retain)
+        iso_surface = IsoSurface();
+
+    vdc_param.output_filename = "bench_vdc_peak_rss." + vdc_param.output_format;
+    bool retFlag;
+    handle_output_mesh(retFlag, vdc_param, mesh);
+    std::remove(vdc_param.output_filename.c_str());
+
+    report(std::string("peak RSS (") + (retain ? "retained" : "staged") + ")", peak_rss_kb() / 1024.0, "MiB");
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3)
+    {
+        print_message();
+        exit(EXIT_FAILURE);
+    }
+
+    // -peak_rss is handled here; the remaining options are those of vdc
+    std::string peak_rss_mode;
+    std::vector<char *> args(argv, argv + argc);
+    for (size_t a = 1; a + 1 < args.size(); ++a)
+    {
+        if (std::string(args[a]) == "-peak_rss")
+        {
+            peak_rss_mode = args[a + 1];
+            args.erase(args.begin() + a, args.begin() + a + 2);
+            break;
+        }
+    }
+    if (!peak_rss_mode.empty() && peak_rss_mode != "staged" && peak_rss_mode != "retained")
+    {
+        std::cerr << "Unknown -peak_rss mode: " << peak_rss_mode << " (expected staged or retained)" << std::endl;
+        print_message();
+        exit(EXIT_FAILURE);
+    }
+
+    VDC_PARAM vdc_param;
+    parse_arguments(static_cast<int>(args.size()), args.data(), vdc_param);
+    debug = false;
+
+    if (!peak_rss_mode.empty())
+    {
+        bench_peak_rss(vdc_param, peak_rss_mode == "retained");
+        return EXIT_SUCCESS;
+    }
+
+    BenchTimer timer;
+    UnifiedGrid data_grid = load_nrrd_data(vdc_param.file_path);
+    if (vdc_param.supersample)
+    {
+        data_grid = supersample_grid(data_grid, vdc_param.supersample_r);
+    }
+    report("load grid", timer.elapsed_ms(), "ms");
+
+    timer.reset();
+    std::vector<Cube> activeCubes;
+    find_active_cubes(data_grid, vdc_param.isovalue, activeCubes);
+    if (vdc_param.sep_isov)
+    {
+        activeCubes = separate_active_cubes_greedy(activeCubes, data_grid);
+    }
+    std::vector<std::vector<GRID_FACETS>> grid_facets = create_grid_facets(activeCubes);
+    std::vector<Point> activeCubeCenters = get_cube_centers(activeCubes);
+    report("active cubes", timer.elapsed_ms(), "ms");
+
+    Point p_min(0, 0, 0);
+    Point p_max(data_grid.max_x, data_grid.max_y, data_grid.max_z);
+    K::Iso_cuboid_3 bbox(p_min, p_max);
+
+    timer.reset();
+    Delaunay dt;
+    construct_delaunay_triangulation(dt, data_grid, grid_facets, vdc_param, activeCubeCenters);
+    report("delaunay triangulation", timer.elapsed_ms(), "ms");
+
+    timer.reset();
+    VoronoiDiagram vd;
+    construct_voronoi_diagram(vd, vdc_param, data_grid, bbox, dt);
+    report("voronoi diagram", timer.elapsed_ms(), "ms");
+
+    timer.reset();
+    IsoSurface iso_surface;
+    construct_iso_surface(dt, vd, vdc_param, iso_surface, data_grid, activeCubeCenters, bbox);
+    report("iso surface", timer.elapsed_ms(), "ms");
+    report("peak RSS after iso surface", peak_rss_kb() / 1024.0, "MiB");
+
+    bench_mesh(iso_surface, vdc_param.multi_isov);
+    bench_voronoi_edges(vd, vdc_param, dt);
+    bench_lookups(vd);
+    bench_weld(vd);
+    bench_vertices(vd, vdc_param.isovalue);
+    bench_cell_polyhedra(vd);
+    if (vdc_param.multi_isov)
+        bench_cycle_allocations(vd, vdc_param.isovalue);
+
+    return EXIT_SUCCESS;
+}
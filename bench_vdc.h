@@ -0,0 +1,32 @@
+#ifndef BENCH_VDC_H
+#define BENCH_VDC_H
+
+#include "vdc.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+
+//! @brief Wall-clock timer for benchmark stages.
+struct BenchTimer
+{
+    std::chrono::steady_clock::time_point start; //!< Time the timer was (re)started.
+
+    BenchTimer() : start(std::chrono::steady_clock::now()) {}
+
+    //! @brief Restarts the timer.
+    void reset() { start = std::chrono::steady_clock::now(); }
+
+    //! @brief Milliseconds elapsed since construction or the last reset.
+    double elapsed_ms() const
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+};
+
+//! @brief Number of calls to the global operator new since program start.
+/*!
+ * bench_vdc replaces the global allocation functions to maintain this count.
+ */
+extern std::atomic<std::size_t> bench_allocations;
+
+#endif
@@ -0,0 +1,92 @@
+#!/usr/bin/env python3
+
+import sys
+import gzip
+import struct
+import numpy as np
+
+MAGIC = b'VDCVD001'
+DTYPES = {ord('i'): '<i4', ord('f'): '<f4', ord('d'): '<f8'}
+
+def read_vd(filename):
+    """
+    Reads a binary Voronoi diagram dump written by `vdc -dump_vd binary`
+    (VoronoiDiagram_<name>.vdb, optionally gzip-compressed as .vdb.gz).
+    Returns a dict mapping column names to numpy arrays; columns with several
+    components per row have shape (rows, components).
+    """
+    opener = gzip.open if filename.endswith('.gz') else open
+    with opener(filename, 'rb') as f:
+        data = f.read()
+
+    if data[:8] != MAGIC:
+        raise ValueError(f"{filename} is not a binary Voronoi diagram dump")
+
+    columns = {}
+    pos = 8
+    while True:
+        (name_len,) = struct.unpack_from('<H', data, pos)
+        pos += 2
+        if name_len == 0:
+            break
+        name = data[pos:pos + name_len].decode('ascii')
+        pos += name_len
+        type_code, components, rows = struct.unpack_from('<BBQ', data, pos)
+        pos += 10
+        dtype = np.dtype(DTYPES[type_code])
+        count = rows * components
+        values = np.frombuffer(data, dtype=dtype, count=count, offset=pos)
+        pos += count * dtype.itemsize
+        columns[name] = values.reshape(rows, components) if components > 1 else values
+    return columns
+
+def csr_rows(offsets, values):
+    """Splits a CSR column pair into one list per row."""
+    return [values[offsets[i]:offsets[i + 1]].tolist() for i in range(len(offsets) - 1)]
+
+def to_vis_structures(columns):
+    """
+    Converts the columns into the structures returned by visVD.parse_vd_info():
+    (voronoi_vertices, voronoi_facets, voronoi_cells, isosurface_vertices).
+    """
+    vertices = columns['vertex']
+    values = columns['vertex_value']
+    voronoi_vertices = {i: tuple(v) for i, v in enumerate(vertices.tolist())}
+
+    voronoi_facets = {}
+    for i, facet in enumerate(csr_rows(columns['facet_offsets'], columns['facet_vertices'])):
+        voronoi_facets[i] = {'vertices_indices': facet,
+                             'vertex_values': [float(values[v]) for v in facet]}
+
+    voronoi_cells = []
+    cell_vertices = csr_rows(columns['cell_vertex_offsets'], columns['cell_vertices'])
+    cell_facets = columns['cell_facets']
+    facet_offsets = columns['cell_facet_offsets']
+    for c, (index, iso_start, iso_count) in enumerate(columns['cell_index_isovertices'].tolist()):
+        voronoi_cells.append({
+            'cell_index': index,
+            'delaunay_vertex': tuple(columns['cell_site'][c].tolist()),
+            'voronoi_vertices_indices': cell_vertices[c],
+            'facet_indices': cell_facets[facet_offsets[c]:facet_offsets[c + 1], 0].tolist(),
+            'isovertex_start_index': iso_start,
+            'number_of_isovertex': iso_count,
+        })
+
+    isosurface_vertices = {}
+    if 'isovertex' in columns:
+        isosurface_vertices = {i: tuple(v) for i, v in enumerate(columns['isovertex'].tolist())}
+
+    return voronoi_vertices, voronoi_facets, voronoi_cells, isosurface_vertices
+
+def main():
+    if len(sys.argv) < 2:
+        print("Usage: python3 readVD.py VoronoiDiagram_<name>.vdb[.gz]")
+        print("Prints the columns of a binary Voronoi diagram dump.")
+        sys.exit(1)
+
+    columns = read_vd(sys.argv[1])
+    for name, values in columns.items():
+        print(f"{name:24s} {str(values.dtype):8s} {values.shape}")
+
+if __name__ == "__main__":
+    main()
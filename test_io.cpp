@@ -0,0 +1,116 @@
+//! @file test_io.cpp
+//! @brief Checks that the ASCII mesh writers print the same text as the former iostream-based writers.
+
+#include "vdc_io.h"
+#include "vdc_mesh.h"
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+//! @brief Formats `value` the way the former writers did: `std::ostream <<` with `precision` digits.
+static std::string iostreamText(double value, int precision)
+{
+    std::ostringstream out;
+    out.precision(precision);
+    out << value;
+    return out.str();
+}
+
+//! @brief Compares formatDouble() with iostreamText() and reports the first few mismatches.
+static int checkValues(const std::vector<double> &values, int precision)
+{
+    int failures = 0;
+    char buffer[32];
+    for (double value : values)
+    {
+        const std::string text(buffer, formatDouble(buffer, value, precision));
+        const std::string expected = iostreamText(value, precision);
+        if (text != expected && ++failures <= 10)
+        {
+            std::cerr << "precision " << precision << ": " << expected << " formatted as " << text << std::endl;
+        }
+    }
+    return failures;
+}
+
+//! @brief Checks that shortest form round-trips every value.
+static int checkShortest(const std::vector<double> &values)
+{
+    int failures = 0;
+    char buffer[32];
+    for (double value : values)
+    {
+        const std::string text(buffer, formatDouble(buffer, value, -1));
+        if (std::strtod(text.c_str(), nullptr) != value && ++failures <= 10)
+        {
+            std::cerr << "shortest: " << text << " does not round-trip" << std::endl;
+        }
+    }
+    return failures;
+}
+
+//! @brief Writes a small mesh with writeOFF() and compares the file with the former writer's output.
+static int checkOFF(const std::vector<double> &values)
+{
+    IsoSurface iso_surface;
+    for (size_t k = 0; k + 2 < values.size(); k += 3)
+        iso_surface.isosurfaceVertices.emplace_back(values[k], values[k + 1], values[k + 2]);
+    const size_t numVerts = iso_surface.isosurfaceVertices.size();
+    for (size_t i = 0; i + 2 < numVerts; i += 3)
+        iso_surface.isosurfaceTrianglesMulti.emplace_back(i, i + 1, i + 2);
+
+    IsoMesh mesh;
+    build_iso_mesh(iso_surface, true, mesh, true);
+    const std::string filename = "test_io_mesh.off";
+    writeOFF(filename, mesh);
+
+    std::ostringstream expected;
+    expected << "OFF\n" << numVerts << " " << iso_surface.isosurfaceTrianglesMulti.size() << " 0\n";
+    for (const Point &p : iso_surface.isosurfaceVertices)
+        expected << p.x() << " " << p.y() << " " << p.z() << "\n";
+    for (const auto &t : iso_surface.isosurfaceTrianglesMulti)
+        expected << "3 " << std::get<0>(t) << " " << std::get<1>(t) << " " << std::get<2>(t) << "\n";
+
+    std::ifstream in(filename, std::ios::binary);
+    const std::string written((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    in.close();
+    std::remove(filename.c_str());
+
+    if (written != expected.str())
+    {
+        std::cerr << "writeOFF output differs from the iostream output" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+int main()
+{
+    std::vector<double> values = {
+        0.0, -0.0, 1.0, -1.0, 0.5, 0.1, 1e-5, 1e-4, 123456.0, 1234567.0, 1e16, 1e-300,
+        89.98185003560202, 12.345650000000001, 99.99995, 0.000123456789, 63.5,
+    };
+    std::mt19937_64 rng(1);
+    std::uniform_real_distribution<double> coordinate(0.0, 256.0);
+    std::uniform_real_distribution<double> exponent(-8.0, 8.0);
+    for (int k = 0; k < 100000; ++k)
+        values.push_back(coordinate(rng));
+    for (int k = 0; k < 10000; ++k)
+        values.push_back((k % 2 ? -1.0 : 1.0) * coordinate(rng) * std::pow(10.0, exponent(rng)));
+
+    int failures = 0;
+    for (int precision = 1; precision <= 9; ++precision)
+        failures += checkValues(values, precision);
+    failures += checkShortest(values);
+    failures += checkOFF(std::vector<double>(values.begin(), values.begin() + 3 * 1000));
+
+    if (failures)
+    {
+        std::cerr << failures << " mismatches" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << "All ASCII formatting checks passed." << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -112,19 +112,18 @@ int main(int argc, char *argv[])
     // Construct Voronoi diagram (skip values as not needed for test)
     construct_voronoi_vertices(vd, dt);
     construct_voronoi_edges(vd, dt);
+    collapseSmallEdges(vd, vdc_param.collapse_eps, dt);
+    clip_unbounded_edges(vd, bbox);
     if (vdc_param.multi_isov) {
         if (vdc_param.convex_hull) {
             construct_voronoi_cells_as_convex_hull(vd, dt);
         } else {
             construct_voronoi_cells_from_delaunay_triangulation(vd, dt);
         }
+        vd.buildVertexCells();
+        construct_voronoi_cell_edges(vd, dt);
     }
-    VoronoiDiagram vd2 = collapseSmallEdges(vd, 0.001, bbox, dt);
-    vd2.check();
-    vd = std::move(vd2);
-    if (vdc_param.multi_isov) {
-        construct_voronoi_cell_edges(vd, bbox, dt);
-    }
+    vd.check();
 
     // Write output
     write_voronoiDiagram(vd, output_filename);
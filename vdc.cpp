@@ -1,43 +1,44 @@
 #include "vdc.h"
 
-int main(int argc, char *argv[])
+//! @brief Runs the pipeline of one isovalue up to the isosurface.
+/*!
+ * Everything built on the way (active cubes, triangulation, Voronoi
+ * diagram) is released before returning; only the isosurface is kept.
+ *
+ * @param data_grid The (supersampled) scalar grid; may be shared with other isovalues.
+ * @param vdc_param The parameters of this isovalue.
+ * @param iso_surface Output isosurface.
+ * @param mesh_stream Output stream for -stream; nullptr to keep the triangles in `iso_surface`.
+ * @return False if the run stops after the Voronoi diagram (--test_vor).
+ */
+static bool extract_isosurface(const UnifiedGrid &data_grid, VDC_PARAM &vdc_param, IsoSurface &iso_surface, MeshStreamWriter *mesh_stream)
 {
-    VoronoiDiagram vd; // Initialize an empty Voronoi diagram.
-    VDC_PARAM vdc_param;
-    IsoSurface iso_surface;
-    Delaunay dt;
-
-    // Parse command-line arguments to set program options and parameters.
-    parse_arguments(argc, argv, vdc_param);
+    // With -checkpoint every stage is saved, and restored when its inputs are unchanged
+    CheckpointStore checkpoints(vdc_param, data_grid);
 
-    // Load the NRRD data file into a grid structure.
-    UnifiedGrid data_grid = load_nrrd_data(vdc_param.file_path);
-
-    // Apply supersampling if requested.
-    if (vdc_param.supersample)
+    std::vector<std::vector<GRID_FACETS>> grid_facets;
+    std::vector<Point> activeCubeCenters;
     {
-        data_grid = supersample_grid(data_grid, vdc_param.supersample_r);
-        if (debug) // Print the supersampled grid if debugging is enabled.
+        std::vector<Cube> activeCubes;
+        if (!checkpoints.loadCubes(activeCubes))
         {
-            data_grid.print_grid();
-        }
-    }
-
-    // Identify active cubes in the grid based on the given isovalue.
-    std::vector<Cube> activeCubes;
-    find_active_cubes(data_grid, vdc_param.isovalue, activeCubes);
+            // Identify active cubes in the grid based on the given isovalue.
+            find_active_cubes(data_grid, vdc_param.isovalue, activeCubes);
 
-    // Separate active cubes to ensure non-adjacency if requested.
-    if (vdc_param.sep_isov)
-    {
-        activeCubes = separate_active_cubes_greedy(activeCubes, data_grid);
-    }
+            // Separate active cubes to ensure non-adjacency if requested.
+            if (vdc_param.sep_isov)
+            {
+                activeCubes = separate_active_cubes_greedy(activeCubes, data_grid);
+            }
+            checkpoints.saveCubes(activeCubes);
+        }
 
-    // Create grid facets from the active cubes for further processing.
-    std::vector<std::vector<GRID_FACETS>> grid_facets = create_grid_facets(activeCubes);
+        // Create grid facets from the active cubes for further processing.
+        grid_facets = create_grid_facets(activeCubes);
 
-    // Extract the centers of the active cubes.
-    std::vector<Point> activeCubeCenters = get_cube_centers(activeCubes);
+        // Extract the centers of the active cubes.
+        activeCubeCenters = get_cube_centers(activeCubes);
+    } // The active cubes are no longer needed
 
     std::cout << "[INFO] Number of active cube centers: " << activeCubeCenters.size() << std::endl;
 
@@ -53,43 +54,237 @@ int main(int argc, char *argv[])
                   << bbox.max() << ")" << std::endl;
     }
 
-    float cubeSideLength = data_grid.dx; // Store the cube side length (equal to grid spacing, assuming regular grid so dx/dy/dz will be equal).
+    // The triangulation and the Voronoi diagram only live until the isosurface
+    // is extracted; the mesh refers to neither of them.
+    {
+        Delaunay dt;
+        VoronoiDiagram vd;
 
-    // Construct the Delaunay triangulation using the grid facets.
-    if (indicator)
+        // Construct the Delaunay triangulation using the grid facets.
+        if (indicator)
+        {
+            std::cout << "[INFO] Constructing Delaunay triangulation..." << std::endl;
+        }
+        if (!checkpoints.loadDelaunay(dt))
+        {
+            construct_delaunay_triangulation(dt, data_grid, grid_facets, vdc_param, activeCubeCenters);
+            checkpoints.saveDelaunay(dt);
+        }
+        release_memory(grid_facets);
+
+        std::cout << dt << std::endl;
+        // Construct the Voronoi diagram based on the Delaunay triangulation.
+        if (indicator)
+        {
+            std::cout << "[INFO] Constructing Voronoi diagram..." << std::endl;
+        }
+
+        // Single-isovertex mode triangulates straight from the Delaunay facets unless the diagram is wanted.
+        const bool build_voronoi = needs_voronoi_diagram(vdc_param);
+        if (build_voronoi)
+        {
+            if (checkpoints.loadVoronoi(vd, dt))
+            {
+                validate_voronoi_diagram(vd, vdc_param);
+            }
+            else
+            {
+                construct_voronoi_diagram(vd, vdc_param, data_grid, bbox, dt);
+                checkpoints.saveVoronoi(vd, dt);
+            }
+        }
+        if (vdc_param.test_vor) {
+            // If test_vor is true means in testing mode for voronoi diagram construction, no need for further move
+            return false;
+        }
+
+
+        if (indicator)
+        {
+            std::cout << "[INFO] Constructing Iso Surface..." << std::endl;
+        }
+        construct_iso_surface(dt, vd, vdc_param, iso_surface, data_grid, activeCubeCenters, bbox, mesh_stream);
+
+        if (build_voronoi)
+        {
+            dump_voronoi_diagram(vd, iso_surface, vdc_param);
+        }
+        if (vdc_param.out_csv)
+        {
+            export_voronoi_to_csv(vd, vdc_param.out_csv_name);
+            std::cout << "[INFO] Voronoi diagram exported to " << vdc_param.out_csv_name << std::endl;
+        }
+    } // Releases the Voronoi diagram and the triangulation
+
+    return true;
+}
+
+//! @brief Writes the isosurface of one isovalue, or finishes its stream.
+/*!
+ * @param vdc_param The parameters of this isovalue.
+ * @param iso_surface The isosurface; released once the mesh is built.
+ * @param mesh_stream The stream the triangles were written to, or nullptr.
+ * @return EXIT_SUCCESS or EXIT_FAILURE.
+ */
+static int write_isosurface(VDC_PARAM &vdc_param, IsoSurface &iso_surface, MeshStreamWriter *mesh_stream)
+{
+    if (mesh_stream)
     {
-        std::cout << "[INFO] Constructing Delaunay triangulation..." << std::endl;
+        const size_t numVertices = iso_surface.isosurfaceVertices.size();
+        iso_surface = IsoSurface();
+        if (!mesh_stream->finish())
+        {
+            std::cerr << "Error while writing file: " << vdc_param.output_filename << std::endl;
+            return EXIT_FAILURE;
+        }
+        std::cout << "Result file at: " << vdc_param.output_filename << std::endl;
+        std::cout << "[INFO] Streamed " << numVertices << " vertices and "
+                  << mesh_stream->numTriangles() << " triangles" << std::endl;
     }
-    construct_delaunay_triangulation(dt, data_grid, grid_facets, vdc_param, activeCubeCenters);
-
-    std::cout << dt << std::endl;
-    // Construct the Voronoi diagram based on the Delaunay triangulation.
-    if (indicator)
+    else
     {
-        std::cout << "[INFO] Constructing Voronoi diagram..." << std::endl;
+        IsoMesh mesh;
+        build_iso_mesh(iso_surface, vdc_param.multi_isov, mesh, is_ascii_mesh_output(vdc_param));
+        iso_surface = IsoSurface();
+        if (vdc_param.compact)
+        {
+            size_t removed = mesh.compact();
+            std::cout << "[INFO] Compaction removed " << removed << " unreferenced isovertices" << std::endl;
+        }
+
+        // Handle the output mesh generation and return the appropriate status.
+        bool retFlag;
+        int retVal = handle_output_mesh(retFlag, vdc_param, mesh);
+        if (retFlag)
+            return retVal;
     }
 
-    construct_voronoi_diagram(vd, vdc_param, data_grid, bbox, dt);
-    if (vdc_param.test_vor) {
-        // If test_vor is true means in testing mode for voronoi diagram construction, no need for further move
+    return EXIT_SUCCESS;
+}
+
+//! @brief Runs the pipeline of one isovalue of -isovalues on the shared grid and writes its mesh.
+/*!
+ * @param data_grid The (supersampled) scalar grid, shared read-only by all isovalues.
+ * @param vdc_param The parameters of this isovalue.
+ * @return EXIT_SUCCESS or EXIT_FAILURE.
+ */
+static int run_isovalue(const UnifiedGrid &data_grid, VDC_PARAM &vdc_param)
+{
+    IsoSurface iso_surface;
+    std::unique_ptr<MeshStreamWriter> mesh_stream;
+    if (!vdc_param.test_vor) // -test_vor writes no mesh
+        mesh_stream = open_mesh_stream(vdc_param);
+    if (!extract_isosurface(data_grid, vdc_param, iso_surface, mesh_stream.get()))
         return EXIT_SUCCESS;
+    return write_isosurface(vdc_param, iso_surface, mesh_stream.get());
+}
+
+//! @brief Runs the pipelines of all isovalues of -isovalues on one grid.
+/*!
+ * The isovalues are distributed over an outer OpenMP loop, and the thread
+ * budget (-threads) is split evenly between the concurrent pipelines, whose
+ * own parallel loops run nested. All pipelines read the same grid.
+ *
+ * @param data_grid The (supersampled) scalar grid, shared by all isovalues.
+ * @param vdc_param The parameters parsed from the command line.
+ * @return EXIT_SUCCESS if every isovalue succeeded, EXIT_FAILURE otherwise.
+ */
+static int run_isovalues(const UnifiedGrid &data_grid, const VDC_PARAM &vdc_param)
+{
+    const int numIsovalues = static_cast<int>(vdc_param.isovalues.size());
+    int numConcurrent = 1;
+    int innerThreads = 1;
+#ifdef _OPENMP
+    const int budget = vdc_param.threads > 0 ? vdc_param.threads : omp_get_max_threads();
+    numConcurrent = std::min(numIsovalues, budget);
+    innerThreads = std::max(1, budget / numConcurrent);
+    omp_set_max_active_levels(2);
+#endif
+    std::cout << "[INFO] Extracting " << numIsovalues << " isovalues, " << numConcurrent
+              << " at a time with " << innerThreads << " thread(s) each" << std::endl;
+
+    std::vector<int> status(numIsovalues, EXIT_FAILURE);
+#pragma omp parallel for schedule(dynamic, 1) num_threads(numConcurrent)
+    for (int k = 0; k < numIsovalues; ++k)
+    {
+#ifdef _OPENMP
+        omp_set_num_threads(innerThreads);
+#endif
+        VDC_PARAM param = param_for_isovalue(vdc_param, k);
+        try
+        {
+            status[k] = run_isovalue(data_grid, param);
+        }
+        catch (const std::exception &e)
+        {
+#pragma omp critical
+            std::cerr << "Error for isovalue " << param.isovalue << ": " << e.what() << std::endl;
+        }
+    }
+
+    int numFailed = 0;
+    for (int k = 0; k < numIsovalues; ++k)
+    {
+        if (status[k] != EXIT_SUCCESS)
+        {
+            std::cerr << "Isovalue " << vdc_param.isovalues[k] << " failed." << std::endl;
+            ++numFailed;
+        }
     }
+    std::cout << "[INFO] " << numIsovalues - numFailed << " of " << numIsovalues << " isovalues extracted" << std::endl;
+    return numFailed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
 
+int main(int argc, char *argv[])
+{
+    VDC_PARAM vdc_param;
+
+    // Parse command-line arguments to set program options and parameters.
+    parse_arguments(argc, argv, vdc_param);
+    BufferedFileWriter::setGzipLevel(vdc_param.gzip_level);
 
-    if (indicator)
+    // Load the NRRD data file into a grid structure.
+    UnifiedGrid data_grid = load_nrrd_data(vdc_param.file_path);
+
+    // Apply supersampling if requested.
+    if (vdc_param.supersample)
     {
-        std::cout << "[INFO] Constructing Iso Surface..." << std::endl;
+        data_grid = supersample_grid(data_grid, vdc_param.supersample_r);
+        if (debug) // Print the supersampled grid if debugging is enabled.
+        {
+            data_grid.print_grid();
+        }
     }
-    construct_iso_surface(dt, vd, vdc_param, iso_surface, data_grid, activeCubeCenters, bbox);
 
-    write_voronoiDiagram(vd, vdc_param.output_filename);
+    int status;
+    if (vdc_param.isovalues.empty())
+    {
+#ifdef _OPENMP
+        if (vdc_param.threads > 0)
+        {
+            omp_set_num_threads(vdc_param.threads);
+        }
+#endif
+        // With -stream the triangles are written while they are generated; -test_vor writes no mesh
+        IsoSurface iso_surface;
+        std::unique_ptr<MeshStreamWriter> mesh_stream;
+        if (!vdc_param.test_vor)
+            mesh_stream = open_mesh_stream(vdc_param);
+        if (!extract_isosurface(data_grid, vdc_param, iso_surface, mesh_stream.get()))
+            return EXIT_SUCCESS;
 
-    // Handle the output mesh generation and return the appropriate status.
-    bool retFlag;
-    int retVal = handle_output_mesh(retFlag, vd, vdc_param, iso_surface);
-    if (retFlag)
-        return retVal;
+        // Only the mesh is needed from here on
+        data_grid = UnifiedGrid();
+        status = write_isosurface(vdc_param, iso_surface, mesh_stream.get());
+    }
+    else
+    {
+        status = run_isovalues(data_grid, vdc_param);
+    }
+    if (status != EXIT_SUCCESS)
+        return status;
 
+    std::cout << "[INFO] Peak resident set size: " << peak_rss_kb() / 1024.0 << " MiB" << std::endl;
     std::cout << "Finished." << std::endl;
 
     return EXIT_SUCCESS;
@@ -4,9 +4,16 @@
 #include "vdc_utilities.h"
 #include "vdc_debug.h"
 #include "vdc_io.h"
+#include "vdc_mesh.h"
 #include "vdc_commandline.h"
 #include "vdc_func.h"
+#include "vdc_checkpoint.h"
+#include <algorithm>
 #include <cstdlib>
 #include <map>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #endif // VDC_H
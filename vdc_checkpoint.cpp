@@ -0,0 +1,760 @@
+//! @file vdc_checkpoint.cpp
+//! @brief Implementation of the pipeline stage checkpoints.
+
+#include "vdc_checkpoint.h"
+#include "vdc_func.h"
+#include "vdc_io.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <tuple>
+#include <unordered_map>
+
+//! Bumped whenever the layout of a checkpoint changes; part of every key.
+static const std::uint32_t checkpointVersion = 1;
+
+static const char *const stageNames[] = {"none", "cubes", "delaunay", "voronoi"};
+
+std::uint64_t fnv1a64(const void *data, size_t size, std::uint64_t hash)
+{
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+//! @brief Folds the bytes of a trivially copyable value into `hash`.
+template <typename T>
+static void hashValue(std::uint64_t &hash, const T &value)
+{
+    hash = fnv1a64(&value, sizeof(T), hash);
+}
+
+//! @brief Reads the little-endian values written through BufferedFileWriter::writeLE().
+class CheckpointReader
+{
+public:
+    explicit CheckpointReader(const std::string &filename) : in(filename, std::ios::binary | std::ios::ate)
+    {
+        fileSize = in ? static_cast<std::uint64_t>(in.tellg()) : 0;
+        in.seekg(0);
+    }
+
+    //! @brief False once a read went past the end of the file or failed.
+    bool good() const { return static_cast<bool>(in); }
+
+    void read(void *data, size_t size) { in.read(static_cast<char *>(data), static_cast<std::streamsize>(size)); }
+
+    template <typename T>
+    T readLE()
+    {
+        unsigned char bytes[sizeof(T)] = {};
+        read(bytes, sizeof(T));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        std::reverse(bytes, bytes + sizeof(T));
+#endif
+        T value;
+        std::memcpy(&value, bytes, sizeof(T));
+        return value;
+    }
+
+    //! @brief Reads a count of records of `recordSize` bytes; fails if they do not fit in the rest of the file.
+    size_t readCount(size_t recordSize)
+    {
+        const std::uint64_t n = readLE<std::uint64_t>();
+        if (!good())
+            return 0;
+        const std::uint64_t remaining = fileSize - static_cast<std::uint64_t>(in.tellg());
+        if (n > remaining / recordSize)
+        {
+            in.setstate(std::ios::failbit);
+            return 0;
+        }
+        return static_cast<size_t>(n);
+    }
+
+private:
+    std::ifstream in;
+    std::uint64_t fileSize; //!< Checks counts before anything is allocated for them
+};
+
+static void writePoint(BufferedFileWriter &out, const Point &p)
+{
+    out.writeLE(static_cast<double>(p.x()));
+    out.writeLE(static_cast<double>(p.y()));
+    out.writeLE(static_cast<double>(p.z()));
+}
+
+static Point readPoint(CheckpointReader &in)
+{
+    const double x = in.readLE<double>();
+    const double y = in.readLE<double>();
+    const double z = in.readLE<double>();
+    return Point(x, y, z);
+}
+
+//! @brief Writes a CSR array; `writeValue(out, value)` writes one entry.
+template <typename T, typename WriteValue>
+static void writeCsr(BufferedFileWriter &out, const CsrArray<T> &csr, WriteValue writeValue)
+{
+    out.writeLE(static_cast<std::uint64_t>(csr.offsets.size()));
+    for (int offset : csr.offsets)
+        out.writeLE(static_cast<std::int32_t>(offset));
+    out.writeLE(static_cast<std::uint64_t>(csr.data.size()));
+    for (const T &value : csr.data)
+        writeValue(out, value);
+}
+
+//! @brief Reads a CSR array written by writeCsr(); `readValue(in)` reads one entry of `valueSize` bytes.
+template <typename T, typename ReadValue>
+static bool readCsr(CheckpointReader &in, CsrArray<T> &csr, size_t valueSize, ReadValue readValue)
+{
+    csr.offsets.resize(in.readCount(sizeof(std::int32_t)));
+    for (int &offset : csr.offsets)
+        offset = in.readLE<std::int32_t>();
+    csr.data.clear();
+    csr.data.reserve(in.readCount(valueSize));
+    for (size_t k = 0, n = csr.data.capacity(); k < n && in.good(); ++k)
+        csr.data.push_back(readValue(in));
+    return in.good() && !csr.offsets.empty() && csr.offsets.back() == static_cast<int>(csr.data.size());
+}
+
+static void writeInt(BufferedFileWriter &out, int value)
+{
+    out.writeLE(static_cast<std::int32_t>(value));
+}
+
+static int readInt(CheckpointReader &in)
+{
+    return in.readLE<std::int32_t>();
+}
+
+//! @brief Opens a checkpoint for writing under a temporary name and writes its header.
+static void writeHeader(BufferedFileWriter &out, CheckpointStage stage, std::uint64_t key)
+{
+    out.write("VDCCKPT1", 8);
+    out.writeLE(static_cast<std::uint32_t>(stage));
+    out.writeLE(key);
+}
+
+// Sizes of the records in a checkpoint, for CheckpointReader::readCount()
+static const size_t pointSize = 3 * sizeof(double);
+static const size_t intSize = sizeof(std::int32_t);
+
+//! @brief Reads and checks the header of a checkpoint.
+static bool readHeader(CheckpointReader &in, CheckpointStage stage, std::uint64_t key)
+{
+    char magic[8] = {};
+    in.read(magic, 8);
+    const std::uint32_t fileStage = in.readLE<std::uint32_t>();
+    const std::uint64_t fileKey = in.readLE<std::uint64_t>();
+    return in.good() && std::memcmp(magic, "VDCCKPT1", 8) == 0 &&
+           fileStage == static_cast<std::uint32_t>(stage) && fileKey == key;
+}
+
+//! @brief Closes a checkpoint written to `tmpPath` and moves it to `finalPath`.
+static void commitCheckpoint(BufferedFileWriter &out, const std::string &tmpPath, const std::string &finalPath)
+{
+    std::error_code ec;
+    if (!out.close())
+    {
+        std::cout << "[WARNING] Could not write checkpoint " << finalPath << std::endl;
+        std::filesystem::remove(tmpPath, ec);
+        return;
+    }
+    std::filesystem::rename(tmpPath, finalPath, ec);
+    if (ec)
+    {
+        std::cout << "[WARNING] Could not write checkpoint " << finalPath << ": " << ec.message() << std::endl;
+        std::filesystem::remove(tmpPath, ec);
+        return;
+    }
+    std::cout << "[INFO] Saved checkpoint " << finalPath << std::endl;
+}
+
+//! Hashes the grid and chains the parameters of each stage onto the previous key.
+CheckpointStore::CheckpointStore(const VDC_PARAM &vdc_param, const UnifiedGrid &grid)
+    : dir(vdc_param.checkpoint_dir), resumeLimit(CheckpointStage::Voronoi)
+{
+    if (!enabled())
+        return;
+
+    for (int s = 0; s <= static_cast<int>(CheckpointStage::Voronoi); ++s)
+    {
+        if (vdc_param.resume_from == stageNames[s])
+            resumeLimit = static_cast<CheckpointStage>(s);
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+    if (ec)
+    {
+        std::cout << "[WARNING] Cannot create checkpoint directory " << dir << ": " << ec.message() << std::endl;
+        dir.clear();
+        return;
+    }
+
+    // Cubes: the scalar grid as used (after supersampling) and the isovalue
+    std::uint64_t key = fnv1a64(grid.flat_data.data(), grid.flat_data.size() * sizeof(float));
+    hashValue(key, checkpointVersion);
+    for (int n : {grid.nx, grid.ny, grid.nz})
+        hashValue(key, n);
+    for (float f : {grid.dx, grid.dy, grid.dz, grid.min_x, grid.min_y, grid.min_z, grid.max_x, grid.max_y, grid.max_z})
+        hashValue(key, f);
+    hashValue(key, vdc_param.isovalue);
+    hashValue(key, vdc_param.sep_isov);
+    keys[static_cast<int>(CheckpointStage::Cubes)] = key;
+
+    // Delaunay: the point set depends on the isovertex mode
+    hashValue(key, vdc_param.multi_isov);
+    keys[static_cast<int>(CheckpointStage::Delaunay)] = key;
+
+    // Voronoi: collapsing, cell construction and whether cells are built lazily
+    const bool lazyCells = !needs_full_voronoi_diagram(vdc_param);
+    hashValue(key, vdc_param.collapse_eps);
+    hashValue(key, vdc_param.convex_hull);
+    hashValue(key, lazyCells);
+    keys[static_cast<int>(CheckpointStage::Voronoi)] = key;
+}
+
+std::string CheckpointStore::path(CheckpointStage stage) const
+{
+    char hex[17];
+    std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(keys[static_cast<int>(stage)]));
+    return (std::filesystem::path(dir) / (std::string(stageNames[static_cast<int>(stage)]) + "-" + hex + ".ckpt")).string();
+}
+
+bool CheckpointStore::mayResume(CheckpointStage stage) const
+{
+    return enabled() && stage <= resumeLimit && std::filesystem::exists(path(stage));
+}
+
+//! Active cubes: representative vertex, center and grid indices.
+bool CheckpointStore::loadCubes(std::vector<Cube> &activeCubes)
+{
+    if (!mayResume(CheckpointStage::Cubes))
+        return false;
+    CheckpointReader in(path(CheckpointStage::Cubes));
+    if (!readHeader(in, CheckpointStage::Cubes, keys[static_cast<int>(CheckpointStage::Cubes)]))
+        return false;
+
+    std::vector<Cube> cubes(in.readCount(2 * pointSize + 3 * intSize));
+    for (Cube &cube : cubes)
+    {
+        cube.repVertex = readPoint(in);
+        cube.center = readPoint(in);
+        cube.i = readInt(in);
+        cube.j = readInt(in);
+        cube.k = readInt(in);
+    }
+    if (!in.good())
+        return false;
+
+    activeCubes.swap(cubes);
+    std::cout << "[INFO] Resumed active cubes from " << path(CheckpointStage::Cubes) << std::endl;
+    return true;
+}
+
+void CheckpointStore::saveCubes(const std::vector<Cube> &activeCubes)
+{
+    if (!enabled())
+        return;
+    const std::string finalPath = path(CheckpointStage::Cubes);
+    const std::string tmpPath = finalPath + ".tmp";
+    BufferedFileWriter out(tmpPath);
+    writeHeader(out, CheckpointStage::Cubes, keys[static_cast<int>(CheckpointStage::Cubes)]);
+    out.writeLE(static_cast<std::uint64_t>(activeCubes.size()));
+    for (const Cube &cube : activeCubes)
+    {
+        writePoint(out, cube.repVertex);
+        writePoint(out, cube.center);
+        writeInt(out, cube.i);
+        writeInt(out, cube.j);
+        writeInt(out, cube.k);
+    }
+    commitCheckpoint(out, tmpPath, finalPath);
+}
+
+//! @brief Sorts four vertex numbers; identifies a cell independently of its vertex order.
+static std::array<int, 4> cellKey(int v0, int v1, int v2, int v3)
+{
+    std::array<int, 4> key = {v0, v1, v2, v3};
+    std::sort(key.begin(), key.end());
+    return key;
+}
+
+//! @brief Vertex numbers of a cell in the checkpoint numbering; -1 for the infinite vertex.
+static std::array<int, 4> cellVertexSerials(const Delaunay &dt, Cell_handle c,
+                                            const std::unordered_map<const void *, int> &vertexSerial)
+{
+    std::array<int, 4> v;
+    for (int j = 0; j < 4; ++j)
+    {
+        Vertex_handle vh = c->vertex(j);
+        v[j] = dt.is_infinite(vh) ? -1 : vertexSerial.at(&*vh);
+    }
+    return v;
+}
+
+//! Hash of the point of every vertex and the vertex set of every cell, in checkpoint order.
+std::uint64_t CheckpointStore::triangulationHash(const Delaunay &dt) const
+{
+    std::unordered_map<const void *, int> vertexSerial;
+    vertexSerial.reserve(vertexBySerial.size());
+    std::uint64_t hash = fnv1a64(nullptr, 0);
+    for (size_t s = 0; s < vertexBySerial.size(); ++s)
+    {
+        vertexSerial[&*vertexBySerial[s]] = static_cast<int>(s);
+        const Point &p = vertexBySerial[s]->point();
+        for (double coord : {static_cast<double>(p.x()), static_cast<double>(p.y()), static_cast<double>(p.z())})
+            hashValue(hash, coord);
+    }
+    for (Cell_handle c : cellBySerial)
+    {
+        const std::array<int, 4> v = cellVertexSerials(dt, c, vertexSerial);
+        hashValue(hash, cellKey(v[0], v[1], v[2], v[3]));
+    }
+    return hash;
+}
+
+//! Numbers the finite vertices and all cells in iteration order.
+void CheckpointStore::numberTriangulation(const Delaunay &dt)
+{
+    vertexBySerial.clear();
+    for (auto vit = dt.finite_vertices_begin(); vit != dt.finite_vertices_end(); ++vit)
+        vertexBySerial.push_back(vit);
+    cellBySerial.clear();
+    for (auto cit = dt.all_cells_begin(); cit != dt.all_cells_end(); ++cit)
+        cellBySerial.push_back(cit);
+    delaunayHash = triangulationHash(dt);
+}
+
+//! CGAL's binary triangulation, then the vertex info and cell info in checkpoint order.
+void CheckpointStore::saveDelaunay(const Delaunay &dt)
+{
+    if (!enabled())
+        return;
+    numberTriangulation(dt);
+
+    std::ostringstream cgal(std::ios::out | std::ios::binary);
+    CGAL::IO::set_binary_mode(cgal);
+    cgal << dt;
+    const std::string bytes = cgal.str();
+
+    const std::string finalPath = path(CheckpointStage::Delaunay);
+    const std::string tmpPath = finalPath + ".tmp";
+    BufferedFileWriter out(tmpPath);
+    writeHeader(out, CheckpointStage::Delaunay, keys[static_cast<int>(CheckpointStage::Delaunay)]);
+    out.writeLE(static_cast<std::uint64_t>(bytes.size()));
+    out.write(bytes);
+
+    std::unordered_map<const void *, int> vertexSerial;
+    vertexSerial.reserve(vertexBySerial.size());
+    out.writeLE(static_cast<std::uint64_t>(vertexBySerial.size()));
+    for (size_t s = 0; s < vertexBySerial.size(); ++s)
+    {
+        Vertex_handle vh = vertexBySerial[s];
+        vertexSerial[&*vh] = static_cast<int>(s);
+        writePoint(out, vh->point());
+        out.writeLE(static_cast<std::uint8_t>(vh->info().is_dummy));
+        writeInt(out, vh->info().voronoiCellIndex);
+        writeInt(out, vh->info().index);
+    }
+    out.writeLE(static_cast<std::uint64_t>(cellBySerial.size()));
+    for (Cell_handle c : cellBySerial)
+    {
+        for (int v : cellVertexSerials(dt, c, vertexSerial))
+            writeInt(out, v);
+        writeInt(out, c->info().dualVoronoiVertexIndex);
+        writeInt(out, c->info().index);
+    }
+    commitCheckpoint(out, tmpPath, finalPath);
+}
+
+//! Reads CGAL's triangulation, then matches the stored vertices by point and the stored cells by vertex set.
+bool CheckpointStore::loadDelaunay(Delaunay &dt)
+{
+    if (!mayResume(CheckpointStage::Delaunay))
+        return false;
+    CheckpointReader in(path(CheckpointStage::Delaunay));
+    if (!readHeader(in, CheckpointStage::Delaunay, keys[static_cast<int>(CheckpointStage::Delaunay)]))
+        return false;
+
+    std::string bytes(in.readCount(1), '\0');
+    in.read(&bytes[0], bytes.size());
+    if (!in.good())
+        return false;
+    {
+        std::istringstream cgal(bytes, std::ios::in | std::ios::binary);
+        CGAL::IO::set_binary_mode(cgal);
+        dt.clear();
+        bool ok = false;
+        try
+        {
+            ok = static_cast<bool>(cgal >> dt);
+        }
+        catch (const std::exception &e)
+        {
+            std::cout << "[WARNING] Ignoring Delaunay checkpoint: " << e.what() << std::endl;
+        }
+        if (!ok)
+        {
+            dt.clear();
+            return false;
+        }
+    }
+
+    // Stored vertices, matched to the loaded ones by coordinates
+    const size_t numVertices = in.readCount(pointSize + 1 + 2 * intSize);
+    std::vector<Point> points(numVertices);
+    std::vector<VERTEX_INFO> vertexInfo(numVertices);
+    for (size_t s = 0; s < numVertices && in.good(); ++s)
+    {
+        points[s] = readPoint(in);
+        vertexInfo[s].is_dummy = in.readLE<std::uint8_t>() != 0;
+        vertexInfo[s].voronoiCellIndex = readInt(in);
+        vertexInfo[s].index = readInt(in);
+    }
+
+    auto pointLess = [](const Point &a, const Point &b)
+    {
+        return std::make_tuple(a.x(), a.y(), a.z()) < std::make_tuple(b.x(), b.y(), b.z());
+    };
+    std::vector<Vertex_handle> loadedVertices;
+    loadedVertices.reserve(numVertices);
+    for (auto vit = dt.finite_vertices_begin(); vit != dt.finite_vertices_end(); ++vit)
+        loadedVertices.push_back(vit);
+    if (!in.good() || loadedVertices.size() != numVertices)
+        return false;
+    std::sort(loadedVertices.begin(), loadedVertices.end(),
+              [&](Vertex_handle a, Vertex_handle b) { return pointLess(a->point(), b->point()); });
+    std::vector<int> storedOrder(numVertices);
+    for (size_t s = 0; s < numVertices; ++s)
+        storedOrder[s] = static_cast<int>(s);
+    std::sort(storedOrder.begin(), storedOrder.end(),
+              [&](int a, int b) { return pointLess(points[a], points[b]); });
+
+    vertexBySerial.assign(numVertices, Vertex_handle());
+    std::unordered_map<const void *, int> vertexSerial;
+    vertexSerial.reserve(numVertices);
+    for (size_t k = 0; k < numVertices; ++k)
+    {
+        const int s = storedOrder[k];
+        Vertex_handle vh = loadedVertices[k];
+        if (pointLess(vh->point(), points[s]) || pointLess(points[s], vh->point()))
+            return false;
+        vh->info() = vertexInfo[s];
+        vertexBySerial[s] = vh;
+        vertexSerial[&*vh] = s;
+    }
+
+    // Stored cells, matched to the loaded ones by vertex set
+    const size_t numCells = in.readCount(6 * intSize);
+    std::vector<std::pair<std::array<int, 4>, int>> storedCells(numCells);
+    std::vector<CELL_INFO> cellInfo(numCells);
+    for (size_t s = 0; s < numCells && in.good(); ++s)
+    {
+        int v[4];
+        for (int &vi : v)
+            vi = readInt(in);
+        storedCells[s] = {cellKey(v[0], v[1], v[2], v[3]), static_cast<int>(s)};
+        cellInfo[s].dualVoronoiVertexIndex = readInt(in);
+        cellInfo[s].index = readInt(in);
+    }
+    std::vector<std::pair<std::array<int, 4>, Cell_handle>> loadedCells;
+    loadedCells.reserve(numCells);
+    for (auto cit = dt.all_cells_begin(); cit != dt.all_cells_end(); ++cit)
+    {
+        Cell_handle c = cit;
+        const std::array<int, 4> v = cellVertexSerials(dt, c, vertexSerial);
+        loadedCells.push_back({cellKey(v[0], v[1], v[2], v[3]), c});
+    }
+    if (!in.good() || loadedCells.size() != numCells)
+        return false;
+    std::sort(storedCells.begin(), storedCells.end());
+    std::sort(loadedCells.begin(), loadedCells.end(),
+              [](const auto &a, const auto &b) { return a.first < b.first; });
+
+    cellBySerial.assign(numCells, Cell_handle());
+    for (size_t k = 0; k < numCells; ++k)
+    {
+        if (storedCells[k].first != loadedCells[k].first)
+            return false;
+        Cell_handle c = loadedCells[k].second;
+        c->info() = cellInfo[storedCells[k].second];
+        cellBySerial[storedCells[k].second] = c;
+    }
+
+    delaunayHash = triangulationHash(dt);
+    std::cout << "[INFO] Resumed Delaunay triangulation from " << path(CheckpointStage::Delaunay) << std::endl;
+    return true;
+}
+
+//! All members of the diagram except the weld index, which is rebuilt; Delaunay handles are stored as checkpoint numbers.
+void CheckpointStore::saveVoronoi(const VoronoiDiagram &vd, const Delaunay &dt)
+{
+    if (!enabled() || (vertexBySerial.empty() && cellBySerial.empty()))
+        return;
+
+    std::unordered_map<const void *, int> vertexSerial, cellSerial;
+    vertexSerial.reserve(vertexBySerial.size());
+    cellSerial.reserve(cellBySerial.size());
+    for (size_t s = 0; s < vertexBySerial.size(); ++s)
+        vertexSerial[&*vertexBySerial[s]] = static_cast<int>(s);
+    for (size_t s = 0; s < cellBySerial.size(); ++s)
+        cellSerial[&*cellBySerial[s]] = static_cast<int>(s);
+    auto vertexNumber = [&](Vertex_handle vh)
+    {
+        return dt.is_infinite(vh) ? -1 : vertexSerial.at(&*vh);
+    };
+
+    const std::string finalPath = path(CheckpointStage::Voronoi);
+    const std::string tmpPath = finalPath + ".tmp";
+    BufferedFileWriter out(tmpPath);
+    writeHeader(out, CheckpointStage::Voronoi, keys[static_cast<int>(CheckpointStage::Voronoi)]);
+    out.writeLE(delaunayHash);
+
+    // Triangulation info set while building the diagram
+    for (Vertex_handle vh : vertexBySerial)
+        writeInt(out, vh->info().voronoiCellIndex);
+    for (Cell_handle c : cellBySerial)
+        writeInt(out, c->info().dualVoronoiVertexIndex);
+
+    // Vertices and values
+    out.writeLE(static_cast<std::uint64_t>(vd.vertices.size()));
+    for (size_t i = 0; i < vd.vertices.size(); ++i)
+    {
+        writePoint(out, vd.vertices.coords[i]);
+        out.writeLE(vd.vertices.values[i]);
+    }
+
+    out.writeLE(static_cast<std::uint64_t>(vd.edges.size()));
+    for (const VoronoiEdge &edge : vd.edges)
+    {
+        writeInt(out, edge.type);
+        writeInt(out, edge.vertex1);
+        writeInt(out, edge.vertex2);
+        writeInt(out, edge.clipIndex);
+        for (double d : edge.direction)
+            out.writeLE(d);
+    }
+
+    out.writeLE(static_cast<std::uint64_t>(vd.cellEdges.size()));
+    for (const VoronoiCellEdge &ce : vd.cellEdges)
+    {
+        writeInt(out, ce.cellIndex);
+        writeInt(out, ce.edgeIndex);
+        writeInt(out, ce.nextCellEdge);
+    }
+
+    out.writeLE(static_cast<std::uint64_t>(vd.cells.size()));
+    for (const VoronoiCell &vc : vd.cells)
+    {
+        writeInt(out, vertexNumber(vc.delaunay_vertex));
+        writeInt(out, vc.cellIndex);
+        writeInt(out, vc.isoVertexStartIndex);
+        writeInt(out, vc.numIsoVertices);
+    }
+
+    out.writeLE(static_cast<std::uint64_t>(vd.cycles.size()));
+    for (const Cycle &cycle : vd.cycles)
+    {
+        writePoint(out, cycle.isovertex);
+        writeInt(out, cycle.voronoi_cell_index);
+    }
+
+    writeCsr(out, vd.edgeFacets, [&](BufferedFileWriter &o, const Facet &f)
+             {
+                 writeInt(o, cellSerial.at(&*f.first));
+                 writeInt(o, vertexNumber(f.first->vertex(f.second)));
+             });
+    writeCsr(out, vd.facetVertices, writeInt);
+    writeCsr(out, vd.cellVertices, writeInt);
+    writeCsr(out, vd.cellFacets, [](BufferedFileWriter &o, const VoronoiFacetRef &ref)
+             {
+                 writeInt(o, ref.facet_index);
+                 writeInt(o, ref.orientation);
+             });
+    writeCsr(out, vd.cellEdgeCycles, writeInt);
+    writeCsr(out, vd.cycleMidpoints, writeInt);
+    writeCsr(out, vd.vertexCells, writeInt);
+    writeCsr(out, vd.cellEdgeLookup, [](BufferedFileWriter &o, const std::pair<int, int> &entry)
+             {
+                 writeInt(o, entry.first);
+                 writeInt(o, entry.second);
+             });
+
+    out.writeLE(static_cast<std::uint64_t>(vd.segmentVertexPairToEdgeIndex.size()));
+    vd.segmentVertexPairToEdgeIndex.forEach([&](int v1, int v2, int edgeIndex)
+                                            {
+                                                writeInt(out, v1);
+                                                writeInt(out, v2);
+                                                writeInt(out, edgeIndex);
+                                            });
+
+    out.writeLE(static_cast<std::uint64_t>(vd.clippedEdges.size()));
+    for (const ClippedEdge &ce : vd.clippedEdges)
+    {
+        writePoint(out, ce.source);
+        writePoint(out, ce.target);
+        writeInt(out, ce.sourceVertex);
+        writeInt(out, ce.targetVertex);
+        out.writeLE(ce.sourceValue);
+        out.writeLE(ce.targetValue);
+    }
+    commitCheckpoint(out, tmpPath, finalPath);
+}
+
+//! Reads the members in the order saveVoronoi() wrote them; the triangulation must carry the same numbering.
+bool CheckpointStore::loadVoronoi(VoronoiDiagram &vd, Delaunay &dt)
+{
+    if (!mayResume(CheckpointStage::Voronoi) || (vertexBySerial.empty() && cellBySerial.empty()))
+        return false;
+    CheckpointReader in(path(CheckpointStage::Voronoi));
+    if (!readHeader(in, CheckpointStage::Voronoi, keys[static_cast<int>(CheckpointStage::Voronoi)]))
+        return false;
+    if (in.readLE<std::uint64_t>() != delaunayHash)
+        return false; // Built on a different numbering of the triangulation
+
+    const int numVertices = static_cast<int>(vertexBySerial.size());
+    const int numCells = static_cast<int>(cellBySerial.size());
+    auto vertexHandle = [&](int s) -> Vertex_handle
+    {
+        if (s == -1)
+            return dt.infinite_vertex();
+        if (s < 0 || s >= numVertices)
+            throw std::runtime_error("Voronoi checkpoint refers to a missing Delaunay vertex");
+        return vertexBySerial[s];
+    };
+
+    std::vector<int> voronoiCellIndex(numVertices), dualVoronoiVertexIndex(numCells);
+    for (int &v : voronoiCellIndex)
+        v = readInt(in);
+    for (int &v : dualVoronoiVertexIndex)
+        v = readInt(in);
+
+    VoronoiDiagram loaded;
+    try
+    {
+        const size_t numVoronoiVertices = in.readCount(pointSize + sizeof(float));
+        loaded.vertices.coords.reserve(numVoronoiVertices);
+        loaded.vertices.values.reserve(numVoronoiVertices);
+        for (size_t i = 0; i < numVoronoiVertices && in.good(); ++i)
+        {
+            loaded.vertices.coords.push_back(readPoint(in));
+            loaded.vertices.values.push_back(in.readLE<float>());
+        }
+
+        loaded.edges.resize(in.readCount(4 * intSize + 3 * sizeof(double)));
+        for (VoronoiEdge &edge : loaded.edges)
+        {
+            edge.type = readInt(in);
+            edge.vertex1 = readInt(in);
+            edge.vertex2 = readInt(in);
+            edge.clipIndex = readInt(in);
+            for (double &d : edge.direction)
+                d = in.readLE<double>();
+        }
+
+        const size_t numCellEdges = in.readCount(3 * intSize);
+        loaded.cellEdges.reserve(numCellEdges);
+        for (size_t k = 0; k < numCellEdges && in.good(); ++k)
+        {
+            VoronoiCellEdge ce;
+            ce.cellIndex = readInt(in);
+            ce.edgeIndex = readInt(in);
+            ce.nextCellEdge = readInt(in);
+            loaded.cellEdges.push_back(ce);
+        }
+
+        const size_t numVoronoiCells = in.readCount(4 * intSize);
+        loaded.cells.reserve(numVoronoiCells);
+        for (size_t k = 0; k < numVoronoiCells && in.good(); ++k)
+        {
+            VoronoiCell vc(vertexHandle(readInt(in)));
+            vc.cellIndex = readInt(in);
+            vc.isoVertexStartIndex = readInt(in);
+            vc.numIsoVertices = readInt(in);
+            loaded.cells.push_back(vc);
+        }
+
+        loaded.cycles.resize(in.readCount(pointSize + intSize));
+        for (Cycle &cycle : loaded.cycles)
+        {
+            cycle.isovertex = readPoint(in);
+            cycle.voronoi_cell_index = readInt(in);
+        }
+
+        bool ok = readCsr(in, loaded.edgeFacets, 2 * intSize, [&](CheckpointReader &r)
+                          {
+                              const int cs = readInt(r);
+                              const int vs = readInt(r);
+                              if (cs < 0 || cs >= numCells)
+                                  throw std::runtime_error("Voronoi checkpoint refers to a missing Delaunay cell");
+                              Cell_handle c = cellBySerial[cs];
+                              return Facet(c, c->index(vertexHandle(vs)));
+                          });
+        ok = ok && readCsr(in, loaded.facetVertices, intSize, readInt);
+        ok = ok && readCsr(in, loaded.cellVertices, intSize, readInt);
+        ok = ok && readCsr(in, loaded.cellFacets, 2 * intSize, [](CheckpointReader &r)
+                           {
+                               VoronoiFacetRef ref;
+                               ref.facet_index = readInt(r);
+                               ref.orientation = readInt(r);
+                               return ref;
+                           });
+        ok = ok && readCsr(in, loaded.cellEdgeCycles, intSize, readInt);
+        ok = ok && readCsr(in, loaded.cycleMidpoints, intSize, readInt);
+        ok = ok && readCsr(in, loaded.vertexCells, intSize, readInt);
+        ok = ok && readCsr(in, loaded.cellEdgeLookup, 2 * intSize, [](CheckpointReader &r)
+                           {
+                               const int edgeIndex = readInt(r);
+                               const int cellEdgeIndex = readInt(r);
+                               return std::make_pair(edgeIndex, cellEdgeIndex);
+                           });
+        if (!ok)
+            return false;
+
+        const size_t numPairs = in.readCount(3 * intSize);
+        for (size_t k = 0; k < numPairs && in.good(); ++k)
+        {
+            const int v1 = readInt(in);
+            const int v2 = readInt(in);
+            loaded.segmentVertexPairToEdgeIndex.set(v1, v2, readInt(in));
+        }
+
+        loaded.clippedEdges.resize(in.readCount(2 * pointSize + 2 * intSize + 2 * sizeof(float)));
+        for (ClippedEdge &ce : loaded.clippedEdges)
+        {
+            ce.source = readPoint(in);
+            ce.target = readPoint(in);
+            ce.sourceVertex = readInt(in);
+            ce.targetVertex = readInt(in);
+            ce.sourceValue = in.readLE<float>();
+            ce.targetValue = in.readLE<float>();
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << "[WARNING] Ignoring Voronoi checkpoint: " << e.what() << std::endl;
+        return false;
+    }
+    if (!in.good())
+        return false;
+
+    loaded.vertexWeld.build(loaded.vertices.coords);
+    for (int s = 0; s < numVertices; ++s)
+        vertexBySerial[s]->info().voronoiCellIndex = voronoiCellIndex[s];
+    for (int s = 0; s < numCells; ++s)
+        cellBySerial[s]->info().dualVoronoiVertexIndex = dualVoronoiVertexIndex[s];
+    vd = std::move(loaded);
+
+    std::cout << "[INFO] Resumed Voronoi diagram from " << path(CheckpointStage::Voronoi) << std::endl;
+    return true;
+}
@@ -0,0 +1,81 @@
+//! @file vdc_checkpoint.h
+//! @brief Binary checkpoints of the pipeline stages, keyed by a hash of the input and the parameters.
+
+#ifndef VDC_CHECKPOINT_H
+#define VDC_CHECKPOINT_H
+
+#include "vdc_commandline.h"
+#include "vdc_grid.h"
+#include "vdc_voronoi.h"
+#include <cstdint>
+
+//! @brief Pipeline stages that can be checkpointed, in pipeline order.
+enum class CheckpointStage
+{
+    None = 0,     //!< Nothing is resumed
+    Cubes = 1,    //!< Active cubes (after -sep_isov)
+    Delaunay = 2, //!< Delaunay triangulation with vertex and cell info
+    Voronoi = 3   //!< Voronoi diagram with values
+};
+
+//! @brief 64-bit FNV-1a hash of `size` bytes, continuing from `hash`.
+std::uint64_t fnv1a64(const void *data, size_t size, std::uint64_t hash = 14695981039346656037ULL);
+
+//! @brief Saves and restores the intermediate products of the pipeline.
+/*!
+ * With -checkpoint <dir>, every stage that is computed is written to
+ * `<dir>/<stage>-<key>.ckpt`, and a later run resumes from the last stage
+ * whose file matches its key (no later than -resume_from). The key of a
+ * stage is an FNV-1a hash of the scalar grid and of the parameters the
+ * stage depends on, chained with the key of the previous stage; output
+ * format, validation level and similar options are not part of any key.
+ *
+ * The Delaunay triangulation is stored with CGAL's binary format plus the
+ * vertex and cell info, matched back by point coordinates and vertex sets.
+ * The Voronoi diagram refers to the triangulation by vertex and cell
+ * numbers of that file and stores a hash of the numbering, so it is only
+ * restored on top of the same triangulation. Files are written under a temporary name
+ * and renamed, so an interrupted run leaves no partial checkpoint.
+ */
+class CheckpointStore
+{
+public:
+    //! @brief Computes the stage keys; does nothing if `vdc_param.checkpoint_dir` is empty.
+    CheckpointStore(const VDC_PARAM &vdc_param, const UnifiedGrid &grid);
+
+    //! @brief True if checkpointing is enabled.
+    bool enabled() const { return !dir.empty(); }
+
+    //! @brief Restores the active cubes; false if there is no usable checkpoint.
+    bool loadCubes(std::vector<Cube> &activeCubes);
+
+    //! @brief Saves the active cubes.
+    void saveCubes(const std::vector<Cube> &activeCubes);
+
+    //! @brief Restores the triangulation; false if there is no usable checkpoint.
+    bool loadDelaunay(Delaunay &dt);
+
+    //! @brief Saves the triangulation and numbers its vertices and cells for saveVoronoi().
+    void saveDelaunay(const Delaunay &dt);
+
+    //! @brief Restores the Voronoi diagram and the triangulation info it set; false if there is no usable checkpoint.
+    bool loadVoronoi(VoronoiDiagram &vd, Delaunay &dt);
+
+    //! @brief Saves the Voronoi diagram; requires loadDelaunay() or saveDelaunay() in this run.
+    void saveVoronoi(const VoronoiDiagram &vd, const Delaunay &dt);
+
+private:
+    std::string path(CheckpointStage stage) const;
+    bool mayResume(CheckpointStage stage) const;
+    void numberTriangulation(const Delaunay &dt);
+    std::uint64_t triangulationHash(const Delaunay &dt) const;
+
+    std::string dir;                          //!< Checkpoint directory; empty if disabled
+    CheckpointStage resumeLimit;              //!< Latest stage that may be restored
+    std::uint64_t keys[4] = {0, 0, 0, 0};     //!< Key of each stage, indexed by CheckpointStage
+    std::vector<Vertex_handle> vertexBySerial; //!< Finite vertices in checkpoint order
+    std::vector<Cell_handle> cellBySerial;    //!< All cells in checkpoint order
+    std::uint64_t delaunayHash = 0;           //!< Hash of the numbering above, stored with the Voronoi diagram
+};
+
+#endif // VDC_CHECKPOINT_H
@@ -3,17 +3,33 @@
 //! Prints the help message for the program.
 void print_help()
 {
-    std::cout << "Usage: vdc [OPTIONS] <isovalue> <(nhdr/nrrd) raw data file path>\n\n";
+    std::cout << "Usage: vdc [OPTIONS] <isovalue> <(nhdr/nrrd) raw data file path>\n";
+    std::cout << "       vdc [OPTIONS] -isovalues <v1,v2,...> <(nhdr/nrrd) raw data file path>\n\n";
     std::cout << "OPTIONS:\n";
     std::cout << "  -o {output_filename}        : Specify output filename (default: derived from input filename).\n";
     std::cout << "  -off                        : Generate output in .off format (default).\n";
     std::cout << "  -ply                        : Generate output in .ply format.\n";
+    std::cout << "  -binary                     : Write .ply output as binary_little_endian instead of ASCII.\n";
+    std::cout << "  -bin                        : Generate output as a raw binary vertex/index dump (.bin).\n";
+    std::cout << "  -precision {digits|shortest}: Significant digits of ASCII output coordinates (default: 6).\n";
     std::cout << "  -out_csv {output_csv_name}  : Write the Voronoi diagram to a CSV file.\n";
+    std::cout << "  -dump_vd {text|binary}      : Dump the Voronoi diagram to VoronoiDiagram_<output>.txt or .vdb (default: no dump).\n";
+    std::cout << "  -gz                         : gzip the mesh and CSV output (also implied by a .gz file name).\n";
+    std::cout << "  -gz_level {0-9}             : Compression level of .gz output (default: 6).\n";
     std::cout << "  -sep_isov                   : Pick a subset of non-adjacent active cubes of the input data before constructing triangulation.\n";
     std::cout << "  -supersample {factor}       : Supersample the input data by the given factor.\n";
     std::cout << "  -multi_isov                 : Use multi iso-vertices mode.\n";
     std::cout << "  -single_isov                : Use single iso-vertices mode (default).\n";
     std::cout << "  -conv_H                     : Use the Convex_Hull_3 from CGAL in voronoi cell construction.\n";
+    std::cout << "  -full_vor                   : Build the full Voronoi diagram (multi-isov: every cell; single-isov: the diagram at all).\n";
+    std::cout << "  -collapse_eps {distance}    : Collapse Voronoi edges not longer than distance (default: 0.001, 0 disables).\n";
+    std::cout << "  -validate {none|cheap|full} : Voronoi diagram checks after construction (default: cheap).\n";
+    std::cout << "  -compact                    : Drop isovertices not used by any triangle from the output mesh.\n";
+    std::cout << "  -stream                     : Write triangles while they are generated (binary PLY or .bin output).\n";
+    std::cout << "  -checkpoint {dir}           : Save the pipeline stages to dir and resume from matching checkpoints.\n";
+    std::cout << "  -resume_from {stage}        : Latest stage to resume: none, cubes, delaunay or voronoi (default: voronoi).\n";
+    std::cout << "  -isovalues {v1,v2,...}      : Extract several isovalues from one load of the grid, one output file each.\n";
+    std::cout << "  -threads {count}            : Thread budget shared by the isovalues (default: OpenMP default).\n";
     std::cout << "  --help                      : Print this help message.\n";
 }
 
@@ -45,11 +61,57 @@ void parse_arguments(int argc, char *argv[], VDC_PARAM &vp)
         {
             vp.output_format = "ply"; // Set output format to .ply.
         }
+        else if (arg == "-binary")
+        {
+            vp.binary = true; // Write binary PLY.
+        }
+        else if (arg == "-bin")
+        {
+            vp.output_format = "bin"; // Set output format to a raw binary dump.
+        }
+        else if (arg == "-precision" && i + 1 < argc)
+        {
+            std::string digits = argv[++i];
+            if (digits == "shortest")
+                vp.precision = -1; // Shortest round-trip form.
+            else
+                vp.precision = std::atoi(digits.c_str());
+            if (vp.precision == 0 || vp.precision > 9)
+            {
+                std::cerr << "Invalid precision: " << digits << " (expected 1-9 or shortest)" << std::endl;
+                print_help();
+                exit(EXIT_FAILURE);
+            }
+        }
         else if (arg == "-out_csv" && i + 1 < argc)
         {
             vp.out_csv = true;                // Enable CSV output.
             vp.out_csv_name = argv[++i];      // Set CSV output filename
         }
+        else if (arg == "-dump_vd" && i + 1 < argc)
+        {
+            vp.dump_vd = argv[++i];
+            if (vp.dump_vd != "text" && vp.dump_vd != "binary")
+            {
+                std::cerr << "Invalid Voronoi diagram dump format: " << vp.dump_vd << " (expected text or binary)" << std::endl;
+                print_help();
+                exit(EXIT_FAILURE);
+            }
+        }
+        else if (arg == "-gz")
+        {
+            vp.gzip = true; // Compress mesh and CSV output.
+        }
+        else if (arg == "-gz_level" && i + 1 < argc)
+        {
+            vp.gzip_level = std::atoi(argv[++i]);
+            if (vp.gzip_level < 0 || vp.gzip_level > 9)
+            {
+                std::cerr << "Invalid compression level: " << argv[i] << " (expected 0-9)" << std::endl;
+                print_help();
+                exit(EXIT_FAILURE);
+            }
+        }
         else if (arg == "-sep_isov")
         {
             vp.sep_isov = true; // Enable separation of non-adjacent active cubes.
@@ -80,6 +142,96 @@ void parse_arguments(int argc, char *argv[], VDC_PARAM &vp)
         {
             vp.convex_hull = true;
         }
+        else if (arg == "-full_vor")
+        {
+            vp.full_vor = true; // Build the full Voronoi diagram.
+        }
+        else if (arg == "-collapse_eps" && i + 1 < argc)
+        {
+            vp.collapse_eps = std::atof(argv[++i]); // Set small-edge collapse threshold.
+        }
+        else if (arg == "-validate" && i + 1 < argc)
+        {
+            std::string level = argv[++i];
+            if (level == "none")
+                vp.validate = ValidationLevel::None;
+            else if (level == "cheap")
+                vp.validate = ValidationLevel::Cheap;
+            else if (level == "full")
+                vp.validate = ValidationLevel::Full;
+            else
+            {
+                std::cerr << "Unknown validation level: " << level << std::endl;
+                print_help();
+                exit(EXIT_FAILURE);
+            }
+        }
+        else if (arg == "-compact")
+        {
+            vp.compact = true; // Remove unreferenced isovertices before writing.
+        }
+        else if (arg == "-stream")
+        {
+            vp.stream = true; // Overlap output with triangle generation.
+        }
+        else if (arg == "-checkpoint" && i + 1 < argc)
+        {
+            vp.checkpoint_dir = argv[++i]; // Save and resume pipeline stages.
+        }
+        else if ((arg == "-resume_from" || arg == "-resume-from") && i + 1 < argc)
+        {
+            vp.resume_from = argv[++i];
+            if (vp.resume_from != "none" && vp.resume_from != "cubes" &&
+                vp.resume_from != "delaunay" && vp.resume_from != "voronoi")
+            {
+                std::cerr << "Unknown pipeline stage: " << vp.resume_from << std::endl;
+                print_help();
+                exit(EXIT_FAILURE);
+            }
+        }
+        else if (arg == "-isovalues" && i + 1 < argc)
+        {
+            // Comma-separated list, e.g. 0.1,0.2,0.5
+            std::stringstream list(argv[++i]);
+            std::string item;
+            while (std::getline(list, item, ','))
+            {
+                char *end = nullptr;
+                float value = std::strtof(item.c_str(), &end);
+                if (item.empty() || std::isspace(static_cast<unsigned char>(item[0])) || *end != '\0')
+                {
+                    std::cerr << "Invalid isovalue in list: " << item << std::endl;
+                    print_help();
+                    exit(EXIT_FAILURE);
+                }
+                vp.isovalues.push_back(value);
+                vp.isovalue_tags.push_back(item);
+            }
+            std::vector<float> sorted = vp.isovalues;
+            std::sort(sorted.begin(), sorted.end());
+            if (std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end())
+            {
+                std::cerr << "Duplicate isovalue in list: " << argv[i] << std::endl;
+                print_help();
+                exit(EXIT_FAILURE);
+            }
+            if (vp.isovalues.empty())
+            {
+                std::cerr << "Empty isovalue list." << std::endl;
+                print_help();
+                exit(EXIT_FAILURE);
+            }
+        }
+        else if (arg == "-threads" && i + 1 < argc)
+        {
+            vp.threads = std::atoi(argv[++i]);
+            if (vp.threads < 1)
+            {
+                std::cerr << "Invalid thread count: " << argv[i] << std::endl;
+                print_help();
+                exit(EXIT_FAILURE);
+            }
+        }
         else if (arg == "--test_vor")
         {
             vp.test_vor = true;
@@ -94,15 +246,19 @@ void parse_arguments(int argc, char *argv[], VDC_PARAM &vp)
         ++i;
     }
 
-    // Parse required arguments: isovalue and file path.
-    if (i + 2 > argc)
+    // Parse required arguments: isovalue (unless -isovalues is given) and file path.
+    const int required = vp.isovalues.empty() ? 2 : 1;
+    if (i + required > argc)
     {
         std::cerr << "Error: Missing required arguments.\n";
         print_help();
         exit(EXIT_FAILURE);
     }
 
-    vp.isovalue = std::atof(argv[i++]); // Parse isovalue as a floating-point number.
+    if (vp.isovalues.empty())
+        vp.isovalue = std::atof(argv[i++]); // Parse isovalue as a floating-point number.
+    else
+        vp.isovalue = vp.isovalues.front();
     vp.file_path = argv[i++];           // Parse the raw data file path.
 
     // Generate default output filename if not specified.
@@ -140,4 +296,42 @@ void parse_arguments(int argc, char *argv[], VDC_PARAM &vp)
         // Add file format extension.
         vp.output_filename += "." + vp.output_format;
     }
+
+    // Compressed output is selected by the file name suffix.
+    if (vp.gzip)
+    {
+        for (std::string *name : {&vp.output_filename, &vp.out_csv_name})
+        {
+            if (name->size() < 3 || name->compare(name->size() - 3, 3, ".gz") != 0)
+                *name += ".gz";
+        }
+    }
+}
+
+//! @brief Inserts `tag` before the extension of `filename`, keeping a trailing ".gz".
+static std::string insert_before_extension(const std::string &filename, const std::string &tag)
+{
+    size_t end = filename.size();
+    if (end >= 3 && filename.compare(end - 3, 3, ".gz") == 0)
+        end -= 3;
+    const size_t slash = filename.find_last_of("/\\");
+    size_t dot = filename.find_last_of('.', end == 0 ? 0 : end - 1);
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+        dot = end;
+    return filename.substr(0, dot) + tag + filename.substr(dot);
+}
+
+//! Copies the parameters and gives the isovalue its own output files.
+VDC_PARAM param_for_isovalue(const VDC_PARAM &vp, size_t k)
+{
+    VDC_PARAM param = vp;
+    param.isovalue = vp.isovalues[k];
+    param.isovalues.clear();
+    param.isovalue_tags.clear();
+
+    // The entry as written: equal values are rejected while parsing, so tags never collide
+    const std::string tag = "_iso-" + vp.isovalue_tags[k];
+    param.output_filename = insert_before_extension(vp.output_filename, tag);
+    param.out_csv_name = insert_before_extension(vp.out_csv_name, tag);
+    return param;
 }
@@ -15,9 +15,14 @@
 struct VDC_PARAM {
     std::string file_path;         //!< Path to the input raw data file (nhdr/nrrd format).
     float isovalue;                //!< The isovalue used for isosurface extraction.
-    std::string output_format;     //!< The format of the output file ("off" or "ply").
+    std::vector<float> isovalues;  //!< Isovalues extracted in one run with -isovalues; empty for a single isovalue.
+    std::vector<std::string> isovalue_tags; //!< The -isovalues entries as written; they name the output files.
+    std::string output_format;     //!< The format of the output file ("off", "ply" or "bin").
     std::string output_filename;   //!< The name of the output file.
     std::string out_csv_name;      //!< The name of the CSV file for Voronoi diagram export.
+    std::string dump_vd;           //!< Voronoi diagram dump format ("text" or "binary"); empty for no dump.
+    std::string checkpoint_dir;    //!< Directory of the pipeline stage checkpoints; empty to disable checkpointing.
+    std::string resume_from;       //!< Latest stage restored from a checkpoint ("none", "cubes", "delaunay" or "voronoi").
     
     bool out_csv;                  //!< Flag to enable exporting Voronoi diagram to CSV.
     bool sep_isov;                 //!< Flag to enable separation of non-adjacent active cubes.
@@ -26,8 +31,18 @@ struct VDC_PARAM {
     bool add_bounding_cells;       //!< Flag to include bounding cells in the Voronoi diagram.
     bool convex_hull;              //!< Flag to enable convex hull computation in building voronoi cells
     bool test_vor = false;         //!< Flag for testing the Voronoi diagram construction
+    bool full_vor;                 //!< Flag to build the full Voronoi diagram (every cell in multi-isov mode; at all in single-isov mode)
+    bool compact;                  //!< Flag to drop isovertices not used by any triangle from the output mesh
+    bool binary;                   //!< Flag to write PLY output as binary_little_endian instead of ASCII
+    bool stream;                   //!< Flag to write triangles to the output file while they are generated
+    bool gzip;                     //!< Flag to gzip the mesh and CSV output (appends ".gz" to their names)
 
     int supersample_r;             //!< Factor by which the input data is supersampled.
+    int precision;                 //!< Significant digits of ASCII output coordinates; negative for shortest round-trip.
+    int gzip_level;                //!< Deflate level (0-9) of ".gz" output files.
+    int threads;                   //!< Thread budget shared by all isovalues; 0 for the OpenMP default.
+    double collapse_eps;           //!< Voronoi edges not longer than this are collapsed; 0 disables collapsing.
+    ValidationLevel validate;      //!< Checks run on the Voronoi diagram after construction.
 
     //! @brief Constructor to initialize default parameter values.
     VDC_PARAM()
@@ -36,13 +51,26 @@ struct VDC_PARAM {
           output_format("off"),
           output_filename(""),
           out_csv_name("voronoi.csv"),
+          dump_vd(""),
+          checkpoint_dir(""),
+          resume_from("voronoi"),
           out_csv(false),
           sep_isov(false),
           multi_isov(false),
           supersample(false),
           add_bounding_cells(false),
           convex_hull(false),
-          supersample_r(1)
+          full_vor(false),
+          compact(false),
+          binary(false),
+          stream(false),
+          gzip(false),
+          supersample_r(1),
+          precision(6),
+          gzip_level(6),
+          threads(0),
+          collapse_eps(0.001),
+          validate(ValidationLevel::Cheap)
     {}
 };
 
@@ -64,4 +92,17 @@ void print_help();
  */
 void parse_arguments(int argc, char *argv[], VDC_PARAM &vp);
 
+//! @brief Parameters of one isovalue of an -isovalues run.
+/*!
+ * Copies `vp` with `isovalue` set to `vp.isovalues[k]` and "_iso-<entry>"
+ * inserted before the extension of the mesh and CSV file names, where
+ * <entry> is the list entry as written. Entries of distinct isovalues
+ * differ, so every isovalue writes its own files.
+ *
+ * @param vp The parameters parsed from the command line.
+ * @param k Index into `vp.isovalues`.
+ * @return The parameters of the k-th isovalue.
+ */
+VDC_PARAM param_for_isovalue(const VDC_PARAM &vp, size_t k);
+
 #endif // VDC_COMMANDLINE_H
\ No newline at end of file
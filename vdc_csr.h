@@ -0,0 +1,171 @@
+//! @file vdc_csr.h
+//! @brief Compressed-sparse-row (CSR) storage for the index relations of the Voronoi diagram.
+
+#ifndef VDC_CSR_H
+#define VDC_CSR_H
+
+#include <cstddef>
+#include <vector>
+
+//! @brief Non-owning view of a contiguous row of a CsrArray.
+/*!
+ * A minimal span: valid until the owning CsrArray is modified.
+ */
+template <typename T>
+class CsrSpan
+{
+public:
+    CsrSpan() : first(nullptr), last(nullptr) {}
+    CsrSpan(T *b, T *e) : first(b), last(e) {}
+
+    //! @brief Converts a mutable row view to a read-only one.
+    template <typename U>
+    CsrSpan(const CsrSpan<U> &other) : first(other.begin()), last(other.end()) {}
+
+    T *begin() const { return first; }
+    T *end() const { return last; }
+    std::size_t size() const { return static_cast<std::size_t>(last - first); }
+    bool empty() const { return first == last; }
+    T &operator[](std::size_t i) const { return first[i]; }
+    T &front() const { return *first; }
+    T &back() const { return *(last - 1); }
+
+private:
+    T *first; //!< First element of the row
+    T *last;  //!< One past the last element of the row
+};
+
+//! @brief A relation stored as row offsets plus one flat value array.
+/*!
+ * Row `i` occupies `data[offsets[i] .. offsets[i+1])`. Rows can be appended
+ * in order with appendRow(), or built out of order with counting passes:
+ *
+ *     csr.startCounts(numRows);
+ *     for (...) csr.count(row);      // pass 1: row sizes
+ *     csr.allocate();                // prefix sum, one allocation
+ *     for (...) csr.fill(row, v);    // pass 2: same order as pass 1
+ *     csr.finish();
+ *
+ * Values inside a row keep the order in which they were filled.
+ */
+template <typename T>
+struct CsrArray
+{
+    std::vector<int> offsets{0}; //!< Row offsets into `data`; rows() + 1 entries
+    std::vector<T> data;         //!< Row values, concatenated
+
+    //! @brief Number of rows.
+    std::size_t rows() const { return offsets.size() - 1; }
+
+    //! @brief Total number of values over all rows.
+    std::size_t entries() const { return data.size(); }
+
+    //! @brief Read-only view of row `i`.
+    CsrSpan<const T> row(int i) const
+    {
+        return CsrSpan<const T>(data.data() + offsets[i], data.data() + offsets[i + 1]);
+    }
+
+    //! @brief Mutable view of row `i`.
+    CsrSpan<T> row(int i)
+    {
+        return CsrSpan<T>(data.data() + offsets[i], data.data() + offsets[i + 1]);
+    }
+
+    //! @brief Number of values in row `i`.
+    int rowSize(int i) const { return offsets[i + 1] - offsets[i]; }
+
+    //! @brief Removes all rows.
+    void clear()
+    {
+        offsets.assign(1, 0);
+        data.clear();
+        cursor.clear();
+    }
+
+    //! @brief Reserves storage for `numRows` rows and `numEntries` values.
+    void reserve(std::size_t numRows, std::size_t numEntries)
+    {
+        offsets.reserve(numRows + 1);
+        data.reserve(numEntries);
+    }
+
+    //! @brief Appends a row holding the values in [b, e).
+    /*!
+     * @return Index of the new row.
+     */
+    template <typename It>
+    int appendRow(It b, It e)
+    {
+        data.insert(data.end(), b, e);
+        offsets.push_back(static_cast<int>(data.size()));
+        return static_cast<int>(rows()) - 1;
+    }
+
+    //! @brief Appends a row holding all values of `values`.
+    template <typename Range>
+    int appendRow(const Range &values)
+    {
+        return appendRow(values.begin(), values.end());
+    }
+
+    //! @brief Starts a counting pass over `numRows` rows.
+    void startCounts(std::size_t numRows)
+    {
+        offsets.assign(numRows + 1, 0);
+        data.clear();
+        cursor.clear();
+    }
+
+    //! @brief Counts `n` values for row `i` (first pass).
+    void count(int i, int n = 1) { offsets[i + 1] += n; }
+
+    //! @brief Turns counts into offsets and sizes the value array.
+    void allocate()
+    {
+        for (std::size_t i = 1; i < offsets.size(); ++i)
+            offsets[i] += offsets[i - 1];
+        data.resize(offsets.back());
+        cursor.assign(offsets.begin(), offsets.end() - 1);
+    }
+
+    //! @brief Stores the next value of row `i` (second pass).
+    void fill(int i, const T &value) { data[cursor[i]++] = value; }
+
+    //! @brief Releases the fill cursors once the second pass is done.
+    void finish() { std::vector<int>().swap(cursor); }
+
+    //! @brief Approximate heap footprint in bytes.
+    std::size_t bytes() const
+    {
+        return offsets.capacity() * sizeof(int) + data.capacity() * sizeof(T);
+    }
+
+private:
+    std::vector<int> cursor; //!< Per-row write position during the fill pass
+};
+
+//! @brief Builds the transpose of a relation with two counting passes.
+/*!
+ * Row `j` of the result lists, in increasing order, every row `i` of `in`
+ * that contains `j`.
+ *
+ * @param in Relation whose values are row indices of the result.
+ * @param numRows Number of rows of the result.
+ * @param out Output relation.
+ */
+inline void transposeCsr(const CsrArray<int> &in, std::size_t numRows, CsrArray<int> &out)
+{
+    out.startCounts(numRows);
+    for (int v : in.data)
+        out.count(v);
+    out.allocate();
+    for (int i = 0; i < static_cast<int>(in.rows()); ++i)
+    {
+        for (int v : in.row(i))
+            out.fill(v, i);
+    }
+    out.finish();
+}
+
+#endif // VDC_CSR_H
@@ -5,25 +5,29 @@
 #define VDC_DELAUNAY_H
 
 #include "vdc_type.h"
+#include <cstdint>
 
 //! @brief Represents a triangle in the Delaunay triangulation.
 /*!
- * This structure is used to store the geometric representation of a triangle,
- * defined by three vertices.
+ * A triangle of the single-isovertex mesh. The Delaunay vertices are resolved
+ * to their isosurface vertex indices (`info().index`) when the triangle is
+ * created, so the mesh does not refer to the triangulation afterwards.
  */
 struct DelaunayTriangle {
-    Vertex_handle vertex1; //!< First vertex of the triangle.
-    Vertex_handle vertex2; //!< Second vertex of the triangle.
-    Vertex_handle vertex3; //!< Third vertex of the triangle.
+    std::uint32_t vertex1; //!< Isosurface vertex index of the first vertex.
+    std::uint32_t vertex2; //!< Isosurface vertex index of the second vertex.
+    std::uint32_t vertex3; //!< Isosurface vertex index of the third vertex.
 
     //! @brief Constructor to initialize a DelaunayTriangle.
     /*!
-     * @param v1 Coordinates of the first vertex.
-     * @param v2 Coordinates of the second vertex.
-     * @param v3 Coordinates of the third vertex.
+     * @param v1 Handle of the first vertex.
+     * @param v2 Handle of the second vertex.
+     * @param v3 Handle of the third vertex.
      */
-    DelaunayTriangle(Vertex_handle v1, Vertex_handle v2, Vertex_handle v3) 
-        : vertex1(v1), vertex2(v2), vertex3(v3) {}
+    DelaunayTriangle(Vertex_handle v1, Vertex_handle v2, Vertex_handle v3)
+        : vertex1(static_cast<std::uint32_t>(v1->info().index)),
+          vertex2(static_cast<std::uint32_t>(v2->info().index)),
+          vertex3(static_cast<std::uint32_t>(v3->info().index)) {}
 };
 
 //! @brief Represents a triangle on an isosurface.
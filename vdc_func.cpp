@@ -2,6 +2,7 @@
 //! @brief Implementation of functions for Voronoi Diagram and Isosurface computation.
 
 #include "vdc_func.h"
+#include <filesystem>
 
 //! @brief Helper function - returns the index of the vertex matching p, or -1 if not found.
 
@@ -56,27 +57,29 @@ static void generateTriangle(
  * Checks if the segment is bipolar and generates triangles for each associated
  * Delaunay facet.
  *
- * @param edge The CGAL object representing the edge.
+ * @param edge The Voronoi edge to process.
+ * @param dualFacets The Delaunay facets dual to the edge.
  * @param vd The Voronoi Diagram.
  * @param isovalue The isovalue for bipolarity check.
  * @param dt The Delaunay triangulation.
  * @param dualTriangles Vector to store generated triangles.
  */
 static void processSegmentEdge(
-    VoronoiEdge &edge,
+    const VoronoiEdge &edge,
+    CsrSpan<const Facet> dualFacets,
     VoronoiDiagram &vd,
     float isovalue,
     Delaunay &dt,
     std::vector<DelaunayTriangle> &dualTriangles)
 {
-    Point v1 = vd.vertices[edge.vertex1].coord;
-    Point v2 = vd.vertices[edge.vertex2].coord;
-    float v1_val = vd.vertices[edge.vertex1].value;
-    float v2_val = vd.vertices[edge.vertex2].value;
+    const Point &v1 = vd.vertices.coords[edge.vertex1];
+    const Point &v2 = vd.vertices.coords[edge.vertex2];
+    float v1_val = vd.vertices.values[edge.vertex1];
+    float v2_val = vd.vertices.values[edge.vertex2];
 
     if (is_bipolar(v1_val, v2_val, isovalue))
     {
-        for (const auto &facet : edge.delaunayFacets)
+        for (const auto &facet : dualFacets)
         {
             int iFacet = facet.second;
             Cell_handle c = facet.first;
@@ -96,46 +99,35 @@ static void processSegmentEdge(
 
 //! @brief Processes a ray edge for dual triangle computation.
 /*!
- * Intersects the ray with the bounding box, checks bipolarity, and generates
+ * Uses the cached clipped part of the ray, checks bipolarity, and generates
  * triangles for associated Delaunay facets.
  *
- * @param ray The ray edge to process.
- * @param edge The CGAL object representing the edge.
- * @param bbox The bounding box for intersection.
- * @param grid The scalar grid for interpolation.
+ * @param edge The Voronoi ray edge to process.
+ * @param dualFacets The Delaunay facets dual to the edge.
+ * @param vd The Voronoi Diagram.
  * @param isovalue The isovalue for bipolarity check.
  * @param dt The Delaunay triangulation.
  * @param dualTriangles Vector to store generated triangles.
  */
 static void processRayEdge(
-    const Ray3 &ray,
-    VoronoiEdge &edge,
+    const VoronoiEdge &edge,
+    CsrSpan<const Facet> dualFacets,
     VoronoiDiagram &vd,
-    CGAL::Epick::Iso_cuboid_3 &bbox,
-    UnifiedGrid &grid,
     float isovalue,
     Delaunay &dt,
     std::vector<DelaunayTriangle> &dualTriangles)
 {
-    CGAL::Object intersectObj = CGAL::intersection(bbox, ray);
-    Segment3 iseg;
-    if (CGAL::assign(iseg, intersectObj))
+    if (const ClippedEdge *clip = vd.clippedEdge(edge))
     {
-        Point v1 = iseg.source();
-        Point v2 = iseg.target();
-        int idx_v1 = find_vertex_index(vd, v1);
-        float v1_val = vd.vertices[idx_v1].value;
-        float iPt_value = trilinear_interpolate(adjust_outside_bound_points(v2, grid, v1, v2), grid);
+        const Point &v1 = clip->source;
+        const Point &v2 = clip->target;
+        float v1_val = clip->sourceValue;
+        float iPt_value = clip->targetValue;
 
         if (is_bipolar(v1_val, iPt_value, isovalue))
         {
-            Point positive = (v1_val >= iPt_value) ? v1 : v2;
-
-            for (const auto &facet : edge.delaunayFacets)
+            for (const auto &facet : dualFacets)
             {
-                Facet mirror_f = dt.mirror_facet(facet);
-                Object e = dt.dual(facet);
-
                 int iFacet = facet.second;
                 Cell_handle c = facet.first;
                 int d1 = (iFacet + 1) % 4;
@@ -155,41 +147,34 @@ static void processRayEdge(
 
 //! @brief Processes a line edge for dual triangle computation.
 /*!
- * Intersects the line with the bounding box, checks bipolarity, and generates
+ * Uses the cached clipped part of the line, checks bipolarity, and generates
  * triangles for associated Delaunay facets.
  *
- * @param line The line edge to process.
- * @param edge The CGAL object representing the edge.
- * @param grid The scalar grid for interpolation.
+ * @param edge The Voronoi line edge to process.
+ * @param dualFacets The Delaunay facets dual to the edge.
+ * @param vd The Voronoi Diagram.
  * @param isovalue The isovalue for bipolarity check.
- * @param bbox The bounding box for intersection.
  * @param dt The Delaunay triangulation.
  * @param dualTriangles Vector to store generated triangles.
  */
 static void processLineEdge(
-    const Line3 &line,
-    VoronoiEdge &edge,
-    UnifiedGrid &grid,
+    const VoronoiEdge &edge,
+    CsrSpan<const Facet> dualFacets,
+    VoronoiDiagram &vd,
     float isovalue,
-    CGAL::Epick::Iso_cuboid_3 &bbox,
     Delaunay &dt,
     std::vector<DelaunayTriangle> &dualTriangles)
 {
-    CGAL::Object intersectObj = CGAL::intersection(bbox, line);
-    Segment3 iseg;
-    if (CGAL::assign(iseg, intersectObj))
+    if (const ClippedEdge *clip = vd.clippedEdge(edge))
     {
-        Point intersection1 = iseg.source();
-        Point intersection2 = iseg.target();
-
-        float iPt1_val = trilinear_interpolate(adjust_outside_bound_points(intersection1, grid, intersection1, intersection2), grid);
-        float iPt2_val = trilinear_interpolate(adjust_outside_bound_points(intersection2, grid, intersection1, intersection2), grid);
+        const Point &intersection1 = clip->source;
+        const Point &intersection2 = clip->target;
+        float iPt1_val = clip->sourceValue;
+        float iPt2_val = clip->targetValue;
 
         if (is_bipolar(iPt1_val, iPt2_val, isovalue))
         {
-            Point positive = (iPt1_val >= iPt2_val) ? intersection1 : intersection2;
-
-            for (const auto &facet : edge.delaunayFacets)
+            for (const auto &facet : dualFacets)
             {
                 int iFacet = facet.second;
                 Cell_handle c = facet.first;
@@ -208,50 +193,275 @@ static void processLineEdge(
     }
 }
 
+//! @brief Runs a triangle generator over all Voronoi edges in parallel, keeping the serial order.
+/*!
+ * The edges are split into fixed blocks of consecutive indices. Blocks are
+ * processed concurrently, each into its own buffer, and the buffers are then
+ * appended to `triangles` in block order. The result is the same as calling
+ * `processEdge` for every edge in order, independently of the thread count.
+ *
+ * @param numEdges Number of Voronoi edges.
+ * @param triangles Output vector; triangles are appended.
+ * @param processEdge Called as processEdge(edgeIndex, buffer); must only read shared data.
+ */
+template <typename Triangle, typename EdgeFunction>
+static void generateEdgeTrianglesOrdered(int numEdges, std::vector<Triangle> &triangles, EdgeFunction processEdge)
+{
+    const int blockSize = 4096;
+    const int numBlocks = (numEdges + blockSize - 1) / blockSize;
+    std::vector<std::vector<Triangle>> blockTriangles(numBlocks);
+
+#pragma omp parallel for schedule(dynamic, 1)
+    for (int b = 0; b < numBlocks; ++b)
+    {
+        const int end = std::min(numEdges, (b + 1) * blockSize);
+        for (int ei = b * blockSize; ei < end; ++ei)
+            processEdge(ei, blockTriangles[b]);
+    }
+
+    std::size_t total = triangles.size();
+    for (const auto &block : blockTriangles)
+        total += block.size();
+    triangles.reserve(total);
+    for (const auto &block : blockTriangles)
+        triangles.insert(triangles.end(), block.begin(), block.end());
+}
+
+//! @brief Appends the three vertex indices of a single-isovertex triangle.
+static void appendTriangleIndices(const DelaunayTriangle &triangle, std::vector<std::uint32_t> &indices)
+{
+    indices.push_back(triangle.vertex1);
+    indices.push_back(triangle.vertex2);
+    indices.push_back(triangle.vertex3);
+}
+
+//! @brief Appends the three vertex indices of a multi-isovertex triangle.
+static void appendTriangleIndices(const std::tuple<int, int, int> &triangle, std::vector<std::uint32_t> &indices)
+{
+    indices.push_back(static_cast<std::uint32_t>(std::get<0>(triangle)));
+    indices.push_back(static_cast<std::uint32_t>(std::get<1>(triangle)));
+    indices.push_back(static_cast<std::uint32_t>(std::get<2>(triangle)));
+}
+
+//! @brief Runs a triangle generator over all Voronoi edges and streams the triangles to a file.
+/*!
+ * Like generateEdgeTrianglesOrdered(), but the blocks are processed in waves.
+ * After each wave its triangles are handed to `stream` in block order and the
+ * block buffers are reused, so only one wave of triangles is in memory and the
+ * file is written while the next wave is generated.
+ *
+ * @param numEdges Number of Voronoi edges.
+ * @param stream Destination of the triangles; its vertices must already be written.
+ * @param processEdge Called as processEdge(edgeIndex, buffer); must only read shared data.
+ */
+template <typename Triangle, typename EdgeFunction>
+static void streamEdgeTrianglesOrdered(int numEdges, MeshStreamWriter &stream, EdgeFunction processEdge)
+{
+    const int blockSize = 4096;
+    const int blocksPerWave = 64;
+    const int numBlocks = (numEdges + blockSize - 1) / blockSize;
+    std::vector<std::vector<Triangle>> blockTriangles(std::min(numBlocks, blocksPerWave));
+
+    for (int waveStart = 0; waveStart < numBlocks; waveStart += blocksPerWave)
+    {
+        const int waveSize = std::min(blocksPerWave, numBlocks - waveStart);
+
+#pragma omp parallel for schedule(dynamic, 1)
+        for (int b = 0; b < waveSize; ++b)
+        {
+            blockTriangles[b].clear();
+            const int begin = (waveStart + b) * blockSize;
+            const int end = std::min(numEdges, begin + blockSize);
+            for (int ei = begin; ei < end; ++ei)
+                processEdge(ei, blockTriangles[b]);
+        }
+
+        std::size_t waveTriangles = 0;
+        for (int b = 0; b < waveSize; ++b)
+            waveTriangles += blockTriangles[b].size();
+        std::vector<std::uint32_t> indices;
+        indices.reserve(3 * waveTriangles);
+        for (int b = 0; b < waveSize; ++b)
+            for (const Triangle &triangle : blockTriangles[b])
+                appendTriangleIndices(triangle, indices);
+        stream.appendTriangles(std::move(indices));
+    }
+}
+
 //! @brief Computes the dual triangles for the final mesh in the single isovertex case.
 /*!
  * Iterates over Voronoi edges, processes segments, rays, and lines to generate
- * Delaunay triangles dual to bipolar edges.
+ * Delaunay triangles dual to bipolar edges. Edges are processed in parallel;
+ * the triangle order is that of a serial pass over the edges.
  *
  * @param iso_surface Instance of IsoSurface to store triangles.
- * @param voronoi_edges Vector of Voronoi edges.
- * @param bbox Bounding box of the computational domain.
+ * @param vd Voronoi diagram containing edges and vertices; rays and lines use their cached clipped parts.
  * @param dt Delaunay triangulation structure.
- * @param grid Scalar grid containing scalar values.
  * @param isovalue The isovalue used for computing.
+ * @param stream If not null, the triangles are written to it instead of being stored.
  */
 void computeDualTriangles(
     IsoSurface &iso_surface,
     VoronoiDiagram &vd,
-    CGAL::Epick::Iso_cuboid_3 &bbox,
     Delaunay &dt,
-    UnifiedGrid &grid,
-    float isovalue)
+    float isovalue,
+    MeshStreamWriter *stream)
 {
-    std::vector<DelaunayTriangle> dualTriangles;
+    // Value-only pass; lets non-bipolar segments be skipped without touching coordinates
+    std::vector<unsigned char> above;
+    vd.vertices.classify(isovalue, above);
 
-    for (auto &edge : vd.edges)
+    std::vector<DelaunayTriangle> &dualTriangles = iso_surface.isosurfaceTrianglesSingle;
+    dualTriangles.clear();
+    auto processEdge = [&](int ei, std::vector<DelaunayTriangle> &out)
     {
-        Segment3 seg;
-        Ray3 ray;
-        Line3 line;
-
+        const VoronoiEdge &edge = vd.edges[ei];
+        CsrSpan<const Facet> dualFacets = vd.edgeFacets.row(ei);
         if (edge.type == 0)
         {
-            processSegmentEdge(edge, vd, isovalue, dt, dualTriangles);
+            if (above[edge.vertex1] == above[edge.vertex2])
+                return;
+            processSegmentEdge(edge, dualFacets, vd, isovalue, dt, out);
         }
         else if (edge.type == 1)
         {
-            CGAL::assign(ray, edge.edgeObject);
-            processRayEdge(ray, edge, vd, bbox, grid, isovalue, dt, dualTriangles);
+            processRayEdge(edge, dualFacets, vd, isovalue, dt, out);
         }
         else if (edge.type == 2)
         {
-            processLineEdge(line, edge, grid, isovalue, bbox, dt, dualTriangles);
+            processLineEdge(edge, dualFacets, vd, isovalue, dt, out);
         }
+    };
+    if (stream)
+        streamEdgeTrianglesOrdered<DelaunayTriangle>(static_cast<int>(vd.edges.size()), *stream, processEdge);
+    else
+        generateEdgeTrianglesOrdered(static_cast<int>(vd.edges.size()), dualTriangles, processEdge);
+}
+
+//! @brief Computes the dual triangles of the single-isovertex case without a Voronoi diagram.
+/*!
+ * Walks the finite Delaunay facets directly. The scalar value at each finite
+ * cell's circumcenter is computed once and cached; the dual Voronoi edge of a
+ * facet between two finite cells is then bipolar exactly when the cached
+ * values of the two cells straddle the isovalue. Facets with one infinite
+ * cell are dual to rays and are clipped to the bounding box as in
+ * processRayEdge().
+ *
+ * The result matches computeDualTriangles() on a diagram built from the same
+ * triangulation, with two approximations: circumcenters are not welded, and
+ * dual segments not longer than `collapseEps` are skipped individually
+ * instead of being collapsed transitively.
+ *
+ * @param iso_surface Instance of IsoSurface to store triangles.
+ * @param dt Delaunay triangulation structure; `dualVoronoiVertexIndex` of finite cells is overwritten.
+ * @param bbox Bounding box of the computational domain.
+ * @param grid Scalar grid containing scalar values.
+ * @param isovalue The isovalue used for computing.
+ * @param collapseEps Dual segments not longer than this produce no triangle.
+ * @param stream If not null, the triangles are written to it in batches instead of being stored.
+ */
+void computeDualTrianglesDirect(
+    IsoSurface &iso_surface,
+    Delaunay &dt,
+    CGAL::Epick::Iso_cuboid_3 &bbox,
+    const UnifiedGrid &grid,
+    float isovalue,
+    double collapseEps,
+    MeshStreamWriter *stream)
+{
+    // Number the finite cells; the number indexes the cached values and
+    // orders the two cells of a facet like Voronoi vertex indices would.
+    std::vector<Cell_handle> finiteCells;
+    finiteCells.reserve(dt.number_of_finite_cells());
+    for (Delaunay::Finite_cells_iterator cit = dt.finite_cells_begin(); cit != dt.finite_cells_end(); ++cit)
+    {
+        Cell_handle c = cit;
+        c->info().dualVoronoiVertexIndex = static_cast<int>(finiteCells.size());
+        finiteCells.push_back(c);
     }
 
-    iso_surface.isosurfaceTrianglesSingle = dualTriangles;
+    const int numCells = static_cast<int>(finiteCells.size());
+    std::vector<float> cellValues(numCells);
+#pragma omp parallel for
+    for (int i = 0; i < numCells; ++i)
+    {
+        cellValues[i] = trilinear_interpolate(dt.dual(finiteCells[i]), grid);
+    }
+
+    const double collapseEps2 = collapseEps * collapseEps;
+    std::vector<DelaunayTriangle> &dualTriangles = iso_surface.isosurfaceTrianglesSingle;
+    dualTriangles.clear();
+
+    // When streaming, full batches are handed to the writer and the vector is reused
+    const std::size_t streamBatchTriangles = std::size_t(1) << 18;
+    auto flushTriangles = [&]()
+    {
+        std::vector<std::uint32_t> indices;
+        indices.reserve(3 * dualTriangles.size());
+        for (const DelaunayTriangle &triangle : dualTriangles)
+            appendTriangleIndices(triangle, indices);
+        stream->appendTriangles(std::move(indices));
+        dualTriangles.clear();
+    };
+    for (auto fit = dt.finite_facets_begin(); fit != dt.finite_facets_end(); ++fit)
+    {
+        const Facet &facet = *fit;
+        const int iFacet = facet.second;
+        Cell_handle c1 = facet.first;
+        Cell_handle c2 = c1->neighbor(iFacet);
+        const bool infinite1 = dt.is_infinite(c1);
+        const bool infinite2 = dt.is_infinite(c2);
+
+        int iOrient;
+        if (!infinite1 && !infinite2)
+        {
+            // Dual segment; the cell with the smaller number plays vertex1
+            int idx1 = c1->info().dualVoronoiVertexIndex;
+            int idx2 = c2->info().dualVoronoiVertexIndex;
+            if (idx1 > idx2)
+                std::swap(idx1, idx2);
+            const float val1 = cellValues[idx1];
+            const float val2 = cellValues[idx2];
+            if (!is_bipolar(val1, val2, isovalue))
+                continue;
+
+            const Point p1 = dt.dual(finiteCells[idx1]);
+            const Point p2 = dt.dual(finiteCells[idx2]);
+            if (collapseEps > 0.0 && CGAL::squared_distance(p1, p2) <= collapseEps2)
+                continue; // Would have been collapsed
+            iOrient = get_orientation(iFacet, p1, p2, val1, val2);
+        }
+        else if (infinite1 != infinite2)
+        {
+            // Dual ray from the circumcenter of the finite cell
+            Ray3 ray;
+            if (!CGAL::assign(ray, dt.dual(facet)))
+                continue;
+            Point v1, v2;
+            if (!clipToBox(ray.source(), ray.to_vector(), false, bbox.min(), bbox.max(), v1, v2))
+                continue;
+
+            Cell_handle finite = infinite1 ? c2 : c1;
+            float v1_val = cellValues[finite->info().dualVoronoiVertexIndex];
+            float iPt_value = trilinear_interpolate(adjust_outside_bound_points(v2, grid, v1, v2), grid);
+            if (!is_bipolar(v1_val, iPt_value, isovalue))
+                continue;
+            iOrient = get_orientation(iFacet, v1, v2, v1_val, iPt_value);
+        }
+        else
+        {
+            continue; // Lines are not expected for finite facets
+        }
+
+        Vertex_handle p1 = c1->vertex((iFacet + 1) % 4);
+        Vertex_handle p2 = c1->vertex((iFacet + 2) % 4);
+        Vertex_handle p3 = c1->vertex((iFacet + 3) % 4);
+        generateTriangle(p1, p2, p3, iOrient, infinite1, dualTriangles);
+        if (stream && dualTriangles.size() >= streamBatchTriangles)
+            flushTriangles();
+    }
+    if (stream)
+        flushTriangles();
 }
 
 static inline int selectIsovertexFromCellEdge(
@@ -259,32 +469,33 @@ static inline int selectIsovertexFromCellEdge(
     int cellIndex, int globalEdgeIndex)
 {
     // Lookup the VoronoiCellEdge
-    auto it = voronoiDiagram.cellEdgeLookup.find(std::make_pair(cellIndex, globalEdgeIndex));
-    if (it == voronoiDiagram.cellEdgeLookup.end())
+    int ceIdx = voronoiDiagram.findCellEdge(cellIndex, globalEdgeIndex);
+    if (ceIdx < 0)
     {
         // No such cell-edge found, pass
+#pragma omp critical(vdc_log)
         std::cout << "didn't find cell-edge for edge " << globalEdgeIndex << std::endl;
         return -1;
     }
-    int ceIdx = it->second;
     int starting = ceIdx;
-    VoronoiCellEdge cellEdge = voronoiDiagram.cellEdges[ceIdx];
+    if (voronoiDiagram.cellEdgeCycles.rows() != voronoiDiagram.cellEdges.size())
+        return -1; // Cycles have not been computed
 
-    while (cellEdge.cycleIndices.empty())
+    while (voronoiDiagram.cellEdgeCycles.rowSize(ceIdx) == 0)
     {
-        if (cellEdge.nextCellEdge == starting)
+        if (voronoiDiagram.cellEdges[ceIdx].nextCellEdge == starting)
         {
             return -1;
         }
         else
         {
-            cellEdge = voronoiDiagram.cellEdges[cellEdge.nextCellEdge];
+            ceIdx = voronoiDiagram.cellEdges[ceIdx].nextCellEdge;
         }
     }
 
     const VoronoiCell &vc = voronoiDiagram.cells[cellIndex];
     // The final isosurface vertex index in iso_surface.isosurfaceVertices:
-    int isoVtxIndex = vc.isoVertexStartIndex + cellEdge.cycleIndices[0];
+    int isoVtxIndex = vc.isoVertexStartIndex + voronoiDiagram.cellEdgeCycles.row(ceIdx).front();
     return isoVtxIndex;
 }
 
@@ -293,7 +504,7 @@ static inline int selectIsovertexFromCellEdge(
  * Adds a triangle to the isosurface's triangle list, adjusting vertex order based
  * on orientation, and logs problematic triangles if invalid.
  *
- * @param iso_surface The isosurface to store the triangle.
+ * @param triangles Vector to store the triangle.
  * @param idx1 First vertex index.
  * @param idx2 Second vertex index.
  * @param idx3 Third vertex index.
@@ -301,7 +512,7 @@ static inline int selectIsovertexFromCellEdge(
  * @param isValid Flag indicating if the triangle is valid.
  */
 static void generateTriangleMulti(
-    IsoSurface &iso_surface,
+    std::vector<std::tuple<int, int, int>> &triangles,
     int idx1, int idx2, int idx3,
     int iOrient,
     bool isValid)
@@ -310,19 +521,20 @@ static void generateTriangleMulti(
     {
         if (iOrient < 0)
         {
-            iso_surface.isosurfaceTrianglesMulti.emplace_back(idx1, idx2, idx3);
+            triangles.emplace_back(idx1, idx2, idx3);
         }
         else
         {
-            iso_surface.isosurfaceTrianglesMulti.emplace_back(idx1, idx3, idx2);
+            triangles.emplace_back(idx1, idx3, idx2);
         }
     }
     else
     {
-        std::cout << "Problematic triangle" << std::endl;
-        std::cout << "Vertex 1: " << idx1 << std::endl;
-        std::cout << "Vertex 2: " << idx2 << std::endl;
-        std::cout << "Vertex 3: " << idx3 << std::endl;
+#pragma omp critical(vdc_log)
+        std::cout << "Problematic triangle\n"
+                  << "Vertex 1: " << idx1 << "\n"
+                  << "Vertex 2: " << idx2 << "\n"
+                  << "Vertex 3: " << idx3 << std::endl;
     }
 }
 
@@ -380,82 +592,74 @@ static bool selectIsovertices(
  * Checks if the segment is bipolar, retrieves the global edge index, and generates
  * triangles for associated Delaunay facets.
  *
- * @param seg The segment edge to process.
- * @param edge The CGAL object representing the edge.
+ * @param edge The Voronoi segment edge to process.
+ * @param dualFacets The Delaunay facets dual to the edge.
  * @param voronoiDiagram The Voronoi diagram containing edge and cell data.
  * @param isovalue The isovalue for bipolarity check.
- * @param iso_surface The isosurface to store triangles.
+ * @param triangles Vector to store generated triangles.
  */
 static void processSegmentEdgeMulti(
-    VoronoiEdge edge,
-    VoronoiDiagram &voronoiDiagram,
+    const VoronoiEdge &edge,
+    CsrSpan<const Facet> dualFacets,
+    const VoronoiDiagram &voronoiDiagram,
     float isovalue,
-    IsoSurface &iso_surface)
+    std::vector<std::tuple<int, int, int>> &triangles)
 {
 
     int idx_v1 = edge.vertex1;
     int idx_v2 = edge.vertex2;
-    Point v1 = voronoiDiagram.vertices[idx_v1].coord;
-    Point v2 = voronoiDiagram.vertices[idx_v2].coord;
-    float val1 = voronoiDiagram.vertices[idx_v1].value;
-    float val2 = voronoiDiagram.vertices[idx_v2].value;
+    const Point &v1 = voronoiDiagram.vertices.coords[idx_v1];
+    const Point &v2 = voronoiDiagram.vertices.coords[idx_v2];
+    float val1 = voronoiDiagram.vertices.values[idx_v1];
+    float val2 = voronoiDiagram.vertices.values[idx_v2];
 
     if (is_bipolar(val1, val2, isovalue))
     {
         if (idx_v1 > idx_v2)
             std::swap(idx_v1, idx_v2);
-        auto itEdge = voronoiDiagram.segmentVertexPairToEdgeIndex.find(std::make_pair(idx_v1, idx_v2));
-        if (itEdge == voronoiDiagram.segmentVertexPairToEdgeIndex.end())
+        int globalEdgeIndex = voronoiDiagram.segmentVertexPairToEdgeIndex.find(idx_v1, idx_v2);
+        if (globalEdgeIndex < 0)
             return;
 
-        int globalEdgeIndex = itEdge->second;
-
-        for (const auto &facet : edge.delaunayFacets)
+        for (const auto &facet : dualFacets)
         {
             int idx1, idx2, idx3, cellIndex1, cellIndex2, cellIndex3;
             bool isValid = selectIsovertices(voronoiDiagram, facet, globalEdgeIndex, idx1, idx2, idx3, cellIndex1, cellIndex2, cellIndex3);
             int iOrient = get_orientation(facet.second, v1, v2, val1, val2);
-            generateTriangleMulti(iso_surface, idx1, idx2, idx3, iOrient, isValid);
+            generateTriangleMulti(triangles, idx1, idx2, idx3, iOrient, isValid);
         }
     }
 }
 
 //! @brief Processes a ray edge for multi-isovertex triangle computation.
 /*!
- * Intersects the ray with the bounding box, checks bipolarity, and generates
+ * Uses the cached clipped part of the ray, checks bipolarity, and generates
  * triangles using the first isovertex from each cell.
  *
- * @param ray The ray edge to process.
- * @param edge The CGAL object representing the edge.
+ * @param edge The Voronoi ray edge to process.
+ * @param dualFacets The Delaunay facets dual to the edge.
  * @param voronoiDiagram The Voronoi diagram containing edge and cell data.
- * @param grid The scalar grid for interpolation.
  * @param isovalue The isovalue for bipolarity check.
- * @param bbox The bounding box for intersection.
- * @param iso_surface The isosurface to store triangles.
+ * @param triangles Vector to store generated triangles.
  */
 static void processRayEdgeMulti(
-    const Ray3 &ray,
-    std::vector<Facet> dualDelaunayFacets,
-    VoronoiDiagram &voronoiDiagram,
-    UnifiedGrid &grid,
+    const VoronoiEdge &edge,
+    CsrSpan<const Facet> dualFacets,
+    const VoronoiDiagram &voronoiDiagram,
     float isovalue,
-    CGAL::Epick::Iso_cuboid_3 &bbox,
-    IsoSurface &iso_surface)
+    std::vector<std::tuple<int, int, int>> &triangles)
 {
-    CGAL::Object intersectObj = CGAL::intersection(bbox, ray);
-    Segment3 iseg;
-    if (CGAL::assign(iseg, intersectObj))
+    if (const ClippedEdge *clip = voronoiDiagram.clippedEdge(edge))
     {
-        Point v1 = ray.source();
-        Point v2 = iseg.target();
-        int idx_v1 = find_vertex_index(voronoiDiagram, v1);
-        float val1 = voronoiDiagram.vertices[idx_v1].value;
-        float val2 = trilinear_interpolate(v2, grid);
+        const Point &v1 = voronoiDiagram.vertices.coords[edge.vertex1];
+        const Point &v2 = clip->target;
+        float val1 = clip->sourceValue;
+        float val2 = clip->targetValue;
 
         if (is_bipolar(val1, val2, isovalue))
         {
 
-            for (const auto &facet : dualDelaunayFacets)
+            for (const auto &facet : dualFacets)
             {
                 int iFacet = facet.second;
                 Cell_handle c = facet.first;
@@ -473,10 +677,12 @@ static void processRayEdgeMulti(
                 int cellIndex1 = delaunay_vertex1->info().voronoiCellIndex;
                 int cellIndex2 = delaunay_vertex2->info().voronoiCellIndex;
                 int cellIndex3 = delaunay_vertex3->info().voronoiCellIndex;
+                if (cellIndex1 < 0 || cellIndex2 < 0 || cellIndex3 < 0)
+                    continue; // Cell was dropped or not built
 
-                VoronoiCell &vc1 = voronoiDiagram.cells[cellIndex1];
-                VoronoiCell &vc2 = voronoiDiagram.cells[cellIndex2];
-                VoronoiCell &vc3 = voronoiDiagram.cells[cellIndex3];
+                const VoronoiCell &vc1 = voronoiDiagram.cells[cellIndex1];
+                const VoronoiCell &vc2 = voronoiDiagram.cells[cellIndex2];
+                const VoronoiCell &vc3 = voronoiDiagram.cells[cellIndex3];
 
                 int idx1 = vc1.isoVertexStartIndex;
                 int idx2 = vc2.isoVertexStartIndex;
@@ -484,7 +690,7 @@ static void processRayEdgeMulti(
 
                 int iOrient = get_orientation(iFacet, v1, v2, val1, val2);
                 bool isValid = (idx1 != idx2 && idx2 != idx3 && idx1 != idx3);
-                generateTriangleMulti(iso_surface, idx1, idx2, idx3, iOrient, isValid);
+                generateTriangleMulti(triangles, idx1, idx2, idx3, iOrient, isValid);
             }
         }
     }
@@ -492,39 +698,33 @@ static void processRayEdgeMulti(
 
 //! @brief Processes a line edge for multi-isovertex triangle computation.
 /*!
- * Intersects the line with the bounding box, checks bipolarity, and generates
+ * Uses the cached clipped part of the line, checks bipolarity, and generates
  * triangles using the first isovertex from each cell.
  *
- * @param line The line edge to process.
- * @param edge The CGAL object representing the edge.
+ * @param edge The Voronoi line edge to process.
+ * @param dualFacets The Delaunay facets dual to the edge.
  * @param voronoiDiagram The Voronoi diagram containing edge and cell data.
- * @param grid The scalar grid for interpolation.
  * @param isovalue The isovalue for bipolarity check.
- * @param bbox The bounding box for intersection.
- * @param iso_surface The isosurface to store triangles.
+ * @param triangles Vector to store generated triangles.
  */
 static void processLineEdgeMulti(
-    const Line3 &line,
-    std::vector<Facet> dualDelaunayFacets,
-    VoronoiDiagram &voronoiDiagram,
-    UnifiedGrid &grid,
+    const VoronoiEdge &edge,
+    CsrSpan<const Facet> dualFacets,
+    const VoronoiDiagram &voronoiDiagram,
     float isovalue,
-    CGAL::Epick::Iso_cuboid_3 &bbox,
-    IsoSurface &iso_surface)
+    std::vector<std::tuple<int, int, int>> &triangles)
 {
-    CGAL::Object intersectObj = CGAL::intersection(bbox, line);
-    Segment3 iseg;
-    if (CGAL::assign(iseg, intersectObj))
+    if (const ClippedEdge *clip = voronoiDiagram.clippedEdge(edge))
     {
-        Point v1 = iseg.source();
-        Point v2 = iseg.target();
-        float val1 = trilinear_interpolate(v1, grid);
-        float val2 = trilinear_interpolate(v2, grid);
+        const Point &v1 = clip->source;
+        const Point &v2 = clip->target;
+        float val1 = clip->sourceValue;
+        float val2 = clip->targetValue;
 
         if (is_bipolar(val1, val2, isovalue))
         {
 
-            for (const auto &facet : dualDelaunayFacets)
+            for (const auto &facet : dualFacets)
             {
                 int iFacet = facet.second;
                 Cell_handle c = facet.first;
@@ -542,10 +742,12 @@ static void processLineEdgeMulti(
                 int cellIndex1 = delaunay_vertex1->info().voronoiCellIndex;
                 int cellIndex2 = delaunay_vertex2->info().voronoiCellIndex;
                 int cellIndex3 = delaunay_vertex3->info().voronoiCellIndex;
+                if (cellIndex1 < 0 || cellIndex2 < 0 || cellIndex3 < 0)
+                    continue; // Cell was dropped or not built
 
-                VoronoiCell &vc1 = voronoiDiagram.cells[cellIndex1];
-                VoronoiCell &vc2 = voronoiDiagram.cells[cellIndex2];
-                VoronoiCell &vc3 = voronoiDiagram.cells[cellIndex3];
+                const VoronoiCell &vc1 = voronoiDiagram.cells[cellIndex1];
+                const VoronoiCell &vc2 = voronoiDiagram.cells[cellIndex2];
+                const VoronoiCell &vc3 = voronoiDiagram.cells[cellIndex3];
 
                 int idx1 = vc1.isoVertexStartIndex;
                 int idx2 = vc2.isoVertexStartIndex;
@@ -553,7 +755,7 @@ static void processLineEdgeMulti(
 
                 int iOrient = get_orientation(iFacet, v1, v2, val1, val2);
                 bool isValid = (idx1 != idx2 && idx2 != idx3 && idx1 != idx3);
-                generateTriangleMulti(iso_surface, idx1, idx2, idx3, iOrient, isValid);
+                generateTriangleMulti(triangles, idx1, idx2, idx3, iOrient, isValid);
             }
         }
     }
@@ -562,47 +764,53 @@ static void processLineEdgeMulti(
 //! @brief Computes the dual triangles for the final mesh in the multi-isovertex case.
 /*!
  * Iterates over Voronoi edges, processes segments, rays, and lines to generate
- * Delaunay triangles dual to bipolar edges for multiple isovalues.
+ * Delaunay triangles dual to bipolar edges for multiple isovalues. Edges are
+ * processed in parallel; the triangles are appended in the order of a serial
+ * pass over the edges.
  *
- * @param voronoiDiagram The Voronoi diagram to compute from.
- * @param bbox Bounding box of the computational domain.
- * @param grid Scalar grid containing scalar values.
+ * @param voronoiDiagram The Voronoi diagram to compute from; rays and lines use their cached clipped parts.
  * @param isovalue The isovalue for mesh computation.
  * @param iso_surface Instance of IsoSurface containing the isosurface vertices and faces.
+ * @param stream If not null, the triangles are written to it instead of being stored.
  */
 void computeDualTrianglesMulti(
     VoronoiDiagram &voronoiDiagram,
-    CGAL::Epick::Iso_cuboid_3 &bbox,
-    UnifiedGrid &grid,
     float isovalue,
-    IsoSurface &iso_surface)
+    IsoSurface &iso_surface,
+    MeshStreamWriter *stream)
 {
-    for (const auto &edge : voronoiDiagram.edges)
-    {
-        Segment3 seg;
-        Ray3 ray;
-        Line3 line;
-        std::vector<Facet> dualDelaunayFacets = edge.delaunayFacets;
+    // Value-only pass; lets non-bipolar segments be skipped without touching coordinates
+    std::vector<unsigned char> above;
+    voronoiDiagram.vertices.classify(isovalue, above);
 
+    auto processEdge = [&](int ei, std::vector<std::tuple<int, int, int>> &out)
+    {
+        const VoronoiEdge &edge = voronoiDiagram.edges[ei];
+        CsrSpan<const Facet> dualFacets = voronoiDiagram.edgeFacets.row(ei);
         if (edge.type == 0)
         {
-            processSegmentEdgeMulti(edge, voronoiDiagram, isovalue, iso_surface);
+            if (above[edge.vertex1] == above[edge.vertex2])
+                return;
+            processSegmentEdgeMulti(edge, dualFacets, voronoiDiagram, isovalue, out);
         }
         else if (edge.type == 1)
         {
-            CGAL::assign(ray, edge.edgeObject);
-            processRayEdgeMulti(ray, dualDelaunayFacets, voronoiDiagram, grid, isovalue, bbox, iso_surface);
+            processRayEdgeMulti(edge, dualFacets, voronoiDiagram, isovalue, out);
         }
         else if (edge.type == 2)
         {
-            CGAL::assign(line, edge.edgeObject);
-            processLineEdgeMulti(line, dualDelaunayFacets, voronoiDiagram, grid, isovalue, bbox, iso_surface);
+            processLineEdgeMulti(edge, dualFacets, voronoiDiagram, isovalue, out);
         }
-    }
+    };
+    const int numEdges = static_cast<int>(voronoiDiagram.edges.size());
+    if (stream)
+        streamEdgeTrianglesOrdered<std::tuple<int, int, int>>(numEdges, *stream, processEdge);
+    else
+        generateEdgeTrianglesOrdered(numEdges, iso_surface.isosurfaceTrianglesMulti, processEdge);
 }
 
 //! @brief Computes isosurface vertices for the single-isovertex case.
-void Compute_Isosurface_Vertices_Single(UnifiedGrid &grid, float isovalue, IsoSurface &iso_surface, std::vector<Point> &activeCubeCenters)
+void Compute_Isosurface_Vertices_Single(const UnifiedGrid &grid, float isovalue, IsoSurface &iso_surface, std::vector<Point> &activeCubeCenters)
 {
     const int cubeVertices[8][3] = {
         {0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0}, {0, 0, 1}, {1, 0, 1}, {1, 1, 1}, {0, 1, 1}};
@@ -665,100 +873,90 @@ void Compute_Isosurface_Vertices_Single(UnifiedGrid &grid, float isovalue, IsoSu
  * @param vc The Voronoi cell to process.
  * @param voronoiDiagram The Voronoi diagram containing facet and vertex data.
  * @param isovalue The isovalue for bipolarity check.
- * @param midpoints Vector to store computed midpoints.
- * @param edge_to_midpoint_index Map linking edge keys to midpoint indices.
- * @param facet_midpoint_indices Vector storing midpoint indices for each facet.
+ * @param scratch Cleared scratch; receives the midpoints and one row of midpoint indices per facet.
  */
 static void collectMidpoints(
-    VoronoiCell &vc,
-    VoronoiDiagram &voronoiDiagram,
+    const VoronoiCell &vc,
+    const VoronoiDiagram &voronoiDiagram,
     float isovalue,
-    std::vector<MidpointNode> &midpoints,
-    std::map<std::pair<int, int>, int> &edge_to_midpoint_index,
-    std::vector<std::vector<int>> &facet_midpoint_indices)
+    CycleScratch &scratch)
 {
-    for (size_t i = 0; i < vc.facet_indices.size(); ++i)
-    {
-        int facet_index = vc.facet_indices[i];
-        VoronoiCellFacet &facet = voronoiDiagram.facets[facet_index];
-        size_t num_vertices = facet.vertices_indices.size();
+    std::vector<MidpointNode> &midpoints = scratch.midpoints;
+    CsrArray<int> &facet_midpoint_indices = scratch.facetMidpoints;
 
-        std::vector<int> current_facet_midpoints;
+    // The stored vertex order is used regardless of the reference orientation;
+    // reversing a facet does not change which bipolar midpoints get paired.
+    for (const auto &ref : voronoiDiagram.cellFacets.row(vc.cellIndex))
+    {
+        int facet_index = ref.facet_index;
+        CsrSpan<const int> facet = voronoiDiagram.facetVertices.row(facet_index);
+        size_t num_vertices = facet.size();
 
         for (size_t j = 0; j < num_vertices; ++j)
         {
             size_t idx1 = j;
             size_t idx2 = (j + 1) % num_vertices;
 
-            float val1 = voronoiDiagram.vertices[facet.vertices_indices[idx1]].value;
-            float val2 = voronoiDiagram.vertices[facet.vertices_indices[idx2]].value;
+            float val1 = voronoiDiagram.vertices.values[facet[idx1]];
+            float val2 = voronoiDiagram.vertices.values[facet[idx2]];
 
             if (is_bipolar(val1, val2, isovalue))
             {
-                int vertex_index1 = facet.vertices_indices[idx1];
-                int vertex_index2 = facet.vertices_indices[idx2];
-
-                Point p1 = voronoiDiagram.vertices[vertex_index1].coord;
-                Point p2 = voronoiDiagram.vertices[vertex_index2].coord;
-
-                double t = (isovalue - val1) / (val2 - val1);
-                Point midpoint = p1 + (p2 - p1) * t;
-
-                auto edge_key = std::make_pair(std::min(vertex_index1, vertex_index2),
-                                               std::max(vertex_index1, vertex_index2));
+                int vertex_index1 = facet[idx1];
+                int vertex_index2 = facet[idx2];
 
-                if (edge_to_midpoint_index.find(edge_key) == edge_to_midpoint_index.end())
+                int midpoint_index = scratch.edgeToMidpoint.find(vertex_index1, vertex_index2);
+                if (midpoint_index < 0)
                 {
-                    int globalEdgeIndex = -1;
-                    auto iter_glob = voronoiDiagram.segmentVertexPairToEdgeIndex.find(edge_key);
-                    if (iter_glob != voronoiDiagram.segmentVertexPairToEdgeIndex.end())
-                    {
-                        globalEdgeIndex = iter_glob->second;
-                    }
+                    const Point &p1 = voronoiDiagram.vertices.coords[vertex_index1];
+                    const Point &p2 = voronoiDiagram.vertices.coords[vertex_index2];
+                    double t = (isovalue - val1) / (val2 - val1);
 
                     MidpointNode node;
-                    node.point = midpoint;
+                    node.point = p1 + (p2 - p1) * t;
+                    node.num_connected = 0;
                     node.facet_index = facet_index;
                     node.cycle_index = -1;
-                    node.global_edge_index = globalEdgeIndex;
+                    node.global_edge_index = voronoiDiagram.segmentVertexPairToEdgeIndex.find(vertex_index1, vertex_index2);
 
                     midpoints.push_back(node);
-                    int midpoint_index = midpoints.size() - 1;
-                    edge_to_midpoint_index[edge_key] = midpoint_index;
-                    current_facet_midpoints.push_back(midpoint_index);
-                }
-                else
-                {
-                    int midpoint_index = edge_to_midpoint_index[edge_key];
-                    current_facet_midpoints.push_back(midpoint_index);
+                    midpoint_index = midpoints.size() - 1;
+                    scratch.edgeToMidpoint.set(vertex_index1, vertex_index2, midpoint_index);
                 }
+                facet_midpoint_indices.data.push_back(midpoint_index);
             }
         }
 
-        facet_midpoint_indices.push_back(current_facet_midpoints);
+        // Close the row of this facet
+        facet_midpoint_indices.offsets.push_back(static_cast<int>(facet_midpoint_indices.data.size()));
     }
 }
 
 //! @brief Connects midpoints within each facet to form a graph.
 /*!
  * Links pairs of midpoints in each facet to establish connectivity for cycle detection.
+ * Links that do not fit a midpoint's adjacency array are counted in
+ * CycleScratch::droppedConnections.
  *
- * @param facet_midpoint_indices Vector storing midpoint indices for each facet.
- * @param midpoints Vector of midpoints to update with connectivity.
+ * @param scratch Scratch holding the midpoints and their facet rows.
  */
-static void connectMidpoints(
-    const std::vector<std::vector<int>> &facet_midpoint_indices,
-    std::vector<MidpointNode> &midpoints)
+static void connectMidpoints(CycleScratch &scratch)
 {
-    for (const auto &facet_midpoints : facet_midpoint_indices)
+    const CsrArray<int> &facet_midpoint_indices = scratch.facetMidpoints;
+    std::vector<MidpointNode> &midpoints = scratch.midpoints;
+
+    for (int f = 0; f < static_cast<int>(facet_midpoint_indices.rows()); ++f)
     {
+        CsrSpan<const int> facet_midpoints = facet_midpoint_indices.row(f);
         size_t num_midpoints = facet_midpoints.size();
         for (size_t k = 0; k + 1 < num_midpoints; k += 2)
         {
             int idx1 = facet_midpoints[k];
             int idx2 = facet_midpoints[k + 1];
-            midpoints[idx1].connected_to.push_back(idx2);
-            midpoints[idx2].connected_to.push_back(idx1);
+            if (!midpoints[idx1].connect(idx2))
+                ++scratch.droppedConnections;
+            if (!midpoints[idx2].connect(idx1))
+                ++scratch.droppedConnections;
         }
     }
 }
@@ -766,123 +964,152 @@ static void connectMidpoints(
 //! @brief Extracts cycles from the midpoint connectivity graph.
 /*!
  * Uses depth-first search to identify closed cycles in the midpoint graph.
+ * A midpoint's cycle_index doubles as its visited mark.
  *
- * @param midpoints Vector of midpoints with connectivity information.
- * @param cycles Vector to store the extracted cycles as lists of midpoint indices.
+ * @param scratch Scratch holding the connected midpoints; receives one row of
+ *                CycleScratch::cycles per cycle, as lists of midpoint indices.
  */
-static void extractCycles(
-    const std::vector<MidpointNode> &midpoints,
-    std::vector<std::vector<int>> &cycles)
+static void extractCycles(CycleScratch &scratch)
 {
-    std::set<int> visited;
+    std::vector<MidpointNode> &midpoints = scratch.midpoints;
+    std::vector<int> &stack = scratch.stack;
+    CsrArray<int> &cycles = scratch.cycles;
 
     for (size_t i = 0; i < midpoints.size(); ++i)
     {
-        if (visited.find(i) == visited.end())
+        if (midpoints[i].cycle_index >= 0)
+            continue;
+
+        const int cycle_index = static_cast<int>(cycles.rows());
+        stack.push_back(static_cast<int>(i));
+
+        while (!stack.empty())
         {
-            std::vector<int> cycle;
-            std::stack<int> stack;
-            stack.push(i);
+            int current = stack.back();
+            stack.pop_back();
 
-            while (!stack.empty())
+            MidpointNode &node = midpoints[current];
+            if (node.cycle_index >= 0)
             {
-                int current = stack.top();
-                stack.pop();
-
-                if (visited.find(current) != visited.end())
-                {
-                    continue;
-                }
+                continue;
+            }
 
-                visited.insert(current);
-                cycle.push_back(current);
+            node.cycle_index = cycle_index;
+            cycles.data.push_back(current);
 
-                for (int neighbor : midpoints[current].connected_to)
+            for (int k = 0; k < node.num_connected; ++k)
+            {
+                int neighbor = node.connected_to[k];
+                if (midpoints[neighbor].cycle_index < 0)
                 {
-                    if (visited.find(neighbor) == visited.end())
-                    {
-                        stack.push(neighbor);
-                    }
+                    stack.push_back(neighbor);
                 }
             }
-
-            if (!cycle.empty())
-            {
-                cycles.push_back(cycle);
-            }
         }
+
+        cycles.offsets.push_back(static_cast<int>(cycles.data.size()));
     }
 }
 
-//! @brief Computes centroids for cycles and updates the isosurface.
+//! @brief Builds the midpoint graph of a cell and extracts its cycles.
 /*!
- * Calculates the centroid for each cycle, updates the Voronoi cell's cycles,
- * and adds the centroid to the isosurface vertices.
+ * Also lists, in CycleScratch::cellEdgeCycles, the (cell edge, cycle) pairs
+ * of the cell sorted and without duplicates.
  *
- * @param vc The Voronoi cell to update.
- * @param voronoiDiagram The Voronoi diagram for edge lookup.
- * @param midpoints Vector of midpoints used for centroid computation.
- * @param cycles Vector of cycles as lists of midpoint indices.
- * @param iso_surface The isosurface to store vertices.
+ * @param vc The Voronoi cell to process.
+ * @param voronoiDiagram The Voronoi diagram containing facet, vertex and cell edge data.
+ * @param isovalue The isovalue for bipolarity check.
+ * @param scratch Scratch of the calling thread; cleared first.
+ */
+static void extractCellCycles(
+    const VoronoiCell &vc,
+    const VoronoiDiagram &voronoiDiagram,
+    float isovalue,
+    CycleScratch &scratch)
+{
+    scratch.clear();
+
+    collectMidpoints(vc, voronoiDiagram, isovalue, scratch);
+    connectMidpoints(scratch);
+
+    extractCycles(scratch);
+
+    for (const MidpointNode &node : scratch.midpoints)
+    {
+        if (node.global_edge_index < 0)
+            continue;
+        int cEdgeIdx = voronoiDiagram.findCellEdge(vc.cellIndex, node.global_edge_index);
+        if (cEdgeIdx >= 0)
+            scratch.cellEdgeCycles.emplace_back(cEdgeIdx, node.cycle_index);
+    }
+    std::sort(scratch.cellEdgeCycles.begin(), scratch.cellEdgeCycles.end());
+    scratch.cellEdgeCycles.erase(std::unique(scratch.cellEdgeCycles.begin(), scratch.cellEdgeCycles.end()), scratch.cellEdgeCycles.end());
+}
+
+//! @brief Computes centroids for cycles and stores them in their preassigned slots.
+/*!
+ * Calculates the centroid (arithmetic mean of the midpoints) of each cycle of
+ * the cell and writes it, as isovertex and as VoronoiDiagram::cycles entry,
+ * at vc.isoVertexStartIndex onwards. The midpoint rows of the cycles are
+ * written to VoronoiDiagram::cycleMidpoints starting at `midpointStart`.
+ * Cells write disjoint slots, so cells can be processed concurrently.
+ *
+ * @param vc The Voronoi cell, with its isovertex range already assigned.
+ * @param voronoiDiagram The Voronoi diagram holding the sized cycle arrays.
+ * @param scratch Scratch holding the midpoints and the extracted cycles of the cell.
+ * @param midpointStart Position of the cell's first midpoint in cycleMidpoints.
+ * @param iso_surface The isosurface, with its vertex array already sized.
  */
 static void computeCycleCentroids(
-    VoronoiCell &vc,
+    const VoronoiCell &vc,
     VoronoiDiagram &voronoiDiagram,
-    std::vector<MidpointNode> &midpoints,
-    const std::vector<std::vector<int>> &cycles,
+    const CycleScratch &scratch,
+    int midpointStart,
     IsoSurface &iso_surface)
 {
-    vc.isoVertexStartIndex = iso_surface.isosurfaceVertices.size();
-    vc.numIsoVertices = cycles.size();
+    const std::vector<MidpointNode> &midpoints = scratch.midpoints;
+    CsrArray<int> &cycleMidpoints = voronoiDiagram.cycleMidpoints;
 
-    int cycIdx = 0;
-    for (const auto &single_cycle : cycles)
+    for (int cycIdx = 0; cycIdx < vc.numIsoVertices; ++cycIdx)
     {
-        Cycle cycle;
-        cycle.voronoi_cell_index = vc.cellIndex;
-        cycle.midpoint_indices = single_cycle;
-
-        for (size_t i = 0; i < single_cycle.size(); ++i)
-        {
-            int idx1 = single_cycle[i];
-            int idx2 = single_cycle[(i + 1) % single_cycle.size()];
-            cycle.edges.emplace_back(idx1, idx2);
-        }
-
-        cycle.compute_centroid(midpoints);
+        CsrSpan<const int> single_cycle = scratch.cycles.row(cycIdx);
+        const int slot = vc.isoVertexStartIndex + cycIdx;
 
+        double sumX = 0, sumY = 0, sumZ = 0;
         for (int ptIdx : single_cycle)
         {
-            midpoints[ptIdx].cycle_index = cycIdx;
-
-            int globalEdgeIdx = midpoints[ptIdx].global_edge_index;
-            if (globalEdgeIdx >= 0)
-            {
-                std::pair<int, int> key = std::make_pair(vc.cellIndex, globalEdgeIdx);
-                auto iter_cEdge = voronoiDiagram.cellEdgeLookup.find(key);
-                if (iter_cEdge != voronoiDiagram.cellEdgeLookup.end())
-                {
-                    int cEdgeIdx = iter_cEdge->second;
-                    auto &cyclesVec = voronoiDiagram.cellEdges[cEdgeIdx].cycleIndices;
-
-                    if (std::find(cyclesVec.begin(), cyclesVec.end(), cycIdx) == cyclesVec.end())
-                    {
-                        cyclesVec.push_back(cycIdx);
-                    }
-                }
-            }
+            const Point &p = midpoints[ptIdx].point;
+            sumX += p.x();
+            sumY += p.y();
+            sumZ += p.z();
         }
+        const double n = static_cast<double>(single_cycle.size());
 
-        vc.cycles.push_back(cycle);
-        iso_surface.isosurfaceVertices.push_back(cycle.isovertex);
-        cycIdx++;
+        Cycle &cycle = voronoiDiagram.cycles[slot];
+        cycle.isovertex = Point(sumX / n, sumY / n, sumZ / n);
+        cycle.voronoi_cell_index = vc.cellIndex;
+        iso_surface.isosurfaceVertices[slot] = cycle.isovertex;
+
+        cycleMidpoints.offsets[slot + 1] = midpointStart + scratch.cycles.offsets[cycIdx + 1];
+        std::copy(single_cycle.begin(), single_cycle.end(),
+                  cycleMidpoints.data.begin() + midpointStart + scratch.cycles.offsets[cycIdx]);
     }
 }
 
 //! @brief Computes isosurface vertices for the multi-isovertex case.
 /*!
  * Processes each Voronoi cell to identify bipolar edges, form cycles, and compute
- * centroids as isosurface vertices.
+ * centroids as isosurface vertices. Replaces the isosurface vertices and the
+ * cycles of the diagram.
+ *
+ * Cells are processed in parallel in two passes. The first counts the cycles
+ * and midpoints of every cell and the cycles crossing every cell edge; an
+ * exclusive prefix sum over the counts gives each cell its isoVertexStartIndex
+ * and its range of cycleMidpoints. The second pass extracts the cycles again
+ * and writes them into those slots, so the output is identical to processing
+ * the cells in order. Each thread works in its own CycleScratch, which keeps
+ * its buffers across cells and calls; in steady state a cell costs no heap
+ * allocation.
  *
  * @param voronoiDiagram The Voronoi diagram to compute vertices for.
  * @param isovalue The isovalue to use for vertex computation.
@@ -890,19 +1117,70 @@ static void computeCycleCentroids(
  */
 void Compute_Isosurface_Vertices_Multi(VoronoiDiagram &voronoiDiagram, float isovalue, IsoSurface &iso_surface)
 {
-    for (auto &vc : voronoiDiagram.cells)
+    const int numCells = static_cast<int>(voronoiDiagram.cells.size());
+    std::vector<int> cellMidpointStart(numCells + 1, 0);
+    CsrArray<int> &cellEdgeCycles = voronoiDiagram.cellEdgeCycles;
+    cellEdgeCycles.startCounts(voronoiDiagram.cellEdges.size());
+    int droppedConnections = 0;
+
+#pragma omp parallel reduction(+ : droppedConnections)
     {
-        std::vector<MidpointNode> midpoints;
-        std::map<std::pair<int, int>, int> edge_to_midpoint_index;
-        std::vector<std::vector<int>> facet_midpoint_indices;
+        static thread_local CycleScratch scratch;
+        scratch.droppedConnections = 0;
 
-        collectMidpoints(vc, voronoiDiagram, isovalue, midpoints, edge_to_midpoint_index, facet_midpoint_indices);
-        connectMidpoints(facet_midpoint_indices, midpoints);
+        // Pass 1: cycles and midpoints per cell, cycles per cell edge.
+        // A cell edge belongs to one cell, so counts of different cells never collide.
+#pragma omp for schedule(dynamic, 64)
+        for (int ci = 0; ci < numCells; ++ci)
+        {
+            VoronoiCell &vc = voronoiDiagram.cells[ci];
+            extractCellCycles(vc, voronoiDiagram, isovalue, scratch);
+            vc.numIsoVertices = static_cast<int>(scratch.cycles.rows());
+            cellMidpointStart[ci + 1] = static_cast<int>(scratch.cycles.entries());
+            for (const auto &pr : scratch.cellEdgeCycles)
+                cellEdgeCycles.count(pr.first);
+        }
+        droppedConnections += scratch.droppedConnections;
+
+#pragma omp single
+        {
+            // Exclusive prefix sums place every cell's cycles and midpoints
+            int numCycles = 0;
+            for (int ci = 0; ci < numCells; ++ci)
+            {
+                voronoiDiagram.cells[ci].isoVertexStartIndex = numCycles;
+                numCycles += voronoiDiagram.cells[ci].numIsoVertices;
+                cellMidpointStart[ci + 1] += cellMidpointStart[ci];
+            }
 
-        std::vector<std::vector<int>> cycles;
-        extractCycles(midpoints, cycles);
+            iso_surface.isosurfaceVertices.resize(numCycles);
+            voronoiDiagram.cycles.resize(numCycles);
+            voronoiDiagram.cycleMidpoints.offsets.assign(numCycles + 1, 0);
+            voronoiDiagram.cycleMidpoints.data.resize(cellMidpointStart[numCells]);
+            cellEdgeCycles.allocate();
+        }
 
-        computeCycleCentroids(vc, voronoiDiagram, midpoints, cycles, iso_surface);
+        // Pass 2: each thread writes only the slots of its own cells
+#pragma omp for schedule(dynamic, 64)
+        for (int ci = 0; ci < numCells; ++ci)
+        {
+            const VoronoiCell &vc = voronoiDiagram.cells[ci];
+            if (vc.numIsoVertices == 0)
+                continue;
+            extractCellCycles(vc, voronoiDiagram, isovalue, scratch);
+            computeCycleCentroids(vc, voronoiDiagram, scratch, cellMidpointStart[ci], iso_surface);
+            // Each cell edge lists the cycles crossing it, smallest cycle index first
+            for (const auto &pr : scratch.cellEdgeCycles)
+                cellEdgeCycles.fill(pr.first, pr.second);
+        }
+    }
+    cellEdgeCycles.finish();
+
+    if (droppedConnections > 0)
+    {
+        std::cout << "[WARNING] " << droppedConnections
+                  << " midpoint connections dropped (more than " << MidpointNode::MaxConnections
+                  << " per midpoint)\n";
     }
 }
 
@@ -981,7 +1259,7 @@ std::vector<Point> add_dummy_from_facet(const GRID_FACETS &facet, const UnifiedG
  * @param delaunay_points Output vector for all points (original + dummy).
  * @param dummy_points Output vector for dummy points.
  */
-static void collectDelaunayPoints(UnifiedGrid &grid,
+static void collectDelaunayPoints(const UnifiedGrid &grid,
                                   const std::vector<std::vector<GRID_FACETS>> &grid_facets,
                                   const std::vector<Point> &activeCubeCenters,
                                   VDC_PARAM &vdc_param,
@@ -1044,7 +1322,7 @@ static Vertex_handle insertPointIntoTriangulation(Delaunay &dt,
  * @param activeCubeCenters The list of center points of active cubes.
  */
 void construct_delaunay_triangulation(Delaunay &dt,
-                                      UnifiedGrid &grid,
+                                      const UnifiedGrid &grid,
                                       const std::vector<std::vector<GRID_FACETS>> &grid_facets,
                                       VDC_PARAM &vdc_param,
                                       std::vector<Point> &activeCubeCenters)
@@ -1072,125 +1350,198 @@ void construct_delaunay_triangulation(Delaunay &dt,
 void construct_voronoi_vertices(VoronoiDiagram &voronoiDiagram, Delaunay &dt)
 {
     voronoiDiagram.vertices.clear();
+    voronoiDiagram.vertexWeld.clear();
+    voronoiDiagram.vertexWeld.reserve(dt.number_of_finite_cells());
     const double EPSILON = 1e-6;
-    const double SCALE_FACTOR = 1e6;
 
     for (Delaunay::Finite_cells_iterator cit = dt.finite_cells_begin(); cit != dt.finite_cells_end(); ++cit)
     {
         Point P = dt.dual(cit);
-        int ix = static_cast<int>(std::round(P.x() * SCALE_FACTOR));
-        int iy = static_cast<int>(std::round(P.y() * SCALE_FACTOR));
-        int iz = static_cast<int>(std::round(P.z() * SCALE_FACTOR));
-        std::tuple<int, int, int> key(ix, iy, iz);
-
-        auto it = voronoiDiagram.vertexMap.find(key);
-        int vertex_index = -1;
-        if (it != voronoiDiagram.vertexMap.end())
-        {
-            for (int idx : it->second)
-            {
-                if (CGAL::squared_distance(P, voronoiDiagram.vertices[idx].coord) < EPSILON * EPSILON)
-                {
-                    vertex_index = idx;
-                    break;
-                }
-            }
-        }
+        // Circumcenters closer than EPSILON (per axis) share one Voronoi vertex
+        int vertex_index = voronoiDiagram.vertexWeld.find(P, voronoiDiagram.vertices.coords, EPSILON);
         if (vertex_index == -1)
         {
-            vertex_index = voronoiDiagram.vertices.size();
-            VoronoiVertex vVertex(P);
-            vVertex.index = vertex_index;
-            voronoiDiagram.vertices.push_back(vVertex);
-            voronoiDiagram.vertexMap[key].push_back(vertex_index);
+            vertex_index = voronoiDiagram.AddVertex(P);
         }
         cit->info().dualVoronoiVertexIndex = vertex_index;
     }
 }
 
 //! @brief Computes Voronoi Vertex values using scalar grid interpolation
-void compute_voronoi_values(VoronoiDiagram &voronoiDiagram, UnifiedGrid &grid)
+void compute_voronoi_values(VoronoiDiagram &voronoiDiagram, const UnifiedGrid &grid)
 {
-    for (size_t i = 0; i < voronoiDiagram.vertices.size(); ++i)
+    const std::vector<Point> &coords = voronoiDiagram.vertices.coords;
+    std::vector<float> &values = voronoiDiagram.vertices.values;
+    const int numVertices = static_cast<int>(coords.size());
+#pragma omp parallel for
+    for (int i = 0; i < numVertices; ++i)
     {
-        Point vertex = voronoiDiagram.vertices[i].coord;
-        voronoiDiagram.vertices[i].value = trilinear_interpolate(vertex, grid);
-        float value = trilinear_interpolate(vertex, grid);
+        values[i] = trilinear_interpolate(coords[i], grid);
     }
 }
 
-//! @brief Constructs Voronoi cells from the Delaunay triangulation.
-void construct_voronoi_cells_as_convex_hull(VoronoiDiagram &voronoiDiagram, Delaunay &dt)
+//! @brief Selects the Delaunay vertices whose Voronoi cells are built.
+/*!
+ * Without `activeEdges`, every non-dummy finite vertex is a site. Otherwise
+ * only the non-dummy vertices of the Delaunay facets dual to the marked
+ * Voronoi edges are sites, i.e. exactly the cells containing those edges;
+ * this includes rays and lines, whose facets may be stored from an infinite
+ * cell. Sites are returned in triangulation order, and every other vertex
+ * gets `voronoiCellIndex = -1`.
+ *
+ * @param voronoiDiagram The Voronoi diagram holding the edge-facet relation.
+ * @param dt The Delaunay triangulation.
+ * @param activeEdges Optional per-edge flags (nonzero = build the cells around the edge).
+ * @param sites Output Delaunay vertices, one per cell to build.
+ */
+static void collectCellSites(
+    const VoronoiDiagram &voronoiDiagram,
+    Delaunay &dt,
+    const std::vector<unsigned char> *activeEdges,
+    std::vector<Vertex_handle> &sites)
 {
-    int index = 0;
-    for (auto delaunay_vertex = dt.finite_vertices_begin(); delaunay_vertex != dt.finite_vertices_end(); ++delaunay_vertex)
+    const int unmarked = -1, marked = 0;
+    for (Vertex_handle v : dt.finite_vertex_handles())
+        v->info().voronoiCellIndex = (activeEdges || v->info().is_dummy) ? unmarked : marked;
+
+    if (activeEdges)
     {
-        if (delaunay_vertex->info().is_dummy)
+        for (int ei = 0; ei < static_cast<int>(voronoiDiagram.edges.size()); ++ei)
         {
-            // std::cout << "Dummy Point excluded: " << delaunay_vertex->point() << std::endl;
-            continue;
+            if (!(*activeEdges)[ei])
+                continue;
+            for (const Facet &f : voronoiDiagram.edgeFacets.row(ei))
+            {
+                // The facet vertices are the sites whose cells contain the edge,
+                // also when the facet is stored from its infinite cell
+                for (int k = 1; k <= 3; ++k)
+                {
+                    Vertex_handle v = f.first->vertex((f.second + k) % 4);
+                    if (!dt.is_infinite(v) && !v->info().is_dummy)
+                        v->info().voronoiCellIndex = marked;
+                }
+            }
         }
+    }
+
+    sites.clear();
+    for (Vertex_handle v : dt.finite_vertex_handles())
+    {
+        if (v->info().voronoiCellIndex == marked)
+            sites.push_back(v);
+    }
+}
+
+//! @brief Constructs Voronoi cells from the Delaunay triangulation.
+/*!
+ * Each cell is the convex hull of the Voronoi vertices dual to the finite
+ * Delaunay cells incident to its site. The hull is computed on local vertex
+ * indices through a point property map, so hull facets come back as indices
+ * and no coordinate lookup is needed. Hulls are built in parallel into
+ * thread-local scratch; facets are appended afterwards in cell order so the
+ * output does not depend on the thread count.
+ *
+ * @param voronoiDiagram The Voronoi diagram to populate with cells.
+ * @param dt The Delaunay triangulation corresponding (dual) to the Voronoi diagram.
+ */
+void construct_voronoi_cells_as_convex_hull(VoronoiDiagram &voronoiDiagram, Delaunay &dt, const std::vector<unsigned char> *activeEdges)
+{
+    std::vector<Vertex_handle> sites;
+    collectCellSites(voronoiDiagram, dt, activeEdges, sites);
+
+    // Gather cell vertices serially: Delaunay incidence queries are not thread-safe.
+    voronoiDiagram.cellVertices.clear();
+    std::vector<Cell_handle> incident_cells;
+    std::vector<int> cellVertexIndices;
+    for (Vertex_handle delaunay_vertex : sites)
+    {
+        int index = voronoiDiagram.cells.size();
         VoronoiCell vc(delaunay_vertex);
         vc.cellIndex = index;
 
-        std::vector<Cell_handle> incident_cells;
+        incident_cells.clear();
         dt.finite_incident_cells(delaunay_vertex, std::back_inserter(incident_cells));
 
-        // Collect vertex indices, ensuring uniqueness
-        std::set<int> unique_vertex_indices_set;
+        cellVertexIndices.clear();
         for (Cell_handle ch : incident_cells)
         {
-            if (dt.is_infinite(ch))
-            {
-                // Through an error, should not be happening after checking dummy vertices
-                continue; // Skip infinite cells
-            }
-            Point voronoi_vertex = dt.dual(ch);
-
-            // Check if voronoi_vertex is within domain and exclude dummy points in the dt
-            int vertex_index = find_vertex_index(voronoiDiagram, voronoi_vertex);
-            unique_vertex_indices_set.insert(vertex_index);
+            int vertex_index = ch->info().dualVoronoiVertexIndex;
+            if (vertex_index >= 0)
+                cellVertexIndices.push_back(vertex_index);
         }
+        std::sort(cellVertexIndices.begin(), cellVertexIndices.end());
+        cellVertexIndices.erase(std::unique(cellVertexIndices.begin(), cellVertexIndices.end()), cellVertexIndices.end());
+        voronoiDiagram.cellVertices.appendRow(cellVertexIndices);
 
-        // Copy unique indices to vector
-        vc.vertices_indices.assign(unique_vertex_indices_set.begin(), unique_vertex_indices_set.end());
+        voronoiDiagram.cells.push_back(std::move(vc));
+        delaunay_vertex->info().voronoiCellIndex = index;
+    }
 
-        // Build convex hull and extract facets
-        std::vector<Point> vertex_points;
-        for (int idx : vc.vertices_indices)
-        {
-            vertex_points.push_back(voronoiDiagram.vertices[idx].coord);
-        }
+    const int numCells = voronoiDiagram.cells.size();
+    std::vector<std::vector<std::array<int, 3>>> cellHullFacets(numCells);
 
-        // Remove duplicate points
-        std::sort(vertex_points.begin(), vertex_points.end(), [](const Point &a, const Point &b)
-                  { return a.x() < b.x() || (a.x() == b.x() && (a.y() < b.y() || (a.y() == b.y() && a.z() < b.z()))); });
-        vertex_points.erase(std::unique(vertex_points.begin(), vertex_points.end(), PointApproxEqual()), vertex_points.end());
+#pragma omp parallel
+    {
+        // Thread-local scratch, reused across cells
+        std::vector<int> hullInput;
+        std::vector<Point> hullPoints;
+        std::vector<std::size_t> localIndices;
+        std::vector<std::size_t> hullVertices;
+        std::vector<std::array<std::size_t, 3>> hullFaces;
+
+#pragma omp for schedule(dynamic, 16)
+        for (int ci = 0; ci < numCells; ++ci)
+        {
+            CsrSpan<const int> cellVertexRow = voronoiDiagram.cellVertices.row(ci);
+
+            // Remove near-duplicate points, keeping the Voronoi index of the first one
+            hullInput.assign(cellVertexRow.begin(), cellVertexRow.end());
+            std::sort(hullInput.begin(), hullInput.end(), [&](int a, int b)
+                      { return voronoiDiagram.vertices.coords[a] < voronoiDiagram.vertices.coords[b]; });
+            hullInput.erase(std::unique(hullInput.begin(), hullInput.end(), [&](int a, int b)
+                                        { return PointApproxEqual()(voronoiDiagram.vertices.coords[a], voronoiDiagram.vertices.coords[b]); }),
+                            hullInput.end());
+            if (hullInput.size() < 4)
+                continue;
 
-        CGAL::convex_hull_3(vertex_points.begin(), vertex_points.end(), vc.polyhedron);
+            hullPoints.clear();
+            localIndices.clear();
+            for (std::size_t k = 0; k < hullInput.size(); ++k)
+            {
+                hullPoints.push_back(voronoiDiagram.vertices.coords[hullInput[k]]);
+                localIndices.push_back(k);
+            }
 
-        // Extract facets from polyhedron
-        for (auto facet_it = vc.polyhedron.facets_begin();
-             facet_it != vc.polyhedron.facets_end(); ++facet_it)
-        {
-            VoronoiCellFacet vf;
-            auto h = facet_it->facet_begin();
-            do
+            hullVertices.clear();
+            hullFaces.clear();
+            CGAL::convex_hull_3(localIndices.begin(), localIndices.end(), hullVertices, hullFaces,
+                                CGAL::make_extreme_points_traits_adapter(CGAL::make_property_map(hullPoints)));
+
+            auto &facets = cellHullFacets[ci];
+            facets.reserve(hullFaces.size());
+            for (const auto &face : hullFaces)
             {
-                Point p = h->vertex()->point();
-                int vertex_index = find_vertex_index(voronoiDiagram, p);
-                vf.vertices_indices.push_back(vertex_index);
-                ++h;
-            } while (h != facet_it->facet_begin());
-
-            int facet_index = voronoiDiagram.facets.size();
-            voronoiDiagram.facets.push_back(vf);
-            vc.facet_indices.push_back(facet_index);
+                facets.push_back({hullInput[hullVertices[face[0]]],
+                                  hullInput[hullVertices[face[1]]],
+                                  hullInput[hullVertices[face[2]]]});
+            }
         }
+    }
 
-        voronoiDiagram.cells.push_back(vc);
-        delaunay_vertex->info().voronoiCellIndex = index;
-        index++;
+    // Hull facets are per cell and always stored outward
+    voronoiDiagram.cellFacets.clear();
+    std::vector<int> facetVertices(3);
+    std::vector<VoronoiFacetRef> refs;
+    for (int ci = 0; ci < numCells; ++ci)
+    {
+        refs.clear();
+        for (const auto &tri : cellHullFacets[ci])
+        {
+            facetVertices.assign(tri.begin(), tri.end());
+            int facet_index = voronoiDiagram.AddFacet(facetVertices);
+            refs.push_back({facet_index, 1});
+        }
+        voronoiDiagram.cellFacets.appendRow(refs);
     }
 }
 
@@ -1201,7 +1552,7 @@ void construct_voronoi_cells_as_convex_hull(VoronoiDiagram &voronoiDiagram, Dela
 void orderFacetVertices(std::vector<int> &indices,
                         const Point &p0,
                         const Point &p1,
-                        const std::vector<VoronoiVertex> &vertices)
+                        const std::vector<Point> &vertexCoords)
 {
     // Compute the Delaunay edge direction.
     Vector3 edgeDir = p1 - p0;
@@ -1240,7 +1591,7 @@ void orderFacetVertices(std::vector<int> &indices,
     double sumX = 0, sumY = 0, sumZ = 0;
     for (int idx : indices)
     {
-        const Point &pt = vertices[idx].coord;
+        const Point &pt = vertexCoords[idx];
         sumX += pt.x();
         sumY += pt.y();
         sumZ += pt.z();
@@ -1251,8 +1602,8 @@ void orderFacetVertices(std::vector<int> &indices,
     // Sort indices by their angle (using atan2) in the (vRef, vRef2) coordinate system.
     std::sort(indices.begin(), indices.end(), [&](int a, int b)
               {
-        const Point &pa = vertices[a].coord;
-        const Point &pb = vertices[b].coord;
+        const Point &pa = vertexCoords[a];
+        const Point &pb = vertexCoords[b];
 
         Vector3 va = pa - center;
         Vector3 vb = pb - center;
@@ -1307,290 +1658,245 @@ static void collectCellVertices(
     std::set<int> uniqueVertexIndices;
     for (Cell_handle c : incidentCells)
     {
-        Point vor_vertex = dt.dual(c);
-        int vertex_index = voronoiDiagram.find_vertex(vor_vertex);
-        if (vertex_index >= 0 && vertex_index < voronoiDiagram.vertices.size())
+        int vertex_index = c->info().dualVoronoiVertexIndex;
+        if (vertex_index >= 0 && vertex_index < static_cast<int>(voronoiDiagram.vertices.size()))
         {
             uniqueVertexIndices.insert(vertex_index);
         }
         else
         {
-            std::cerr << "[ERROR] Vertex not found for point " << vor_vertex << "\n";
+            std::cerr << "[ERROR] Vertex not found for point " << dt.dual(c) << "\n";
         }
     }
     vertices_indices.assign(uniqueVertexIndices.begin(), uniqueVertexIndices.end());
 }
 
-//! @brief Builds a facet from an incident edge using cell circulators.
+//! @brief Builds the facet dual to a Delaunay edge using a cell circulator.
 /*!
- * Constructs a Voronoi facet by collecting vertices around an incident edge,
- * ordering them cyclically, and assigning scalar values.
+ * Collects the Voronoi vertices around the edge in circulator order, drops
+ * consecutive duplicates, rotates the cycle to start at its smallest index and
+ * orients it outward with respect to `delaunay_vertex`. Called once per
+ * Delaunay edge; the other endpoint sees the same facet reversed.
  *
  * @param dt The Delaunay triangulation.
- * @param ed The incident edge to process.
- * @param delaunay_vertex The Delaunay vertex associated with the cell.
- * @param voronoiDiagram The Voronoi diagram containing vertex and value data.
- * @param facet_indices Vector to store the facet index.
- * @return The constructed Voronoi facet, or an empty facet if invalid.
+ * @param ed The Delaunay edge to process.
+ * @param delaunay_vertex The endpoint of `ed` the facet is oriented away from.
+ * @param voronoiDiagram The Voronoi diagram containing vertex data.
+ * @param facetVertices Output cyclic list of Voronoi vertex indices.
+ * @return true if a valid facet (3+ finite cells, 3+ distinct vertices) was built.
  */
-static VoronoiCellFacet buildFacetFromEdge(
+static bool buildFacetFromEdge(
     Delaunay &dt,
     const Edge &ed,
     Vertex_handle delaunay_vertex,
     VoronoiDiagram &voronoiDiagram,
-    std::vector<int> &facet_indices,
-    std::map<std::pair<int, int>, std::vector<int>> &edge_to_facets)
+    std::vector<int> &facetVertices)
 {
-    Cell_handle cell_ed = ed.first;
-    int i = ed.second;
-    int j = ed.third;
-    Vertex_handle v1 = cell_ed->vertex(i);
-    Vertex_handle v2 = cell_ed->vertex(j);
-    if (v1 != delaunay_vertex)
-        std::swap(v1, v2); // Ensure v1 is the current vertex
-
     Delaunay::Cell_circulator cc = dt.incident_cells(ed);
     Delaunay::Cell_circulator start = cc;
     std::vector<int> facetVertexIndices;
     int finite_cell_count = 0;
-    bool involves_infinite = false;
     do
     {
-        if (dt.is_infinite(cc))
-        {
-            involves_infinite = true;
-        }
-        else
+        if (!dt.is_infinite(cc))
         {
-            Point vor_vertex = dt.dual(cc);
-            int newIdx = voronoiDiagram.find_vertex(vor_vertex);
-            if (newIdx >= 0 && newIdx < voronoiDiagram.vertices.size())
+            finite_cell_count++;
+            int newIdx = cc->info().dualVoronoiVertexIndex;
+            if (newIdx >= 0 && newIdx < static_cast<int>(voronoiDiagram.vertices.size()))
             {
                 facetVertexIndices.push_back(newIdx);
-                finite_cell_count++;
             }
             else
             {
-                std::cerr << "[ERROR] Vertex not found for point " << vor_vertex << "\n";
+                std::cerr << "[ERROR] Vertex not found for point " << dt.dual(cc) << "\n";
             }
         }
         ++cc;
     } while (cc != start);
 
-    std::set<int> unique_vertices(facetVertexIndices.begin(), facetVertexIndices.end());
+    if (finite_cell_count < 3)
+    {
+        std::cout << "[INFO] Skipping edge with " << finite_cell_count << " finite incident cells (insufficient for interior facet)\n";
+        return false;
+    }
 
     // Remove consecutive duplicates while preserving order
-    std::vector<int> uniqueFacetVertices;
+    facetVertices.clear();
     for (size_t k = 0; k < facetVertexIndices.size(); ++k)
     {
         if (k == 0 || facetVertexIndices[k] != facetVertexIndices[k - 1])
         {
-            uniqueFacetVertices.push_back(facetVertexIndices[k]);
+            facetVertices.push_back(facetVertexIndices[k]);
         }
     }
-    if (uniqueFacetVertices.size() > 1 && uniqueFacetVertices.front() == uniqueFacetVertices.back())
+    if (facetVertices.size() > 1 && facetVertices.front() == facetVertices.back())
     {
-        uniqueFacetVertices.pop_back();
+        facetVertices.pop_back();
     }
 
-    if (uniqueFacetVertices.size() >= 3)
-    {
-        // Find the vertex with the smallest index to standardize starting point
-        auto min_it = std::min_element(uniqueFacetVertices.begin(), uniqueFacetVertices.end());
-        int min_idx = std::distance(uniqueFacetVertices.begin(), min_it);
-        std::rotate(uniqueFacetVertices.begin(), min_it, uniqueFacetVertices.end());
-
-        // Compute normal and adjust orientation
-        Point p0 = voronoiDiagram.vertices[uniqueFacetVertices[0]].coord;
-        Point p1 = voronoiDiagram.vertices[uniqueFacetVertices[1]].coord;
-        Point p2 = voronoiDiagram.vertices[uniqueFacetVertices[2]].coord;
-        Vector3 normal = CGAL::cross_product(p1 - p0, p2 - p0);
-        Point centroid(0, 0, 0);
-        for (int idx : uniqueFacetVertices)
-        {
-            centroid = centroid + (voronoiDiagram.vertices[idx].coord - CGAL::ORIGIN);
-        }
-        centroid = CGAL::ORIGIN + (centroid - CGAL::ORIGIN) / uniqueFacetVertices.size();
-        Point cell_center = delaunay_vertex->point();
-        Vector3 v = centroid - cell_center;
-        if (CGAL::scalar_product(normal, v) < 0)
-        {
-            std::reverse(uniqueFacetVertices.begin() + 1, uniqueFacetVertices.end());
-            // Keep the first vertex fixed, reverse the rest to flip orientation
-        }
-
-        VoronoiCellFacet facet;
-        facet.vertices_indices = uniqueFacetVertices;
-
-        int facetIndex = voronoiDiagram.facets.size();
-        voronoiDiagram.facets.push_back(facet);
-        facet_indices.push_back(facetIndex);
-        std::pair<int, int> edge_key = std::make_pair(
-            std::min(v1->info().index, v2->info().index),
-            std::max(v1->info().index, v2->info().index));
-        edge_to_facets[edge_key].push_back(facetIndex);
-        return facet;
-    }
-    else
+    if (facetVertices.size() < 3)
     {
         std::cout << "[DEBUG] Degenerate facet for edge with " << finite_cell_count << " finite cells\n";
         std::cout << "Original Voronoi vertices:\n";
         for (const auto &idx : facetVertexIndices)
         {
-            const auto &v = voronoiDiagram.vertices[idx];
-            std::cout << "  (" << v.coord.x() << ", " << v.coord.y() << ", " << v.coord.z() << ")\n";
+            const Point &v = voronoiDiagram.vertices.coords[idx];
+            std::cout << "  (" << v.x() << ", " << v.y() << ", " << v.z() << ")\n";
         }
         std::cout << "Unique indices: ";
-        for (int idx : uniqueFacetVertices)
+        for (int idx : facetVertices)
             std::cout << idx << " ";
         std::cout << "\n";
-        return VoronoiCellFacet();
+        std::cout << "[WARNING] Facet construction failed for edge with " << finite_cell_count << " finite cells\n";
+        return false;
+    }
+
+    // Find the vertex with the smallest index to standardize starting point
+    auto min_it = std::min_element(facetVertices.begin(), facetVertices.end());
+    std::rotate(facetVertices.begin(), min_it, facetVertices.end());
+
+    // Compute normal and adjust orientation
+    Point p0 = voronoiDiagram.vertices.coords[facetVertices[0]];
+    Point p1 = voronoiDiagram.vertices.coords[facetVertices[1]];
+    Point p2 = voronoiDiagram.vertices.coords[facetVertices[2]];
+    Vector3 normal = CGAL::cross_product(p1 - p0, p2 - p0);
+    Point centroid(0, 0, 0);
+    for (int idx : facetVertices)
+    {
+        centroid = centroid + (voronoiDiagram.vertices.coords[idx] - CGAL::ORIGIN);
+    }
+    centroid = CGAL::ORIGIN + (centroid - CGAL::ORIGIN) / facetVertices.size();
+    Point cell_center = delaunay_vertex->point();
+    Vector3 v = centroid - cell_center;
+    if (CGAL::scalar_product(normal, v) < 0)
+    {
+        // Keep the first vertex fixed, reverse the rest to flip orientation
+        std::reverse(facetVertices.begin() + 1, facetVertices.end());
     }
+
+    return true;
 }
 
-//! @brief Processes incident edges to build facets for a Voronoi cell.
+//! @brief Removes Voronoi cells with fewer than 4 facets and renumbers the rest.
 /*!
- * Iterates over incident edges to construct facets and add them to the cell.
+ * Dropped cells release their facet references; facets they shared with a
+ * kept cell remain referenced once, as boundary facets. The cellVertices and
+ * cellFacets rows of kept cells are compacted in place.
  *
- * @param dt The Delaunay triangulation.
- * @param delaunay_vertex The Delaunay vertex to process.
- * @param voronoiDiagram The Voronoi diagram to update.
- * @param vc The Voronoi cell to populate with facets.
+ * @param voronoiDiagram The Voronoi diagram whose cells are compacted.
  */
-static void processIncidentEdges(
-    Delaunay &dt,
-    Vertex_handle delaunay_vertex,
-    VoronoiDiagram &voronoiDiagram,
-    VoronoiCell &vc,
-    std::map<std::pair<int, int>, std::vector<int>> &edge_to_facets)
+static void compactVoronoiCells(VoronoiDiagram &voronoiDiagram)
 {
-    std::vector<Edge> incidentEdges;
-    dt.incident_edges(delaunay_vertex, std::back_inserter(incidentEdges));
-
-    for (const Edge &ed : incidentEdges)
+    CsrArray<int> &cellVertices = voronoiDiagram.cellVertices;
+    CsrArray<VoronoiFacetRef> &cellFacets = voronoiDiagram.cellFacets;
+    int cellIndex = 0;
+    int vertexEnd = 0; // Write positions of the compacted rows
+    int facetEnd = 0;
+    for (size_t i = 0; i < voronoiDiagram.cells.size(); ++i)
     {
-        // Count finite incident cells
-        int finite_cell_count = 0;
-        Delaunay::Cell_circulator cc = dt.incident_cells(ed);
-        Delaunay::Cell_circulator start = cc;
-        do
-        {
-            if (!dt.is_infinite(cc))
-            {
-                finite_cell_count++;
-            }
-            ++cc;
-        } while (cc != start);
-
-        if (finite_cell_count < 3)
+        VoronoiCell &vc = voronoiDiagram.cells[i];
+        const int numRefs = cellFacets.rowSize(static_cast<int>(i));
+        if (numRefs < 4)
         {
-            std::cout << "[INFO] Skipping edge with " << finite_cell_count << " finite incident cells (insufficient for interior facet)\n";
+            std::cout << "[WARNING] Cell " << i << " has only " << numRefs << " facets, skipping\n";
+            vc.delaunay_vertex->info().voronoiCellIndex = -1;
             continue;
         }
 
-        // Build facet only if edge has 3+ finite cells
-        VoronoiCellFacet facet = buildFacetFromEdge(dt, ed, delaunay_vertex, voronoiDiagram, vc.facet_indices, edge_to_facets);
-        if (facet.vertices_indices.empty())
-        {
-            std::cout << "[WARNING] Facet construction failed for edge with " << finite_cell_count << " finite cells\n";
-            continue;
-        }
+        // Rows only move towards the front, so copying forward is safe
+        const int vBegin = cellVertices.offsets[i], vEnd = cellVertices.offsets[i + 1];
+        const int fBegin = cellFacets.offsets[i], fEnd = cellFacets.offsets[i + 1];
+        std::copy(cellVertices.data.begin() + vBegin, cellVertices.data.begin() + vEnd, cellVertices.data.begin() + vertexEnd);
+        std::copy(cellFacets.data.begin() + fBegin, cellFacets.data.begin() + fEnd, cellFacets.data.begin() + facetEnd);
+        vertexEnd += vEnd - vBegin;
+        facetEnd += fEnd - fBegin;
+        cellVertices.offsets[cellIndex + 1] = vertexEnd;
+        cellFacets.offsets[cellIndex + 1] = facetEnd;
 
-        // Verify facet validity
-        if (facet.vertices_indices.size() < 3)
+        vc.cellIndex = cellIndex;
+        vc.delaunay_vertex->info().voronoiCellIndex = cellIndex;
+        if (static_cast<int>(i) != cellIndex)
         {
-            std::cout << "[ERROR] Degenerate interior facet detected with " << facet.vertices_indices.size() << " vertices despite " << finite_cell_count << " finite cells\n";
-            continue;
-        }
-
-        int facetIndex = voronoiDiagram.facets.size() - 1; // Assuming facet was just added
-        if (std::find(vc.facet_indices.begin(), vc.facet_indices.end(), facetIndex) == vc.facet_indices.end())
-        {
-            vc.facet_indices.push_back(facetIndex);
+            voronoiDiagram.cells[cellIndex] = std::move(vc);
         }
+        cellIndex++;
     }
+    voronoiDiagram.cells.erase(voronoiDiagram.cells.begin() + cellIndex, voronoiDiagram.cells.end());
+    cellVertices.offsets.resize(cellIndex + 1);
+    cellVertices.data.resize(vertexEnd);
+    cellFacets.offsets.resize(cellIndex + 1);
+    cellFacets.data.resize(facetEnd);
 }
 
 //! @brief Constructs Voronoi cells without using Convex_Hull_3 (in development).
 /*!
  * Populates the Voronoi diagram with polyhedral cells derived from the Delaunay
- * triangulation by processing incident edges and cell circulators.
+ * triangulation. Every finite Delaunay edge with at least one endpoint that
+ * is a site is visited once; its dual facet is stored once and referenced by
+ * both endpoint cells with opposite orientations. A facet shared with a
+ * vertex that has no cell is referenced once, as a boundary facet.
  *
  * @param voronoiDiagram The Voronoi diagram to populate with cells.
  * @param dt The Delaunay triangulation corresponding (dual) to the Voronoi diagram.
+ * @param activeEdges Optional per-edge flags restricting the cells to those around marked edges.
  */
-void construct_voronoi_cells_from_delaunay_triangulation(VoronoiDiagram &voronoiDiagram, Delaunay &dt)
+void construct_voronoi_cells_from_delaunay_triangulation(VoronoiDiagram &voronoiDiagram, Delaunay &dt, const std::vector<unsigned char> *activeEdges)
 {
-    std::map<std::pair<int, int>, std::vector<int>> edge_to_facets;
-    int cellIndex = 0;
+    std::vector<Vertex_handle> sites;
+    collectCellSites(voronoiDiagram, dt, activeEdges, sites);
 
-    for (Vertex_handle v : dt.finite_vertex_handles())
+    // One cell per site
+    voronoiDiagram.cellVertices.clear();
+    std::vector<int> cellVertexIndices;
+    for (Vertex_handle v : sites)
     {
-        if (v->info().is_dummy)
-            continue; // Skip dummy vertices
+        int cellIndex = voronoiDiagram.cells.size();
+        voronoiDiagram.cells.push_back(createVoronoiCell(v, cellIndex));
+        collectCellVertices(dt, v, voronoiDiagram, cellVertexIndices);
+        voronoiDiagram.cellVertices.appendRow(cellVertexIndices);
+        v->info().voronoiCellIndex = cellIndex;
+    }
 
-        VoronoiCell vc = createVoronoiCell(v, cellIndex);
-        collectCellVertices(dt, v, voronoiDiagram, vc.vertices_indices);
-        processIncidentEdges(dt, v, voronoiDiagram, vc, edge_to_facets);
+    // One facet per Delaunay edge, shared by both endpoint cells.
+    // References are recorded as (facet, cell1, cell2) and laid out per cell afterwards.
+    std::vector<int> facetVertices;
+    std::vector<std::array<int, 3>> facetCells;
+    for (auto eit = dt.finite_edges_begin(); eit != dt.finite_edges_end(); ++eit)
+    {
+        const Edge &ed = *eit;
+        Vertex_handle v1 = ed.first->vertex(ed.second);
+        Vertex_handle v2 = ed.first->vertex(ed.third);
+        if (v1->info().voronoiCellIndex < 0 && v2->info().voronoiCellIndex < 0)
+            continue; // Neither endpoint has a cell (dummy or not a site)
+        if (v1->info().voronoiCellIndex < 0)
+            std::swap(v1, v2); // Orient the stored facet outward for a built cell
+
+        if (!buildFacetFromEdge(dt, ed, v1, voronoiDiagram, facetVertices))
+            continue;
 
-        // Validate the number of facets
-        if (vc.facet_indices.size() < 4)
-        {
-            std::cout << "[WARNING] Cell " << cellIndex << " has only " << vc.facet_indices.size() << " facets, skipping\n";
-        }
-        else
-        {
-            voronoiDiagram.cells.push_back(vc);
-            v->info().voronoiCellIndex = cellIndex;
-            cellIndex++;
-        }
+        int facetIndex = voronoiDiagram.AddFacet(facetVertices);
+        facetCells.push_back({facetIndex, v1->info().voronoiCellIndex, v2->info().voronoiCellIndex});
     }
 
-    for (const auto &kv : edge_to_facets)
+    // Counting pass, then fill in edge order
+    CsrArray<VoronoiFacetRef> &cellFacets = voronoiDiagram.cellFacets;
+    cellFacets.startCounts(voronoiDiagram.cells.size());
+    for (const auto &fc : facetCells)
     {
-        const std::vector<int> &facets = kv.second;
-        if (facets.size() == 2)
-        {
-            int f1 = facets[0];
-            int f2 = facets[1];
-            voronoiDiagram.facets[f1].mirror_facet_index = f2;
-            voronoiDiagram.facets[f2].mirror_facet_index = f1;
-
-            const auto &v1 = voronoiDiagram.facets[f1].vertices_indices;
-            const auto &v2 = voronoiDiagram.facets[f2].vertices_indices;
-
-            // Check if v2 is the reverse of v1, considering cyclic shifts
-            bool is_opposite = false;
-            size_t n = v1.size();
-            for (size_t shift = 0; shift < n; ++shift)
-            {
-                bool match = true;
-                for (size_t i = 0; i < n; ++i)
-                {
-                    if (v1[i] != v2[(n - i + shift) % n])
-                    {
-                        match = false;
-                        break;
-                    }
-                }
-                if (match)
-                {
-                    is_opposite = true;
-                    break;
-                }
-            }
-            if (!is_opposite)
-            {
-                std::cout << "[WARNING] Facets " << f1 << " and " << f2
-                          << " do not have opposite orientations after standardization\n";
-            }
-        }
-        else if (facets.size() == 1)
-        {
-            int f = facets[0];
-            voronoiDiagram.facets[f].mirror_facet_index = -1; // Boundary facet
-        }
+        cellFacets.count(fc[1]);
+        if (fc[2] >= 0)
+            cellFacets.count(fc[2]);
     }
+    cellFacets.allocate();
+    for (const auto &fc : facetCells)
+    {
+        cellFacets.fill(fc[1], {fc[0], 1});
+        if (fc[2] >= 0)
+            cellFacets.fill(fc[2], {fc[0], -1});
+    }
+    cellFacets.finish();
+
+    compactVoronoiCells(voronoiDiagram);
 }
 
 // Helper function to check if two directions are approximately equal
@@ -1605,7 +1911,8 @@ bool directionsEqual(const Vector3 &d1, const Vector3 &d2, double epsilon)
 void construct_voronoi_edges(VoronoiDiagram &voronoiDiagram, Delaunay &dt)
 {
     voronoiDiagram.edges.clear();
-    std::map<std::pair<int, int>, int> segmentMap;              // Maps sorted vertex pairs to edge indices
+    voronoiDiagram.segmentVertexPairToEdgeIndex.clear(); // Also serves as the segment dedup table
+    std::vector<std::pair<int, Facet>> edgeFacetPairs; // (edge index, dual facet), laid out as CSR at the end
     std::map<int, std::vector<std::pair<Vector3, int>>> rayMap; // Maps vertex index to (direction, edgeIdx) pairs
     const double EPSILON = 1e-6;
 
@@ -1627,22 +1934,21 @@ void construct_voronoi_edges(VoronoiDiagram &voronoiDiagram, Delaunay &dt)
             { // Finite segment
                 int v1 = std::min(idx1, idx2);
                 int v2 = std::max(idx1, idx2);
-                auto it = segmentMap.find({v1, v2});
-                if (it != segmentMap.end())
+                int existing = voronoiDiagram.segmentVertexPairToEdgeIndex.find(v1, v2);
+                if (existing >= 0)
                 {
-                    voronoiDiagram.edges[it->second].delaunayFacets.push_back(facet);
+                    edgeFacetPairs.emplace_back(existing, facet);
                 }
                 else
                 {
-                    VoronoiEdge vEdge(edgeobj);
+                    VoronoiEdge vEdge;
                     vEdge.type = 0;
                     vEdge.vertex1 = v1;
                     vEdge.vertex2 = v2;
                     int edgeIdx = voronoiDiagram.edges.size();
-                    vEdge.delaunayFacets.push_back(facet);
+                    edgeFacetPairs.emplace_back(edgeIdx, facet);
                     voronoiDiagram.edges.push_back(vEdge);
-                    segmentMap[{v1, v2}] = edgeIdx;
-                    voronoiDiagram.segmentVertexPairToEdgeIndex[{v1, v2}] = edgeIdx;
+                    voronoiDiagram.segmentVertexPairToEdgeIndex.set(v1, v2, edgeIdx);
                 }
             }
         }
@@ -1670,7 +1976,7 @@ void construct_voronoi_edges(VoronoiDiagram &voronoiDiagram, Delaunay &dt)
                     {
                         if (directionsEqual(pair.first, dir, EPSILON))
                         {
-                            voronoiDiagram.edges[pair.second].delaunayFacets.push_back(facet);
+                            edgeFacetPairs.emplace_back(pair.second, facet);
                             found = true;
                             break;
                         }
@@ -1678,14 +1984,13 @@ void construct_voronoi_edges(VoronoiDiagram &voronoiDiagram, Delaunay &dt)
                 }
                 if (!found)
                 {
-                    VoronoiEdge vEdge(edgeobj);
+                    VoronoiEdge vEdge;
                     vEdge.type = 1;
                     vEdge.vertex1 = vertex1;
                     vEdge.vertex2 = -1;
-                    vEdge.source = ray.source();
-                    vEdge.direction = dir;
+                    vEdge.setDirection(dir);
                     int edgeIdx = voronoiDiagram.edges.size();
-                    vEdge.delaunayFacets.push_back(facet);
+                    edgeFacetPairs.emplace_back(edgeIdx, facet);
                     voronoiDiagram.edges.push_back(vEdge);
                     rayMap[vertex1].push_back({dir, edgeIdx});
                 }
@@ -1693,12 +1998,134 @@ void construct_voronoi_edges(VoronoiDiagram &voronoiDiagram, Delaunay &dt)
         }
         // Lines are not expected for finite facets, so we skip them
     }
+
+    CsrArray<Facet> &edgeFacets = voronoiDiagram.edgeFacets;
+    edgeFacets.startCounts(voronoiDiagram.edges.size());
+    for (const auto &ef : edgeFacetPairs)
+        edgeFacets.count(ef.first);
+    edgeFacets.allocate();
+    for (const auto &ef : edgeFacetPairs)
+        edgeFacets.fill(ef.first, ef.second);
+    edgeFacets.finish();
+}
+
+//! @brief Clips every ray and line edge to the bounding box, once.
+/*!
+ * The slab kernel clipToBox() runs in parallel over the edges; the weld
+ * lookups of the clipped ends run serially afterwards (the weld index keeps
+ * lookup statistics). A ray starting inside the box keeps its source vertex
+ * without a lookup.
+ *
+ * @param voronoiDiagram The Voronoi diagram whose edges are clipped.
+ * @param bbox The bounding box of the domain.
+ */
+void clip_unbounded_edges(VoronoiDiagram &voronoiDiagram, const CGAL::Epick::Iso_cuboid_3 &bbox)
+{
+    std::vector<VoronoiEdge> &edges = voronoiDiagram.edges;
+    const int numEdges = static_cast<int>(edges.size());
+
+    // Slot per unbounded edge, in edge order
+    std::vector<int> unbounded;
+    for (int ei = 0; ei < numEdges; ++ei)
+    {
+        edges[ei].clipIndex = -1;
+        if (edges[ei].type == 1 || edges[ei].type == 2)
+            unbounded.push_back(ei);
+    }
+
+    const int numUnbounded = static_cast<int>(unbounded.size());
+    std::vector<ClippedEdge> clips(numUnbounded);
+    std::vector<unsigned char> inside(numUnbounded, 0);
+    const Point boxMin = bbox.min();
+    const Point boxMax = bbox.max();
+#pragma omp parallel for
+    for (int k = 0; k < numUnbounded; ++k)
+    {
+        const VoronoiEdge &edge = edges[unbounded[k]];
+        inside[k] = clipToBox(voronoiDiagram.vertices.coords[edge.vertex1], edge.directionVector(), edge.type == 2,
+                              boxMin, boxMax, clips[k].source, clips[k].target);
+    }
+
+    std::vector<ClippedEdge> &clippedEdges = voronoiDiagram.clippedEdges;
+    clippedEdges.clear();
+    clippedEdges.reserve(numUnbounded);
+    for (int k = 0; k < numUnbounded; ++k)
+    {
+        if (!inside[k])
+            continue;
+        VoronoiEdge &edge = edges[unbounded[k]];
+        ClippedEdge &clip = clips[k];
+        const bool sourceIsVertex = (edge.type == 1 && clip.source == voronoiDiagram.vertices.coords[edge.vertex1]);
+        clip.sourceVertex = sourceIsVertex ? edge.vertex1 : voronoiDiagram.find_vertex(clip.source);
+        clip.targetVertex = voronoiDiagram.find_vertex(clip.target);
+        edge.clipIndex = static_cast<int>(clippedEdges.size());
+        clippedEdges.push_back(clip);
+    }
+}
+
+//! @brief Computes the scalar values at the ends of the clipped edges.
+/*!
+ * Ends are moved onto the grid with adjust_outside_bound_points() before
+ * interpolation, as the single-isovertex triangle pass always did.
+ *
+ * @param voronoiDiagram The Voronoi diagram with clipped edges.
+ * @param grid The scalar grid.
+ */
+void compute_clipped_edge_values(VoronoiDiagram &voronoiDiagram, const UnifiedGrid &grid)
+{
+    const std::vector<VoronoiEdge> &edges = voronoiDiagram.edges;
+    const int numEdges = static_cast<int>(edges.size());
+#pragma omp parallel for
+    for (int ei = 0; ei < numEdges; ++ei)
+    {
+        const VoronoiEdge &edge = edges[ei];
+        if (edge.clipIndex < 0)
+            continue;
+        ClippedEdge &clip = voronoiDiagram.clippedEdges[edge.clipIndex];
+        clip.sourceValue = (edge.type == 1)
+                               ? voronoiDiagram.vertices.values[edge.vertex1]
+                               : trilinear_interpolate(adjust_outside_bound_points(clip.source, grid, clip.source, clip.target), grid);
+        clip.targetValue = trilinear_interpolate(adjust_outside_bound_points(clip.target, grid, clip.source, clip.target), grid);
+    }
+}
+
+//! @brief Collects the sorted, unique Voronoi cells around the dual facets of an edge.
+/*!
+ * @param dualFacets The Delaunay facets dual to the Voronoi edge.
+ * @param dt The Delaunay triangulation.
+ * @param cellIndices Output cell indices; cleared first.
+ */
+static void collectEdgeCells(
+    CsrSpan<const Facet> dualFacets,
+    Delaunay &dt,
+    std::vector<int> &cellIndices)
+{
+    cellIndices.clear();
+    for (const Facet &f : dualFacets)
+    {
+        Cell_handle c = f.first;
+        if (dt.is_infinite(c))
+            continue;
+
+        for (int corner = 0; corner < 4; ++corner)
+        {
+            Vertex_handle delaunay_vertex = c->vertex(corner);
+            if (!delaunay_vertex->info().is_dummy && delaunay_vertex->info().voronoiCellIndex >= 0)
+            {
+                cellIndices.push_back(delaunay_vertex->info().voronoiCellIndex);
+            }
+        }
+    }
+    std::sort(cellIndices.begin(), cellIndices.end());
+    cellIndices.erase(std::unique(cellIndices.begin(), cellIndices.end()), cellIndices.end());
 }
 
 //! @brief Builds Voronoi cell edges for each edge in the diagram.
 /*!
  * Creates VoronoiCellEdge entries for cells sharing each edge, collecting cell indices
- * from associated Delaunay facets.
+ * from associated Delaunay facets. The cells of each edge are counted in a first
+ * parallel pass and written in a second one, so cell edges come out grouped by
+ * edge index without any per-edge containers.
  *
  * @param voronoiDiagram The Voronoi diagram to populate with cell edges.
  * @param dt The Delaunay triangulation.
@@ -1708,45 +2135,44 @@ static void buildCellEdges(
     Delaunay &dt)
 {
     voronoiDiagram.cellEdges.clear();
-    std::vector<std::unordered_set<int>> cellIndicesPerEdge(voronoiDiagram.edges.size());
+    const int numEdges = static_cast<int>(voronoiDiagram.edges.size());
+    CsrArray<int> cellsPerEdge;
+    cellsPerEdge.startCounts(numEdges);
 
-// Parallelize edge processing
-#pragma omp parallel for
-    for (int edgeIdx = 0; edgeIdx < voronoiDiagram.edges.size(); ++edgeIdx)
+#pragma omp parallel
     {
+        std::vector<int> cellIndices; // Thread-local scratch
 
-        const std::vector<Facet> &sharedFacets = voronoiDiagram.edges[edgeIdx].delaunayFacets;
+        // Pass 1: number of cells around each edge
+#pragma omp for
+        for (int edgeIdx = 0; edgeIdx < numEdges; ++edgeIdx)
+        {
+            collectEdgeCells(voronoiDiagram.edgeFacets.row(edgeIdx), dt, cellIndices);
+            cellsPerEdge.count(edgeIdx, static_cast<int>(cellIndices.size()));
+        }
 
-        std::unordered_set<int> cellIndices;
+#pragma omp single
+        cellsPerEdge.allocate();
 
-        for (const Facet &f : sharedFacets)
+        // Pass 2: each thread writes only the rows of its own edges
+#pragma omp for
+        for (int edgeIdx = 0; edgeIdx < numEdges; ++edgeIdx)
         {
-            Cell_handle c = f.first;
-            if (dt.is_infinite(c))
-                continue;
-
-            for (int corner = 0; corner < 4; ++corner)
-            {
-                Vertex_handle delaunay_vertex = c->vertex(corner);
-                if (!delaunay_vertex->info().is_dummy)
-                {
-                    int cellIdx = delaunay_vertex->info().voronoiCellIndex;
-                    cellIndices.insert(cellIdx);
-                }
-            }
+            collectEdgeCells(voronoiDiagram.edgeFacets.row(edgeIdx), dt, cellIndices);
+            std::copy(cellIndices.begin(), cellIndices.end(), cellsPerEdge.row(edgeIdx).begin());
         }
-        cellIndicesPerEdge[edgeIdx] = std::move(cellIndices);
     }
+    cellsPerEdge.finish();
 
-    // Collect all cell edges in a single pass
-    for (int edgeIdx = 0; edgeIdx < voronoiDiagram.edges.size(); ++edgeIdx)
+    // Emit all cell edges in a single pass, grouped by edge
+    voronoiDiagram.cellEdges.reserve(cellsPerEdge.entries());
+    for (int edgeIdx = 0; edgeIdx < numEdges; ++edgeIdx)
     {
-        for (int cIdx : cellIndicesPerEdge[edgeIdx])
+        for (int cIdx : cellsPerEdge.row(edgeIdx))
         {
             VoronoiCellEdge cellEdge;
             cellEdge.cellIndex = cIdx;
             cellEdge.edgeIndex = edgeIdx;
-            cellEdge.cycleIndices = {};
             cellEdge.nextCellEdge = -1;
             voronoiDiagram.cellEdges.push_back(cellEdge);
         }
@@ -1756,130 +2182,76 @@ static void buildCellEdges(
 //! @brief Links Voronoi cell edges in a circular ring.
 /*!
  * Connects cell edges sharing the same edge index using the nextCellEdge field
- * to form a closed loop.
+ * to form a closed loop. Relies on buildCellEdges emitting cell edges grouped
+ * by edge index.
  *
  * @param voronoiDiagram The Voronoi diagram containing cell edges to link.
  */
 static void linkCellEdges(
     VoronoiDiagram &voronoiDiagram)
 {
-    std::unordered_map<int, std::vector<int>> edgeIdx_to_cellEdges;
-    for (int ceIdx = 0; ceIdx < (int)voronoiDiagram.cellEdges.size(); ++ceIdx)
+    std::vector<VoronoiCellEdge> &cellEdges = voronoiDiagram.cellEdges;
+    const int numCellEdges = static_cast<int>(cellEdges.size());
+    int groupStart = 0;
+    while (groupStart < numCellEdges)
     {
-        const VoronoiCellEdge &ce = voronoiDiagram.cellEdges[ceIdx];
-        edgeIdx_to_cellEdges[ce.edgeIndex].push_back(ceIdx);
-    }
+        int groupEnd = groupStart + 1;
+        while (groupEnd < numCellEdges && cellEdges[groupEnd].edgeIndex == cellEdges[groupStart].edgeIndex)
+            ++groupEnd;
 
-    for (auto &kv : edgeIdx_to_cellEdges)
-    {
-        auto &cellEdgeIndices = kv.second;
-        int N = (int)cellEdgeIndices.size();
-        for (int i = 0; i < N; i++)
-        {
-            int ceIdx = cellEdgeIndices[i];
-            int nextIdx = cellEdgeIndices[(i + 1) % N];
-            voronoiDiagram.cellEdges[ceIdx].nextCellEdge = nextIdx;
-        }
+        for (int ceIdx = groupStart; ceIdx < groupEnd - 1; ++ceIdx)
+            cellEdges[ceIdx].nextCellEdge = ceIdx + 1;
+        cellEdges[groupEnd - 1].nextCellEdge = groupStart;
+
+        groupStart = groupEnd;
     }
 }
 
 //! @brief Processes edge mapping for a single Voronoi edge.
 /*!
- * Updates the segmentVertexPairToEdgeIndex map for segments, rays, and lines
- * after intersecting with the bounding box.
+ * Updates the segmentVertexPairToEdgeIndex map for segments, and for rays and
+ * lines whose clipped ends both coincide with Voronoi vertices. The clipped
+ * ends and their vertices come from clip_unbounded_edges(); nothing is
+ * intersected or looked up here.
  *
  * @param voronoiDiagram The Voronoi diagram to update.
- * @param edgeObj The CGAL object representing the edge.
+ * @param edge The VoronoiEdge representing the edge.
  * @param edgeIdx The index of the edge in the diagram.
- * @param bbox The bounding box for intersection.
  */
 static void processEdgeMapping(
     VoronoiDiagram &voronoiDiagram,
-    const CGAL::Object &edgeObj,
-    int edgeIdx,
-    CGAL::Epick::Iso_cuboid_3 &bbox)
+    const VoronoiEdge &edge,
+    int edgeIdx)
 {
-    Segment3 seg;
-    Ray3 ray;
-    Line3 line;
-    Point p1, p2;
-    bool isSegment = false;
-
-    if (CGAL::assign(seg, edgeObj))
-    {
-        p1 = seg.source();
-        p2 = seg.target();
-        isSegment = true;
-    }
-    else if (CGAL::assign(ray, edgeObj))
-    {
-        CGAL::Object clippedObj = CGAL::intersection(bbox, ray);
-        Segment3 clippedSeg;
-        if (CGAL::assign(clippedSeg, clippedObj))
-        {
-            p1 = clippedSeg.source();
-            p2 = clippedSeg.target();
-            isSegment = true;
-        }
-    }
-    else if (CGAL::assign(line, edgeObj))
+    if (edge.type == 0)
     {
-        CGAL::Object clippedObj = CGAL::intersection(bbox, line);
-        Segment3 clippedSeg;
-        if (CGAL::assign(clippedSeg, clippedObj))
-        {
-            p1 = clippedSeg.source();
-            p2 = clippedSeg.target();
-            isSegment = true;
-        }
+        // Endpoints are already known; no coordinate lookup needed
+        voronoiDiagram.segmentVertexPairToEdgeIndex.set(edge.vertex1, edge.vertex2, edgeIdx);
+        return;
     }
 
-    if (isSegment)
+    const ClippedEdge *clip = voronoiDiagram.clippedEdge(edge);
+    if (clip && clip->sourceVertex >= 0 && clip->targetVertex >= 0)
     {
-        int idx1 = find_vertex_index(voronoiDiagram, p1);
-        int idx2 = find_vertex_index(voronoiDiagram, p2);
-        // std::cout << "[DEBUG] Processing edge " << edgeIdx << " with vertices: (" << idx1 << ", " << idx2 << ") with edge index: " << edgeIdx << std::endl;
-        if (idx1 == -1)
-        {
-            std::cout << "[WARNING] Failed to find vertex index for point: " << p1 << std::endl;
-        }
-        else if (idx2 == -1)
-        {
-            std::cout << "[WARNING] Failed to find vertex index for point: " << p2 << std::endl;
-        }
-        else
-        {
-            int v1 = std::min(idx1, idx2);
-            int v2 = std::max(idx1, idx2);
-            voronoiDiagram.segmentVertexPairToEdgeIndex[{v1, v2}] = edgeIdx;
-        }
+        voronoiDiagram.segmentVertexPairToEdgeIndex.set(clip->sourceVertex, clip->targetVertex, edgeIdx);
     }
 }
 
 //! @brief Updates edge mappings for all Voronoi edges.
 /*!
- * Processes all edges to update segmentVertexPairToEdgeIndex and cellEdgeLookup maps.
+ * Processes all edges to update the segmentVertexPairToEdgeIndex table and rebuilds cellEdgeLookup.
  *
  * @param voronoiDiagram The Voronoi diagram to update.
- * @param bbox The bounding box for intersection.
  */
 static void updateEdgeMappings(
-    VoronoiDiagram &voronoiDiagram,
-    CGAL::Epick::Iso_cuboid_3 &bbox)
+    VoronoiDiagram &voronoiDiagram)
 {
     for (int edgeIdx = 0; edgeIdx < (int)voronoiDiagram.edges.size(); ++edgeIdx)
     {
-        const CGAL::Object &edgeObj = voronoiDiagram.edges[edgeIdx].edgeObject;
-        processEdgeMapping(voronoiDiagram, edgeObj, edgeIdx, bbox);
+        processEdgeMapping(voronoiDiagram, voronoiDiagram.edges[edgeIdx], edgeIdx);
     }
 
-    voronoiDiagram.cellEdgeLookup.clear();
-    for (int ceIdx = 0; ceIdx < (int)voronoiDiagram.cellEdges.size(); ++ceIdx)
-    {
-        const VoronoiCellEdge &ce = voronoiDiagram.cellEdges[ceIdx];
-        std::pair<int, int> key = std::make_pair(ce.cellIndex, ce.edgeIndex);
-        voronoiDiagram.cellEdgeLookup[key] = ceIdx;
-    }
+    voronoiDiagram.buildCellEdgeLookup();
 }
 
 //! @brief Constructs the Voronoi cell edges in the Voronoi diagram and links them.
@@ -1888,12 +2260,10 @@ static void updateEdgeMappings(
  * updates edge mappings.
  *
  * @param voronoiDiagram The Voronoi diagram to populate with edges.
- * @param bbox The bounding box used for clipping rays and lines.
  * @param dt The Delaunay triangulation.
  */
 void construct_voronoi_cell_edges(
     VoronoiDiagram &voronoiDiagram,
-    CGAL::Epick::Iso_cuboid_3 &bbox,
     Delaunay &dt)
 {
     voronoiDiagram.cellEdges.clear();
@@ -1912,7 +2282,7 @@ void construct_voronoi_cell_edges(
 
     std::cout << "link cell edge Execution time: " << duration2 << " seconds" << std::endl;
 
-    updateEdgeMappings(voronoiDiagram, bbox);
+    updateEdgeMappings(voronoiDiagram);
 
     std::clock_t check3 = std::clock();
 
@@ -1921,27 +2291,119 @@ void construct_voronoi_cell_edges(
     std::cout << "update edge mapping Execution time: " << duration3 << " seconds" << std::endl;
 }
 
+//! @brief Marks the Voronoi edges that cross the isosurface.
+/*!
+ * Uses the same tests as computeDualTrianglesMulti(): segments compare the
+ * signs of their vertex values, rays and lines compare the cached values at
+ * the ends of their clipped parts.
+ *
+ * @param voronoiDiagram The Voronoi diagram, with vertex values and clipped edges computed.
+ * @param isovalue The isovalue.
+ * @param bipolarEdges Output per-edge flags (1 = bipolar).
+ * @return Number of bipolar edges.
+ */
+static int markBipolarEdges(
+    const VoronoiDiagram &voronoiDiagram,
+    float isovalue,
+    std::vector<unsigned char> &bipolarEdges)
+{
+    std::vector<unsigned char> above;
+    voronoiDiagram.vertices.classify(isovalue, above);
+
+    const int numEdges = static_cast<int>(voronoiDiagram.edges.size());
+    bipolarEdges.assign(numEdges, 0);
+    int numBipolar = 0;
+#pragma omp parallel for reduction(+ : numBipolar)
+    for (int ei = 0; ei < numEdges; ++ei)
+    {
+        const VoronoiEdge &edge = voronoiDiagram.edges[ei];
+        bool bipolar = false;
+        if (edge.type == 0)
+        {
+            bipolar = above[edge.vertex1] != above[edge.vertex2];
+        }
+        else if (const ClippedEdge *clip = voronoiDiagram.clippedEdge(edge))
+        {
+            bipolar = is_bipolar(clip->sourceValue, clip->targetValue, isovalue);
+        }
+        if (bipolar)
+        {
+            bipolarEdges[ei] = 1;
+            ++numBipolar;
+        }
+    }
+    return numBipolar;
+}
+
+//! @brief Whether the pipeline needs an explicit VoronoiDiagram.
+/*!
+ * Multi-isovertex mode always does. Single-isovertex mode only does when the
+ * full diagram is requested (`-full_vor`) or written out (testing, CSV,
+ * `-dump_vd`); otherwise its triangles come from computeDualTrianglesDirect().
+ */
+bool needs_voronoi_diagram(const VDC_PARAM &vdc_param)
+{
+    return vdc_param.multi_isov || needs_full_voronoi_diagram(vdc_param);
+}
+
+//! @brief Whether every Voronoi cell has to be built rather than only those around bipolar edges.
+bool needs_full_voronoi_diagram(const VDC_PARAM &vdc_param)
+{
+    return vdc_param.full_vor || vdc_param.test_vor || vdc_param.out_csv || !vdc_param.dump_vd.empty();
+}
+
+//! @brief Runs the Voronoi diagram checks selected with -validate; throws on violations.
+void validate_voronoi_diagram(VoronoiDiagram &vd, const VDC_PARAM &vdc_param)
+{
+    if (vdc_param.validate == ValidationLevel::None)
+        return;
+    ValidationReport report = vd.validate(vdc_param.validate);
+    std::cout << report.toJson() << std::endl;
+    if (!report.ok())
+        throw std::runtime_error("Voronoi diagram validation found " + std::to_string(report.violations()) + " violation(s).");
+}
+
 //! @brief Wrap up function of constructing voronoi diagram
-void construct_voronoi_diagram(VoronoiDiagram &vd, VDC_PARAM &vdc_param, UnifiedGrid &grid, CGAL::Epick::Iso_cuboid_3 &bbox, Delaunay &dt)
+/*!
+ * In multi-isovertex mode the cells are built lazily by default: vertex
+ * values are computed first, bipolar edges are marked, and only the cells
+ * around bipolar edges get facets, cell edges and (later) cycles. The full
+ * diagram is built with `-full_vor`, or when it is needed for testing,
+ * export or a dump.
+ */
+void construct_voronoi_diagram(VoronoiDiagram &vd, VDC_PARAM &vdc_param, const UnifiedGrid &grid, CGAL::Epick::Iso_cuboid_3 &bbox, Delaunay &dt)
 {
     construct_voronoi_vertices(vd, dt);
     construct_voronoi_edges(vd, dt);
-    VoronoiDiagram vd2 = collapseSmallEdges(vd, 0.001, bbox);
-    compute_voronoi_values(vd2, grid);
+    collapseSmallEdges(vd, vdc_param.collapse_eps, dt);
+    clip_unbounded_edges(vd, bbox);
+    compute_voronoi_values(vd, grid);
+    compute_clipped_edge_values(vd, grid);
     if (vdc_param.multi_isov)
     {
+        std::vector<unsigned char> bipolarEdges;
+        const std::vector<unsigned char> *activeEdges = nullptr;
+        if (!needs_full_voronoi_diagram(vdc_param))
+        {
+            int numBipolar = markBipolarEdges(vd, vdc_param.isovalue, bipolarEdges);
+            activeEdges = &bipolarEdges;
+            std::cout << "[INFO] Lazy Voronoi cells: " << numBipolar << " of " << vd.edges.size()
+                      << " edges are bipolar" << std::endl;
+        }
+
         if (vdc_param.convex_hull)
         {
-            construct_voronoi_cells_as_convex_hull(vd2, dt);
+            construct_voronoi_cells_as_convex_hull(vd, dt, activeEdges);
         }
         else
         {
-            construct_voronoi_cells_from_delaunay_triangulation(vd2, dt);
+            construct_voronoi_cells_from_delaunay_triangulation(vd, dt, activeEdges);
         }
-        construct_voronoi_cell_edges(vd2, bbox, dt);
+        std::cout << "[INFO] Built " << vd.cells.size() << " Voronoi cells" << std::endl;
+        vd.buildVertexCells();
+        construct_voronoi_cell_edges(vd, dt);
     }
-    vd2.check();
-    vd = std::move(vd2);
+    validate_voronoi_diagram(vd, vdc_param);
 
     if (debug)
     {
@@ -1950,7 +2412,7 @@ void construct_voronoi_diagram(VoronoiDiagram &vd, VDC_PARAM &vdc_param, Unified
         std::cout << "===========\n[DEBUG] Voronoi vertices near hole:\n";
         for (size_t i = 0; i < vd.vertices.size(); ++i)
         {
-            const Point &p = vd.vertices[i].coord;
+            const Point &p = vd.vertices.coords[i];
             if (CGAL::squared_distance(p, hole_center) < threshold * threshold)
             {
                 std::cout << "[DEBUG] Voronoi vertex " << i << ": " << p << "\n";
@@ -1961,7 +2423,7 @@ void construct_voronoi_diagram(VoronoiDiagram &vd, VDC_PARAM &vdc_param, Unified
 }
 
 // ！@brief Wrap up function for constructing iso surface
-void construct_iso_surface(Delaunay &dt, VoronoiDiagram &vd, VDC_PARAM &vdc_param, IsoSurface &iso_surface, UnifiedGrid &grid, std::vector<Point> &activeCubeCenters, CGAL::Epick::Iso_cuboid_3 &bbox)
+void construct_iso_surface(Delaunay &dt, VoronoiDiagram &vd, VDC_PARAM &vdc_param, IsoSurface &iso_surface, const UnifiedGrid &grid, std::vector<Point> &activeCubeCenters, CGAL::Epick::Iso_cuboid_3 &bbox, MeshStreamWriter *stream)
 {
     if (vdc_param.multi_isov)
     {
@@ -1972,13 +2434,23 @@ void construct_iso_surface(Delaunay &dt, VoronoiDiagram &vd, VDC_PARAM &vdc_para
         Compute_Isosurface_Vertices_Single(grid, vdc_param.isovalue, iso_surface, activeCubeCenters);
     }
 
+    // Every isovertex exists before the first triangle is generated
+    if (stream)
+    {
+        stream->writeVertices(iso_surface.isosurfaceVertices);
+    }
+
     if (vdc_param.multi_isov)
     {
-        computeDualTrianglesMulti(vd, bbox, grid, vdc_param.isovalue, iso_surface);
+        computeDualTrianglesMulti(vd, vdc_param.isovalue, iso_surface, stream);
+    }
+    else if (needs_voronoi_diagram(vdc_param))
+    {
+        computeDualTriangles(iso_surface, vd, dt, vdc_param.isovalue, stream);
     }
     else
     {
-        computeDualTriangles(iso_surface, vd, bbox, dt, grid, vdc_param.isovalue);
+        computeDualTrianglesDirect(iso_surface, dt, bbox, grid, vdc_param.isovalue, vdc_param.collapse_eps, stream);
     }
 
     if (debug)
@@ -1997,11 +2469,10 @@ void construct_iso_surface(Delaunay &dt, VoronoiDiagram &vd, VDC_PARAM &vdc_para
                     int cycle_idx = idx - start;
                     std::cout << "[DEBUG] Problematic Isovertex " << idx << " in Cell " << cell_idx
                               << ", Cycle " << cycle_idx << "\n";
-                    if (cycle_idx < vc.cycles.size())
+                    if (idx < static_cast<int>(vd.cycleMidpoints.rows()))
                     {
-                        const Cycle &cycle = vc.cycles[cycle_idx];
                         std::cout << "[DEBUG] Cycle midpoints: ";
-                        for (int mid_idx : cycle.midpoint_indices)
+                        for (int mid_idx : vd.cycleMidpoints.row(idx))
                         {
                             std::cout << mid_idx << " ";
                         }
@@ -2030,56 +2501,122 @@ void construct_iso_surface(Delaunay &dt, VoronoiDiagram &vd, VDC_PARAM &vdc_para
 
 //! @brief Handles output mesh generation.
 /*!
- * Writes the final isosurface mesh to file in the specified format (OFF or PLY).
- * Supports both single and multi-isovertex modes.
+ * Writes the final isosurface mesh to file in the specified format (OFF, ASCII
+ * or binary PLY, or a raw binary dump). The mesh is the same container in
+ * single and multi-isovertex modes.
  *
  * @param retFlag Output parameter indicating success/failure
- * @param vd The Voronoi diagram
  * @param vdc_param Configuration parameters
- * @param iso_surface The isosurface to output
+ * @param mesh The mesh to output
  * @return EXIT_SUCCESS on success, EXIT_FAILURE on error
  */
-int handle_output_mesh(bool &retFlag, VoronoiDiagram &vd, VDC_PARAM &vdc_param, IsoSurface &iso_surface)
+int handle_output_mesh(bool &retFlag, VDC_PARAM &vdc_param, const IsoMesh &mesh)
 {
     retFlag = true;
 
     std::cout << "Result file at: " << vdc_param.output_filename << std::endl;
+    if (vdc_param.binary && vdc_param.output_format != "ply")
+        std::cout << "[WARNING] -binary only applies to PLY output" << std::endl;
 
-    // Multi-isovertex mode output
-    if (vdc_param.multi_isov)
+    if (vdc_param.output_format == "off")
     {
-        if (vdc_param.output_format == "off")
-        {
-            writeOFFMulti(vdc_param.output_filename, vd, iso_surface.isosurfaceTrianglesMulti, iso_surface);
-        }
-        else if (vdc_param.output_format == "ply")
-        {
-            writePLYMulti(vdc_param.output_filename, vd, iso_surface.isosurfaceTrianglesMulti, iso_surface);
-        }
+        writeOFF(vdc_param.output_filename, mesh, vdc_param.precision);
+    }
+    else if (vdc_param.output_format == "ply")
+    {
+        if (vdc_param.binary)
+            writePLYBinary(vdc_param.output_filename, mesh);
         else
-        {
-            std::cerr << "Unsupported output format: " << vdc_param.output_format << std::endl;
-            return EXIT_FAILURE;
-        }
+            writePLY(vdc_param.output_filename, mesh, vdc_param.precision);
+    }
+    else if (vdc_param.output_format == "bin")
+    {
+        writeMeshBinary(vdc_param.output_filename, mesh);
     }
-    // Single-isovertex mode output
     else
     {
-        if (vdc_param.output_format == "off")
-        {
-            writeOFFSingle(vdc_param.output_filename, iso_surface.isosurfaceVertices, iso_surface.isosurfaceTrianglesSingle);
-        }
-        else if (vdc_param.output_format == "ply")
-        {
-            writePLYSingle(vdc_param.output_filename, iso_surface.isosurfaceVertices, iso_surface.isosurfaceTrianglesSingle);
-        }
-        else
-        {
-            std::cerr << "Unsupported output format: " << vdc_param.output_format << std::endl;
-            return EXIT_FAILURE;
-        }
+        std::cerr << "Unsupported output format: " << vdc_param.output_format << std::endl;
+        return EXIT_FAILURE;
     }
 
     retFlag = false;
     return EXIT_SUCCESS;
 }
+
+//! OFF is always ASCII; PLY is unless -binary was given.
+bool is_ascii_mesh_output(const VDC_PARAM &vdc_param)
+{
+    return vdc_param.output_format == "off" || (vdc_param.output_format == "ply" && !vdc_param.binary);
+}
+
+//! @brief Opens the streaming mesh writer requested with -stream.
+/*!
+ * Streaming needs an uncompressed binary layout whose header count can be patched in
+ * place, i.e. binary PLY or the raw dump. For other formats a warning is
+ * printed and the mesh is written after extraction as usual.
+ *
+ * @param vdc_param Configuration parameters
+ * @return The open writer, or null if the output is not streamed.
+ */
+std::unique_ptr<MeshStreamWriter> open_mesh_stream(const VDC_PARAM &vdc_param)
+{
+    if (!vdc_param.stream)
+        return nullptr;
+    if (is_gzip_filename(vdc_param.output_filename))
+    {
+        std::cout << "[WARNING] -stream cannot patch a compressed file; writing after extraction" << std::endl;
+        return nullptr;
+    }
+
+    MeshStreamWriter::Format format;
+    if (vdc_param.output_format == "ply" && vdc_param.binary)
+        format = MeshStreamWriter::Format::PLYBinary;
+    else if (vdc_param.output_format == "bin")
+        format = MeshStreamWriter::Format::Raw;
+    else
+    {
+        std::cout << "[WARNING] -stream needs binary output (-ply -binary or -bin); writing after extraction" << std::endl;
+        return nullptr;
+    }
+    if (vdc_param.compact)
+        std::cout << "[WARNING] -compact is ignored when streaming" << std::endl;
+
+    auto stream = std::make_unique<MeshStreamWriter>(vdc_param.output_filename, format, vdc_param.multi_isov);
+    if (!stream->is_open())
+    {
+        std::cerr << "Cannot open file for writing: " << vdc_param.output_filename << std::endl;
+        return nullptr;
+    }
+    return stream;
+}
+
+//! @brief Writes the Voronoi diagram dump requested with -dump_vd.
+/*!
+ * "text" keeps the write_voronoiDiagram() output. "binary" writes the
+ * columnar dump of writeVoronoiDiagramBinary(), including the isovertices,
+ * next to the mesh as VoronoiDiagram_<output stem>.vdb, or ".vdb.gz" when
+ * the mesh file name ends in ".gz".
+ *
+ * @param vd The Voronoi diagram.
+ * @param iso_surface The isosurface extracted from it.
+ * @param vdc_param Configuration parameters
+ */
+void dump_voronoi_diagram(VoronoiDiagram &vd, const IsoSurface &iso_surface, VDC_PARAM &vdc_param)
+{
+    if (vdc_param.dump_vd == "text")
+    {
+        write_voronoiDiagram(vd, vdc_param.output_filename);
+    }
+    else if (vdc_param.dump_vd == "binary")
+    {
+        const bool gzip = is_gzip_filename(vdc_param.output_filename);
+        std::filesystem::path output(vdc_param.output_filename);
+        if (gzip)
+            output.replace_extension(); // Drop ".gz" so stem() stops at the mesh extension
+        std::string filename = (output.parent_path() / ("VoronoiDiagram_" + output.stem().string() + ".vdb")).string();
+        if (gzip)
+            filename += ".gz";
+        writeVoronoiDiagramBinary(filename, vd, &iso_surface);
+        std::cout << "voronoi diagram saved to " << filename << "\n";
+    }
+}
@@ -14,44 +14,61 @@
  *
  * @param iso_surface Instance of IsoSurface to store triangles.
  * @param vd Voronoi diagram containing edges and vertices
- * @param bbox Bounding box of the computational domain.
  * @param dt Delaunay triangulation structure.
- * @param grid Scalar grid containing scalar values.
  * @param isovalue The isovalue used for computing.
- * @param pointToIndexMap Map between points and their indices in Delaunay triangulation
+ * @param stream If not null, the triangles are written to it instead of being stored.
  */
 void computeDualTriangles(
     IsoSurface &iso_surface,
     VoronoiDiagram &vd,
-    CGAL::Epick::Iso_cuboid_3 &bbox,
     Delaunay &dt,
-    UnifiedGrid &grid,
     float isovalue,
-    std::map<Point, int> &pointToIndexMap);
+    MeshStreamWriter *stream = nullptr);
+
+//! @brief Computes the dual triangles of the single-isovertex case without a Voronoi diagram.
+/*!
+ * Walks the finite Delaunay facets and tests each dual edge for bipolarity
+ * using scalar values cached per Delaunay cell (at its circumcenter).
+ *
+ * @param iso_surface Instance of IsoSurface to store triangles.
+ * @param dt Delaunay triangulation structure.
+ * @param bbox Bounding box of the computational domain.
+ * @param grid Scalar grid containing scalar values.
+ * @param isovalue The isovalue used for computing.
+ * @param collapseEps Dual segments not longer than this produce no triangle.
+ * @param stream If not null, the triangles are written to it in batches instead of being stored.
+ */
+void computeDualTrianglesDirect(
+    IsoSurface &iso_surface,
+    Delaunay &dt,
+    CGAL::Epick::Iso_cuboid_3 &bbox,
+    const UnifiedGrid &grid,
+    float isovalue,
+    double collapseEps,
+    MeshStreamWriter *stream = nullptr);
 
-    
 //! @brief Computes the dual triangles for the final mesh in the multi-isovertex case.
 /*!
  * This function calculates the Delaunay triangles dual to bipolar edges in
  * the Voronoi diagram for multiple isovalues.
  *
  * @param voronoiDiagram The Voronoi diagram to compute from.
- * @param bbox Bounding box of the computational domain.
- * @param grid Scalar grid containing scalar values.
  * @param isovalue The isovalue for mesh computation.
  * @param iso_surface Instance of IsoSurface containing the isosurface vertices and faces.
+ * @param stream If not null, the triangles are written to it instead of being stored.
  */
 void computeDualTrianglesMulti(
     VoronoiDiagram &voronoiDiagram,
-    CGAL::Epick::Iso_cuboid_3 &bbox,
-    UnifiedGrid &grid,
     float isovalue,
-    IsoSurface &iso_surface);
+    IsoSurface &iso_surface,
+    MeshStreamWriter *stream = nullptr);
 
 //! @brief Computes isosurface vertices for the multi-isovertex case.
 /*!
  * Processes Voronoi cells to identify bipolar edges, form cycles, and compute
- * centroids as isosurface vertices.
+ * centroids as isosurface vertices. Replaces the isosurface vertices and
+ * VoronoiDiagram::cycles. Cells are processed in parallel; a count pass and a
+ * prefix sum preassign each cell's slots, so the output order is the serial one.
  *
  * @param voronoiDiagram The Voronoi diagram to compute vertices for.
  * @param isovalue The isovalue to use for vertex computation.
@@ -70,7 +87,7 @@ void Compute_Isosurface_Vertices_Multi(VoronoiDiagram &voronoiDiagram, float iso
  * @param data_grid The grid containing input data.
  * @param activeCubeCenters The list of center points of active cubes.
  */
-void Compute_Isosurface_Vertices_Single(UnifiedGrid &grid, float isovalue, IsoSurface &iso_surface, std::vector<Point> &activeCubeCenters);
+void Compute_Isosurface_Vertices_Single(const UnifiedGrid &grid, float isovalue, IsoSurface &iso_surface, std::vector<Point> &activeCubeCenters);
 
 //! @brief Constructs a Delaunay triangulation from a grid and grid facets.
 /*!
@@ -83,7 +100,7 @@ void Compute_Isosurface_Vertices_Single(UnifiedGrid &grid, float isovalue, IsoSu
  * @param vdc_param The VDC_PARAM instance holding user input options.
  * @param activeCubeCenters The list of center points of active cubes.
  */
-void construct_delaunay_triangulation(Delaunay &dt, UnifiedGrid &grid, const std::vector<std::vector<GRID_FACETS>> &grid_facets, VDC_PARAM &vdc_param, std::vector<Point> &activeCubeCenters);
+void construct_delaunay_triangulation(Delaunay &dt, const UnifiedGrid &grid, const std::vector<std::vector<GRID_FACETS>> &grid_facets, VDC_PARAM &vdc_param, std::vector<Point> &activeCubeCenters);
 
 //! @brief Adds dummy points from a facet for Voronoi diagram bounding.
 /*!
@@ -107,11 +124,13 @@ void construct_voronoi_vertices(VoronoiDiagram &voronoiDiagram, Delaunay &dt);
 //! @brief Constructs Voronoi cells from the Delaunay triangulation.
 /*!
  * Populates the Voronoi diagram with polyhedral cells derived from the Delaunay triangulation.
+ * Cell hulls are computed in parallel (OpenMP) on Voronoi vertex indices.
  *
  * @param voronoiDiagram The Voronoi diagram to populate with cells.
  * @param dt The Delaunay triangulation corresponding (dual) to the Voronoi diagram.
+ * @param activeEdges Optional per-edge flags; if given, only the cells around marked edges are built.
  */
-void construct_voronoi_cells_as_convex_hull(VoronoiDiagram &voronoiDiagram, Delaunay &dt);
+void construct_voronoi_cells_as_convex_hull(VoronoiDiagram &voronoiDiagram, Delaunay &dt, const std::vector<unsigned char> *activeEdges = nullptr);
 
 //! @brief Constructs Voronoi cells without using Convex_Hull_3 (in development).
 /*!
@@ -120,8 +139,9 @@ void construct_voronoi_cells_as_convex_hull(VoronoiDiagram &voronoiDiagram, Dela
  *
  * @param voronoiDiagram The Voronoi diagram to populate with cells.
  * @param dt The Delaunay triangulation corresponding (dual) to the Voronoi diagram.
+ * @param activeEdges Optional per-edge flags; if given, only the cells around marked edges are built.
  */
-void construct_voronoi_cells_from_delaunay_triangulation(VoronoiDiagram &voronoiDiagram, Delaunay &dt);
+void construct_voronoi_cells_from_delaunay_triangulation(VoronoiDiagram &voronoiDiagram, Delaunay &dt, const std::vector<unsigned char> *activeEdges = nullptr);
 
 //! @brief Computes Voronoi vertex values using scalar grid interpolation.
 /*!
@@ -130,7 +150,7 @@ void construct_voronoi_cells_from_delaunay_triangulation(VoronoiDiagram &voronoi
  * @param voronoiDiagram The Voronoi diagram to compute values for.
  * @param grid The scalar grid containing data.
  */
-void compute_voronoi_values(VoronoiDiagram &voronoiDiagram, UnifiedGrid &grid);
+void compute_voronoi_values(VoronoiDiagram &voronoiDiagram, const UnifiedGrid &grid);
 
 //! @brief Constructs Voronoi edges from Delaunay facets.
 /*!
@@ -149,24 +169,90 @@ void construct_voronoi_edges(
  * updates edge mappings.
  *
  * @param voronoiDiagram The Voronoi diagram to populate with edges.
- * @param bbox The bounding box used for clipping rays and lines.
  * @param dt The Delaunay triangulation used for edge-facet correspondence.
  */
 void construct_voronoi_cell_edges(VoronoiDiagram &voronoiDiagram,
-    CGAL::Epick::Iso_cuboid_3 &bbox,
     Delaunay &dt);
 
+//! @brief Clips every ray and line edge to the bounding box, once.
+/*!
+ * Stores the clipped part of each unbounded edge in `clippedEdges` and
+ * links it through VoronoiEdge::clipIndex, together with the Voronoi
+ * vertices found at its ends. Must run after the edges are final (after
+ * collapseSmallEdges()).
+ *
+ * @param voronoiDiagram The Voronoi diagram whose edges are clipped.
+ * @param bbox The bounding box of the domain.
+ */
+void clip_unbounded_edges(VoronoiDiagram &voronoiDiagram, const CGAL::Epick::Iso_cuboid_3 &bbox);
+
+//! @brief Computes the scalar values at the ends of the clipped edges.
+/*!
+ * Ray sources take the value of their Voronoi vertex; other ends are
+ * interpolated from the grid. Requires compute_voronoi_values().
+ *
+ * @param voronoiDiagram The Voronoi diagram with clipped edges.
+ * @param grid The scalar grid.
+ */
+void compute_clipped_edge_values(VoronoiDiagram &voronoiDiagram, const UnifiedGrid &grid);
+
 //! @brief Handles output mesh generation.
 /*!
- * Generates the final output mesh based on the Voronoi diagram and handles file output.
+ * Writes the final isosurface mesh to file. The mesh is self-contained, so the
+ * triangulation and the Voronoi diagram may already have been released.
  *
  * @param retFlag Reference to a flag indicating success or failure.
- * @param vd The Voronoi diagram containing mesh data.
  * @param vdc_param The VDC_PARAM instance containing user input options.
- * @param iso_surface The instance of IsoSurface containing the vertices and faces of the isosurface.
+ * @param mesh The output mesh (see build_iso_mesh()).
  * @return An integer representing the exit status.
  */
-int handle_output_mesh(bool &retFlag, VoronoiDiagram &vd, VDC_PARAM &vdc_param, IsoSurface &iso_surface);
+int handle_output_mesh(bool &retFlag, VDC_PARAM &vdc_param, const IsoMesh &mesh);
+
+//! @brief Whether the output mesh is written as ASCII text (OFF, or PLY without -binary).
+/*!
+ * ASCII output prints the double-precision positions, so the mesh has to be
+ * built with them kept (see build_iso_mesh()).
+ *
+ * @param vdc_param The VDC_PARAM instance containing user input options.
+ * @return True if handle_output_mesh() writes an ASCII file.
+ */
+bool is_ascii_mesh_output(const VDC_PARAM &vdc_param);
+
+//! @brief Opens the streaming mesh writer if -stream was given.
+/*!
+ * With a stream, the triangles go to the output file while they are
+ * generated (see construct_iso_surface()) instead of through handle_output_mesh().
+ *
+ * @param vdc_param The VDC_PARAM instance containing user input options.
+ * @return The open writer, or null if the output is not streamed.
+ */
+std::unique_ptr<MeshStreamWriter> open_mesh_stream(const VDC_PARAM &vdc_param);
+
+//! @brief Dumps the Voronoi diagram as text or binary if -dump_vd was given.
+/*!
+ * @param vd The Voronoi diagram.
+ * @param iso_surface The isosurface; its vertices are included in the binary dump.
+ * @param vdc_param The VDC_PARAM instance containing user input options.
+ */
+void dump_voronoi_diagram(VoronoiDiagram &vd, const IsoSurface &iso_surface, VDC_PARAM &vdc_param);
+
+//! @brief Whether the pipeline needs an explicit VoronoiDiagram.
+/*!
+ * Single-isovertex mode skips the diagram unless it is requested, exported or dumped.
+ *
+ * @param vdc_param The VDC_PARAM instance containing user input options.
+ * @return True if construct_voronoi_diagram() has to run.
+ */
+bool needs_voronoi_diagram(const VDC_PARAM &vdc_param);
+
+//! @brief Whether the Voronoi diagram has to contain every cell.
+/*!
+ * Multi-isovertex mode otherwise builds only the cells around bipolar edges.
+ *
+ * @param vdc_param The VDC_PARAM instance containing user input options.
+ * @return True for -full_vor, --test_vor, -out_csv and -dump_vd.
+ */
+bool needs_full_voronoi_diagram(const VDC_PARAM &vdc_param);
 
 //! @brief Wraps up the process of building the Voronoi diagram from the Delaunay triangulation.
 /*!
@@ -178,7 +264,17 @@ int handle_output_mesh(bool &retFlag, VoronoiDiagram &vd, VDC_PARAM &vdc_param,
  * @param bbox Bounding box of the computational domain.
  * @param dt The Delaunay triangulation.
  */
-void construct_voronoi_diagram(VoronoiDiagram &vd, VDC_PARAM &vdc_param, UnifiedGrid &grid, CGAL::Epick::Iso_cuboid_3 &bbox, Delaunay &dt);
+void construct_voronoi_diagram(VoronoiDiagram &vd, VDC_PARAM &vdc_param, const UnifiedGrid &grid, CGAL::Epick::Iso_cuboid_3 &bbox, Delaunay &dt);
+
+//! @brief Runs the Voronoi diagram checks selected with -validate.
+/*!
+ * Prints the validation report and throws if a check failed. Also run on a
+ * diagram restored from a checkpoint.
+ *
+ * @param vd The Voronoi diagram to check.
+ * @param vdc_param The VDC_PARAM instance containing user input options.
+ */
+void validate_voronoi_diagram(VoronoiDiagram &vd, const VDC_PARAM &vdc_param);
 
 //! @brief Wraps up the process of building the isosurface from the Voronoi diagram/Delaunay triangulation.
 /*!
@@ -192,8 +288,9 @@ void construct_voronoi_diagram(VoronoiDiagram &vd, VDC_PARAM &vdc_param, Unified
  * @param data_grid Input data grid for single-isovertex mode
  * @param activeCubeCenters Active cube centers for single-isovertex mode
  * @param bbox Bounding box for clipping infinite edges
+ * @param stream If not null, receives the isovertices and then the triangles as they are generated; the triangles are not stored in iso_surface
  */
-void construct_iso_surface(Delaunay &dt, VoronoiDiagram &vd, VDC_PARAM &vdc_param, IsoSurface &iso_surface, UnifiedGrid &grid, std::vector<Point> &activeCubeCenters, CGAL::Epick::Iso_cuboid_3 &bbox);
+void construct_iso_surface(Delaunay &dt, VoronoiDiagram &vd, VDC_PARAM &vdc_param, IsoSurface &iso_surface, const UnifiedGrid &grid, std::vector<Point> &activeCubeCenters, CGAL::Epick::Iso_cuboid_3 &bbox, MeshStreamWriter *stream = nullptr);
 
 
 // Helper function declarations (internal linkage)
@@ -217,13 +314,15 @@ static void generateTriangle(const Point &p1, const Point &p2, const Point &p3,
  * Delaunay facet.
  *
  * @param edge Voronoi edge to process
+ * @param dualFacets The Delaunay facets dual to the edge.
  * @param vd Voronoi diagram containing edge data
  * @param isovalue The isovalue for bipolarity check
  * @param dt Delaunay triangulation for facet lookup
  * @param dualTriangles Output vector for generated triangles
  */
 static void processSegmentEdge(
-    VoronoiEdge &edge,
+    const VoronoiEdge &edge,
+    CsrSpan<const Facet> dualFacets,
     VoronoiDiagram &vd,
     float isovalue,
     Delaunay &dt,
@@ -231,46 +330,41 @@ static void processSegmentEdge(
 
 //! @brief Processes a ray edge for dual triangle computation.
 /*!
- * Intersects the ray with the bounding box, checks bipolarity, and generates
+ * Uses the cached clipped part of the ray, checks bipolarity, and generates
  * triangles for associated Delaunay facets.
  *
- * @param ray The ray edge to process.
- * @param edge The CGAL object representing the edge.
- * @param bbox The bounding box for intersection.
- * @param grid The scalar grid for interpolation.
+ * @param edge The Voronoi ray edge to process.
+ * @param dualFacets The Delaunay facets dual to the edge.
+ * @param vd The Voronoi Diagram.
  * @param isovalue The isovalue for bipolarity check.
  * @param dt The Delaunay triangulation.
  * @param dualTriangles Vector to store generated triangles.
  */
 static void processRayEdge(
-    const Ray3 &ray,
-    VoronoiEdge &edge,
+    const VoronoiEdge &edge,
+    CsrSpan<const Facet> dualFacets,
     VoronoiDiagram &vd,
-    CGAL::Epick::Iso_cuboid_3 &bbox,
-    UnifiedGrid &grid,
     float isovalue,
     Delaunay &dt,
     std::vector<DelaunayTriangle> &dualTriangles);
 
 //! @brief Processes a line edge for dual triangle computation.
 /*!
- * Intersects the line with the bounding box, checks bipolarity, and generates
+ * Uses the cached clipped part of the line, checks bipolarity, and generates
  * triangles for associated Delaunay facets.
  *
- * @param line The line edge to process.
- * @param edge The CGAL object representing the edge.
- * @param grid The scalar grid for interpolation.
+ * @param edge The Voronoi line edge to process.
+ * @param dualFacets The Delaunay facets dual to the edge.
+ * @param vd The Voronoi Diagram.
  * @param isovalue The isovalue for bipolarity check.
- * @param bbox The bounding box for intersection.
  * @param dt The Delaunay triangulation.
  * @param dualTriangles Vector to store generated triangles.
  */
 static void processLineEdge(
-    const Line3 &line,
-    VoronoiEdge &edge,
-    UnifiedGrid &grid,
+    const VoronoiEdge &edge,
+    CsrSpan<const Facet> dualFacets,
+    VoronoiDiagram &vd,
     float isovalue,
-    CGAL::Epick::Iso_cuboid_3 &bbox,
     Delaunay &dt,
     std::vector<DelaunayTriangle> &dualTriangles);
 
@@ -279,14 +373,20 @@ static void processLineEdge(
  * Adds a triangle to the isosurface's triangle list, adjusting vertex order based
  * on orientation, and logs problematic triangles if invalid.
  *
- * @param iso_surface The isosurface to store the triangle.
+ * @param triangles Vector to store the triangle.
  * @param idx1 First vertex index.
  * @param idx2 Second vertex index.
  * @param idx3 Third vertex index.
  * @param iOrient Orientation value determining vertex order.
  * @param isValid Flag indicating if the triangle is valid.
  */
-static void generateTriangleMulti(IsoSurface &iso_surface, int idx1, int idx2, int idx3, int iOrient, bool isValid);
+static void generateTriangleMulti(std::vector<std::tuple<int, int, int>> &triangles, int idx1, int idx2, int idx3, int iOrient, bool isValid);
+
+//! @brief Appends the three vertex indices of a single-isovertex triangle.
+static void appendTriangleIndices(const DelaunayTriangle &triangle, std::vector<std::uint32_t> &indices);
+
+//! @brief Appends the three vertex indices of a multi-isovertex triangle.
+static void appendTriangleIndices(const std::tuple<int, int, int> &triangle, std::vector<std::uint32_t> &indices);
 
 //! @brief Selects isovertices for a Delaunay facet.
 /*!
@@ -312,60 +412,54 @@ static bool selectIsovertices(const VoronoiDiagram &voronoiDiagram, const Facet
  * Delaunay facets in multi-isovertex mode.
  *
  * @param edge Voronoi edge to process
+ * @param dualFacets The Delaunay facets dual to the edge.
  * @param voronoiDiagram Voronoi diagram containing edge and cell data
  * @param isovalue The isovalue for bipolarity check
- * @param iso_surface The isosurface to store triangles
+ * @param triangles Vector to store generated triangles
  */
 static void processSegmentEdgeMulti(
-    VoronoiEdge edge,
-    VoronoiDiagram &voronoiDiagram,
+    const VoronoiEdge &edge,
+    CsrSpan<const Facet> dualFacets,
+    const VoronoiDiagram &voronoiDiagram,
     float isovalue,
-    IsoSurface &iso_surface);
+    std::vector<std::tuple<int, int, int>> &triangles);
 
 //! @brief Processes a ray edge for multi-isovertex triangle computation.
 /*!
- * Intersects the ray with the bounding box, checks bipolarity, and generates
+ * Uses the cached clipped part of the ray, checks bipolarity, and generates
  * triangles using the first isovertex from each cell.
  *
- * @param ray The ray edge to process
- * @param dualDelaunayFacets List of Delaunay facets dual to this edge
+ * @param edge The Voronoi ray edge to process
+ * @param dualFacets The Delaunay facets dual to the edge.
  * @param voronoiDiagram The Voronoi diagram containing edge and cell data
- * @param grid The scalar grid for interpolation
  * @param isovalue The isovalue for bipolarity check
- * @param bbox The bounding box for intersection
- * @param iso_surface The isosurface to store triangles
+ * @param triangles Vector to store generated triangles
  */
 static void processRayEdgeMulti(
-    const Ray3 &ray,
-    std::vector<Facet> dualDelaunayFacets,
-    VoronoiDiagram &voronoiDiagram,
-    UnifiedGrid &grid,
+    const VoronoiEdge &edge,
+    CsrSpan<const Facet> dualFacets,
+    const VoronoiDiagram &voronoiDiagram,
     float isovalue,
-    CGAL::Epick::Iso_cuboid_3 &bbox,
-    IsoSurface &iso_surface);
+    std::vector<std::tuple<int, int, int>> &triangles);
 
 
 //! @brief Processes a line edge for multi-isovertex triangle computation.
 /*!
- * Intersects the line with the bounding box, checks bipolarity, and generates
+ * Uses the cached clipped part of the line, checks bipolarity, and generates
  * triangles using the first isovertex from each cell.
  *
- * @param line The line edge to process
- * @param dualDelaunayFacets List of Delaunay facets dual to this edge
+ * @param edge The Voronoi line edge to process
+ * @param dualFacets The Delaunay facets dual to the edge.
  * @param voronoiDiagram The Voronoi diagram containing edge and cell data
- * @param grid The scalar grid for interpolation
  * @param isovalue The isovalue for bipolarity check
- * @param bbox The bounding box for intersection
- * @param iso_surface The isosurface to store triangles
+ * @param triangles Vector to store generated triangles
  */
 static void processLineEdgeMulti(
-    const Line3 &line,
-    std::vector<Facet> dualDelaunayFacets,
-    VoronoiDiagram &voronoiDiagram,
-    UnifiedGrid &grid,
+    const VoronoiEdge &edge,
+    CsrSpan<const Facet> dualFacets,
+    const VoronoiDiagram &voronoiDiagram,
     float isovalue,
-    CGAL::Epick::Iso_cuboid_3 &bbox,
-    IsoSurface &iso_surface);
+    std::vector<std::tuple<int, int, int>> &triangles);
 
 //! @brief Collects midpoints for bipolar edges in a Voronoi cell's facets.
 /*!
@@ -375,47 +469,61 @@ static void processLineEdgeMulti(
  * @param vc The Voronoi cell to process.
  * @param voronoiDiagram The Voronoi diagram containing facet and vertex data.
  * @param isovalue The isovalue for bipolarity check.
- * @param midpoints Vector to store computed midpoints.
- * @param edge_to_midpoint_index Map linking edge keys to midpoint indices.
- * @param facet_midpoint_indices Vector storing midpoint indices for each facet.
+ * @param scratch Cleared scratch; receives the midpoints and one row of midpoint indices per facet.
  */
-static void collectMidpoints(VoronoiCell &vc, VoronoiDiagram &voronoiDiagram, float isovalue, std::vector<MidpointNode> &midpoints, std::map<std::pair<int, int>, int> &edge_to_midpoint_index, std::vector<std::vector<int>> &facet_midpoint_indices);
+static void collectMidpoints(const VoronoiCell &vc, const VoronoiDiagram &voronoiDiagram, float isovalue, CycleScratch &scratch);
 
 //! @brief Connects midpoints within each facet to form a graph.
 /*!
  * Links pairs of midpoints in each facet to establish connectivity for cycle detection.
  *
- * @param facet_midpoint_indices Vector storing midpoint indices for each facet.
- * @param midpoints Vector of midpoints to update with connectivity.
+ * @param scratch Scratch holding the midpoints and their facet rows.
  */
-static void connectMidpoints(const std::vector<std::vector<int>> &facet_midpoint_indices, std::vector<MidpointNode> &midpoints);
+static void connectMidpoints(CycleScratch &scratch);
 
 //! @brief Extracts cycles from the midpoint connectivity graph.
 /*!
  * Uses depth-first search to identify closed cycles in the midpoint graph.
  *
- * @param midpoints Vector of midpoints with connectivity information.
- * @param cycles Vector to store the extracted cycles as lists of midpoint indices.
+ * @param scratch Scratch holding the connected midpoints; receives one row of
+ *                CycleScratch::cycles per cycle.
  */
-static void extractCycles(const std::vector<MidpointNode> &midpoints, std::vector<std::vector<int>> &cycles);
+static void extractCycles(CycleScratch &scratch);
 
-//! @brief Computes centroids for cycles and updates the isosurface.
+//! @brief Builds the midpoint graph of a cell and extracts its cycles.
 /*!
- * Calculates the centroid for each cycle, updates the Voronoi cell's cycles,
- * and adds the centroid to the isosurface vertices.
- *
- * @param vc The Voronoi cell to update.
- * @param voronoiDiagram The Voronoi diagram for edge lookup.
- * @param midpoints Vector of midpoints used for centroid computation.
- * @param cycles Vector of cycles as lists of midpoint indices.
- * @param iso_surface The isosurface to store vertices.
+ * @param vc The Voronoi cell to process.
+ * @param voronoiDiagram The Voronoi diagram containing facet, vertex and cell edge data.
+ * @param isovalue The isovalue for bipolarity check.
+ * @param scratch Scratch of the calling thread; cleared first. Receives the cycles and
+ *                the sorted (cell edge, cycle) pairs of the cell.
+ */
+static void extractCellCycles(const VoronoiCell &vc, const VoronoiDiagram &voronoiDiagram, float isovalue, CycleScratch &scratch);
+
+//! @brief Computes centroids for cycles and stores them in their preassigned slots.
+/*!
+ * @param vc The Voronoi cell, with its isovertex range already assigned.
+ * @param voronoiDiagram The Voronoi diagram holding the sized cycle arrays.
+ * @param scratch Scratch holding the midpoints and the extracted cycles of the cell.
+ * @param midpointStart Position of the cell's first midpoint in cycleMidpoints.
+ * @param iso_surface The isosurface, with its vertex array already sized.
+ */
+static void computeCycleCentroids(const VoronoiCell &vc, VoronoiDiagram &voronoiDiagram, const CycleScratch &scratch, int midpointStart, IsoSurface &iso_surface);
+
+//! @brief Collects the sorted, unique Voronoi cells around the dual facets of an edge.
+/*!
+ * @param dualFacets The Delaunay facets dual to the Voronoi edge.
+ * @param dt The Delaunay triangulation.
+ * @param cellIndices Output cell indices; cleared first.
  */
-static void computeCycleCentroids(VoronoiCell &vc, VoronoiDiagram &voronoiDiagram, std::vector<MidpointNode> &midpoints, const std::vector<std::vector<int>> &cycles, IsoSurface &iso_surface);
+static void collectEdgeCells(CsrSpan<const Facet> dualFacets, Delaunay &dt, std::vector<int> &cellIndices);
 
 //! @brief Builds Voronoi cell edges for each edge in the diagram.
 /*!
  * Creates VoronoiCellEdge entries for cells sharing each edge, collecting cell indices
- * from associated Delaunay facets.
+ * from associated Delaunay facets. The cells of each edge are counted in a first
+ * parallel pass and written in a second one, so cell edges come out grouped by
+ * edge index without any per-edge containers.
  *
  * @param voronoiDiagram The Voronoi diagram to populate with cell edges.
  * @param dt The Delaunay triangulation.
@@ -425,7 +533,8 @@ static void buildCellEdges(VoronoiDiagram &voronoiDiagram, Delaunay &dt);
 //! @brief Links Voronoi cell edges in a circular ring.
 /*!
  * Connects cell edges sharing the same edge index using the nextCellEdge field
- * to form a closed loop.
+ * to form a closed loop. Relies on buildCellEdges emitting cell edges grouped
+ * by edge index.
  *
  * @param voronoiDiagram The Voronoi diagram containing cell edges to link.
  */
@@ -433,24 +542,22 @@ static void linkCellEdges(VoronoiDiagram &voronoiDiagram);
 
 //! @brief Processes edge mapping for a single Voronoi edge.
 /*!
- * Updates the segmentVertexPairToEdgeIndex map for segments, rays, and lines
- * after intersecting with the bounding box.
+ * Updates the segmentVertexPairToEdgeIndex map for segments, and for rays
+ * and lines whose cached clipped ends are Voronoi vertices.
  *
  * @param voronoiDiagram The Voronoi diagram to update.
  * @param edge The VoronoiEdge representing the edge.
  * @param edgeIdx The index of the edge in the diagram.
- * @param bbox The bounding box for intersection.
  */
-static void processEdgeMapping(VoronoiDiagram &voronoiDiagram, VoronoiEdge &edge, int edgeIdx, CGAL::Epick::Iso_cuboid_3 &bbox);
+static void processEdgeMapping(VoronoiDiagram &voronoiDiagram, const VoronoiEdge &edge, int edgeIdx);
 
 //! @brief Updates edge mappings for all Voronoi edges.
 /*!
- * Processes all edges to update segmentVertexPairToEdgeIndex and cellEdgeLookup maps.
+ * Processes all edges to update the segmentVertexPairToEdgeIndex table and rebuilds cellEdgeLookup.
  *
  * @param voronoiDiagram The Voronoi diagram to update.
- * @param bbox The bounding box for intersection.
  */
-static void updateEdgeMappings(VoronoiDiagram &voronoiDiagram, CGAL::Epick::Iso_cuboid_3 &bbox);
+static void updateEdgeMappings(VoronoiDiagram &voronoiDiagram);
 
 //! @brief Creates a Voronoi cell for a Delaunay vertex.
 /*!
@@ -474,31 +581,44 @@ static VoronoiCell createVoronoiCell(Vertex_handle delaunay_vertex, int cellInde
  */
 static void collectCellVertices(Delaunay &dt, Vertex_handle delaunay_vertex, VoronoiDiagram &voronoiDiagram, std::vector<int> &vertices_indices);
 
-//! @brief Builds a facet from an incident edge using cell circulators.
+//! @brief Builds the facet dual to a Delaunay edge using a cell circulator.
 /*!
- * Constructs a Voronoi facet by collecting vertices around an incident edge,
- * ordering them cyclically, and assigning scalar values.
+ * Collects the Voronoi vertices around the edge, orders them cyclically and
+ * orients them outward with respect to `delaunay_vertex`.
  *
  * @param dt The Delaunay triangulation.
- * @param ed The incident edge to process.
- * @param delaunay_vertex The Delaunay vertex associated with the cell.
- * @param voronoiDiagram The Voronoi diagram containing vertex and value data.
- * @param facet_indices Vector to store the facet index.
- * @param edge_to_facets Map tracking which facets share each edge.
- * @return The constructed Voronoi facet, or an empty facet if invalid.
+ * @param ed The Delaunay edge to process.
+ * @param delaunay_vertex The endpoint of `ed` the facet is oriented away from.
+ * @param voronoiDiagram The Voronoi diagram containing vertex data.
+ * @param facetVertices Output cyclic list of Voronoi vertex indices.
+ * @return true if a valid facet was built.
  */
-static VoronoiCellFacet buildFacetFromEdge(Delaunay &dt, const Edge &ed, Vertex_handle delaunay_vertex, VoronoiDiagram &voronoiDiagram, std::vector<int> &facet_indices, std::map<std::pair<int, int>, std::vector<int>>& edge_to_facets);
-//! @brief Processes incident edges to build facets for a Voronoi cell.
+static bool buildFacetFromEdge(Delaunay &dt, const Edge &ed, Vertex_handle delaunay_vertex, VoronoiDiagram &voronoiDiagram, std::vector<int> &facetVertices);
+
+//! @brief Removes Voronoi cells with fewer than 4 facets and renumbers the rest.
 /*!
- * Iterates over incident edges to construct facets and add them to the cell.
- *
+ * @param voronoiDiagram The Voronoi diagram whose cells are compacted.
+ */
+static void compactVoronoiCells(VoronoiDiagram &voronoiDiagram);
+
+//! @brief Selects the Delaunay vertices whose Voronoi cells are built.
+/*!
+ * @param voronoiDiagram The Voronoi diagram holding the edge-facet relation.
  * @param dt The Delaunay triangulation.
- * @param delaunay_vertex The Delaunay vertex to process.
- * @param voronoiDiagram The Voronoi diagram to update.
- * @param vc The Voronoi cell to populate with facets.
- * @param edge_to_facets Map tracking which facets share each edge.
+ * @param activeEdges Optional per-edge flags (nonzero = build the cells around the edge).
+ * @param sites Output Delaunay vertices, one per cell to build.
  */
-static void processIncidentEdges(Delaunay &dt, Vertex_handle delaunay_vertex, VoronoiDiagram &voronoiDiagram, VoronoiCell &vc, std::map<std::pair<int, int>, std::vector<int>>& edge_to_facets);
+static void collectCellSites(const VoronoiDiagram &voronoiDiagram, Delaunay &dt, const std::vector<unsigned char> *activeEdges, std::vector<Vertex_handle> &sites);
+
+//! @brief Marks the Voronoi edges that cross the isosurface.
+/*!
+ * @param voronoiDiagram The Voronoi diagram, with vertex values and clipped edges computed.
+ * @param isovalue The isovalue.
+ * @param bipolarEdges Output per-edge flags (1 = bipolar).
+ * @return Number of bipolar edges.
+ */
+static int markBipolarEdges(const VoronoiDiagram &voronoiDiagram, float isovalue, std::vector<unsigned char> &bipolarEdges);
+
 //! @brief Collects points for the Delaunay triangulation.
 /*!
  * Gathers original points and dummy points from grid facets for multi-isovertex mode,
@@ -511,7 +631,7 @@ static void processIncidentEdges(Delaunay &dt, Vertex_handle delaunay_vertex, Vo
  * @param delaunay_points Output vector for all points (original + dummy).
  * @param dummy_points Output vector for dummy points.
  */
-static void collectDelaunayPoints(UnifiedGrid &grid,
+static void collectDelaunayPoints(const UnifiedGrid &grid,
                                   const std::vector<std::vector<GRID_FACETS>> &grid_facets,
                                   const std::vector<Point> &activeCubeCenters,
                                   VDC_PARAM &vdc_param,
@@ -563,8 +683,8 @@ static inline int selectIsovertexFromCellEdge(const VoronoiDiagram &voronoiDiagr
  * @param indices The vertex indices to sort.
  * @param p0 The first point of the Delaunay edge.
  * @param p1 The second point of the Delaunay edge.
- * @param vertices The Voronoi vertices containing position data.
+ * @param vertexCoords The Voronoi vertex coordinates.
  */
-static void orderFacetVertices(std::vector<int> &indices, const Point &p0, const Point &p1, const std::vector<VoronoiVertex> &vertices);
+static void orderFacetVertices(std::vector<int> &indices, const Point &p0, const Point &p1, const std::vector<Point> &vertexCoords);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,146 @@
+//! @file vdc_hash.h
+//! @brief Open-addressing hash table keyed by unordered pairs of vertex indices.
+
+#ifndef VDC_HASH_H
+#define VDC_HASH_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+//! @brief Maps an unordered pair of non-negative indices to a non-negative int.
+/*!
+ * The pair is packed into one 64-bit key (smaller index in the high word) and
+ * stored with linear probing in a power-of-two table kept at most half full.
+ * Entries cannot be erased; clear() drops them all.
+ */
+class VertexPairMap
+{
+public:
+    VertexPairMap() = default;
+
+    //! @brief Packs an unordered pair of indices into a 64-bit key.
+    static std::uint64_t packKey(int v1, int v2)
+    {
+        if (v1 > v2)
+            std::swap(v1, v2);
+        return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(v1)) << 32) | static_cast<std::uint32_t>(v2);
+    }
+
+    //! @brief Value stored for the pair (v1, v2), or -1 if absent.
+    int find(int v1, int v2) const
+    {
+        if (count == 0)
+            return -1;
+        const std::uint64_t key = packKey(v1, v2);
+        for (std::size_t slot = hashKey(key) & mask;; slot = (slot + 1) & mask)
+        {
+            if (keys[slot] == key)
+                return values[slot];
+            if (keys[slot] == emptyKey)
+                return -1;
+        }
+    }
+
+    //! @brief Stores `value` for the pair (v1, v2), replacing any previous value.
+    void set(int v1, int v2, int value)
+    {
+        if (2 * (count + 1) > keys.size())
+            rehash(std::max<std::size_t>(16, 2 * keys.size()));
+        const std::uint64_t key = packKey(v1, v2);
+        std::size_t slot = hashKey(key) & mask;
+        while (keys[slot] != emptyKey && keys[slot] != key)
+            slot = (slot + 1) & mask;
+        if (keys[slot] == emptyKey)
+        {
+            keys[slot] = key;
+            ++count;
+        }
+        values[slot] = value;
+    }
+
+    //! @brief Number of stored pairs.
+    std::size_t size() const { return count; }
+
+    //! @brief True if no pair is stored.
+    bool empty() const { return count == 0; }
+
+    //! @brief Removes all pairs; the table keeps its capacity.
+    void clear()
+    {
+        if (count == 0)
+            return;
+        std::fill(keys.begin(), keys.end(), emptyKey);
+        count = 0;
+    }
+
+    //! @brief Sizes the table to hold `n` pairs without rehashing.
+    void reserve(std::size_t n)
+    {
+        std::size_t capacity = 16;
+        while (capacity < 2 * n)
+            capacity *= 2;
+        if (capacity > keys.size())
+            rehash(capacity);
+    }
+
+    //! @brief Calls `f(v1, v2, value)` for every stored pair, in table order (v1 < v2).
+    template <typename F>
+    void forEach(F f) const
+    {
+        for (std::size_t slot = 0; slot < keys.size(); ++slot)
+        {
+            if (keys[slot] != emptyKey)
+                f(static_cast<int>(keys[slot] >> 32), static_cast<int>(keys[slot] & 0xffffffffu), values[slot]);
+        }
+    }
+
+    //! @brief Approximate heap footprint in bytes.
+    std::size_t bytes() const
+    {
+        return keys.capacity() * sizeof(std::uint64_t) + values.capacity() * sizeof(int);
+    }
+
+private:
+    static constexpr std::uint64_t emptyKey = ~std::uint64_t(0); //!< Marks a free slot
+
+    //! @brief 64-bit finalizer (splitmix64) spreading packed keys over the table.
+    static std::size_t hashKey(std::uint64_t key)
+    {
+        key ^= key >> 30;
+        key *= 0xbf58476d1ce4e5b9ULL;
+        key ^= key >> 27;
+        key *= 0x94d049bb133111ebULL;
+        key ^= key >> 31;
+        return static_cast<std::size_t>(key);
+    }
+
+    //! @brief Moves all pairs into a table of `capacity` slots (a power of two).
+    void rehash(std::size_t capacity)
+    {
+        std::vector<std::uint64_t> oldKeys(capacity, emptyKey);
+        std::vector<int> oldValues(capacity, -1);
+        oldKeys.swap(keys);
+        oldValues.swap(values);
+        mask = capacity - 1;
+        for (std::size_t i = 0; i < oldKeys.size(); ++i)
+        {
+            if (oldKeys[i] == emptyKey)
+                continue;
+            std::size_t slot = hashKey(oldKeys[i]) & mask;
+            while (keys[slot] != emptyKey)
+                slot = (slot + 1) & mask;
+            keys[slot] = oldKeys[i];
+            values[slot] = oldValues[i];
+        }
+    }
+
+    std::vector<std::uint64_t> keys; //!< Packed keys, emptyKey for free slots
+    std::vector<int> values;         //!< Value of each occupied slot
+    std::size_t mask = 0;            //!< Table size minus one
+    std::size_t count = 0;           //!< Number of occupied slots
+};
+
+#endif // VDC_HASH_H
@@ -1,192 +1,778 @@
 #include "vdc_io.h"
+#include <charconv>
+#include <sstream>
+#include <zlib.h>
 
-//! Writes a single-isovalue isosurface mesh in OFF format.
-void writeOFFSingle(const std::string &filename, const std::vector<Point> &vertices, const std::vector<DelaunayTriangle> &triangles)
+//! Uses floating-point to_chars where the standard library provides it.
+char *formatDouble(char *p, double value, int precision)
 {
-    std::ofstream out(filename);
-    if (!out)
+#if defined(__cpp_lib_to_chars)
+    if (precision < 0)
+        return std::to_chars(p, p + 32, value).ptr;
+    return std::to_chars(p, p + 32, value, std::chars_format::general, precision).ptr;
+#else
+    // Without floating-point to_chars, seventeen digits still round-trip a double
+    return p + std::snprintf(p, 32, "%.*g", precision < 0 ? 17 : precision, value);
+#endif
+}
+
+//! @brief Name of the PLY face index list: the original writers used `vertex_index` for single-isovertex meshes.
+static const char *plyFaceProperty(bool multi_isov)
+{
+    return multi_isov ? "vertex_indices" : "vertex_index";
+}
+
+//! @brief Appends an unsigned integer in decimal.
+static char *formatIndex(char *p, std::uint32_t value)
+{
+    return std::to_chars(p, p + 16, value).ptr;
+}
+
+//! @brief Writes the vertex and face lines shared by the ASCII OFF and PLY formats.
+/*!
+ * Lines are formatted in chunks. A batch of chunks is formatted in parallel,
+ * each chunk into its own reused buffer, and the buffers are then written in
+ * chunk order with one write each, so the output does not depend on the
+ * number of threads.
+ *
+ * @param out The output file, positioned after the header.
+ * @param mesh The mesh to write; its double positions are used when it kept them.
+ * @param precision Significant digits per coordinate, or negative for the shortest round-trip form.
+ */
+static void writeAsciiMeshBody(BufferedFileWriter &out, const IsoMesh &mesh, int precision)
+{
+    const long long linesPerChunk = 1 << 16;
+    const int chunksPerBatch = 64;
+    const size_t vertexLineBytes = 3 * 32 + 3;
+    const size_t faceLineBytes = 2 + 3 * 16 + 3;
+
+    const long long numVerts = static_cast<long long>(mesh.numVertices());
+    const long long numFaces = static_cast<long long>(mesh.numTriangles());
+    const long long vertexChunks = (numVerts + linesPerChunk - 1) / linesPerChunk;
+    const bool exact = mesh.exact.size() == 3 * mesh.numVertices();
+    const long long totalChunks = vertexChunks + (numFaces + linesPerChunk - 1) / linesPerChunk;
+
+    std::vector<std::vector<char>> chunkText(chunksPerBatch);
+    std::vector<size_t> chunkBytes(chunksPerBatch);
+
+    for (long long batchStart = 0; batchStart < totalChunks; batchStart += chunksPerBatch)
+    {
+        const int batchSize = static_cast<int>(std::min<long long>(chunksPerBatch, totalChunks - batchStart));
+
+#pragma omp parallel for schedule(dynamic, 1)
+        for (int c = 0; c < batchSize; ++c)
+        {
+            const long long chunk = batchStart + c;
+            std::vector<char> &text = chunkText[c];
+            char *p;
+            if (chunk < vertexChunks)
+            {
+                const long long first = chunk * linesPerChunk;
+                const long long last = std::min(numVerts, first + linesPerChunk);
+                text.resize((last - first) * vertexLineBytes);
+                p = text.data();
+                for (long long i = first; i < last; ++i)
+                {
+                    p = formatDouble(p, exact ? mesh.exact[3 * i] : mesh.x[i], precision);
+                    *p++ = ' ';
+                    p = formatDouble(p, exact ? mesh.exact[3 * i + 1] : mesh.y[i], precision);
+                    *p++ = ' ';
+                    p = formatDouble(p, exact ? mesh.exact[3 * i + 2] : mesh.z[i], precision);
+                    *p++ = '\n';
+                }
+            }
+            else
+            {
+                const long long first = (chunk - vertexChunks) * linesPerChunk;
+                const long long last = std::min(numFaces, first + linesPerChunk);
+                text.resize((last - first) * faceLineBytes);
+                p = text.data();
+                for (long long t = first; t < last; ++t)
+                {
+                    *p++ = '3';
+                    for (int k = 0; k < 3; ++k)
+                    {
+                        *p++ = ' ';
+                        p = formatIndex(p, mesh.indices[3 * t + k]);
+                    }
+                    *p++ = '\n';
+                }
+            }
+            chunkBytes[c] = static_cast<size_t>(p - text.data());
+        }
+
+        for (int c = 0; c < batchSize; ++c)
+            out.write(chunkText[c].data(), chunkBytes[c]);
+    }
+}
+
+//! Writes an isosurface mesh in OFF format.
+void writeOFF(const std::string &filename, const IsoMesh &mesh, int precision)
+{
+    BufferedFileWriter out(filename);
+    if (!out.is_open())
     {
         std::cerr << "Cannot open file for writing: " << filename << std::endl;
         return;
     }
 
-    // Write the header
-    out << "OFF\n";
-    out << vertices.size() << " " << triangles.size() << " 0\n";
+    // Header
+    out.write("OFF\n");
+    out.write(std::to_string(mesh.numVertices()) + " " + std::to_string(mesh.numTriangles()) + " 0\n");
+
+    writeAsciiMeshBody(out, mesh, precision);
+
+    if (!out.close())
+        std::cerr << "Error while writing file: " << filename << std::endl;
+}
 
-    // Write the vertices
-    for (const auto &vertex : vertices)
+//! Writes an isosurface mesh in PLY format.
+void writePLY(const std::string &filename, const IsoMesh &mesh, int precision)
+{
+    BufferedFileWriter out(filename);
+    if (!out.is_open())
     {
-        out << vertex.x() << " " << vertex.y() << " " << vertex.z() << "\n";
+        std::cerr << "Cannot open file for writing: " << filename << std::endl;
+        return;
     }
 
-    // Write the faces
-    for (const auto &triangle : triangles)
+    // Write PLY header
+    std::ostringstream header;
+    header << "ply\n";
+    header << "format ascii 1.0\n";
+    header << "element vertex " << mesh.numVertices() << "\n";
+    header << "property float x\n";
+    header << "property float y\n";
+    header << "property float z\n";
+    header << "element face " << mesh.numTriangles() << "\n";
+    header << "property list uchar int " << plyFaceProperty(mesh.multi_isov) << "\n";
+    header << "end_header\n";
+    out.write(header.str());
+
+    writeAsciiMeshBody(out, mesh, precision);
+
+    if (!out.close())
+        std::cerr << "Error while writing file: " << filename << std::endl;
+}
+
+//! Deflate level of compressed files opened from now on.
+static int gzipLevel = 6;
+
+void BufferedFileWriter::setGzipLevel(int level)
+{
+    gzipLevel = std::clamp(level, 0, 9);
+}
+
+bool is_gzip_filename(const std::string &filename)
+{
+    return filename.size() >= 3 && filename.compare(filename.size() - 3, 3, ".gz") == 0;
+}
+
+//! @brief Deflates full buffers of a BufferedFileWriter on a worker thread.
+/*!
+ * The writer hands over a full buffer with submit() and keeps filling the
+ * buffer it gets back, while the worker deflates the submitted one and
+ * writes the compressed bytes to the file. At most one buffer is in flight.
+ */
+struct BufferedFileWriter::GzipPipe
+{
+    FILE *file;
+    z_stream zs{};
+    std::vector<unsigned char> deflated = std::vector<unsigned char>(size_t(1) << 18);
+    std::vector<char> pending;  //!< Buffer being deflated
+    size_t pendingSize = 0;
+    bool busy = false;          //!< `pending` holds data not yet deflated
+    bool stop = false;          //!< No more buffers will be submitted
+    bool failed = false;        //!< Set on a deflate or write error
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::thread worker;
+
+    GzipPipe(FILE *file, int level) : file(file)
     {
-        out << "3 " << triangle.vertex1->info().index << " " << triangle.vertex2->info().index << " " << triangle.vertex3->info().index << "\n";
+        // 15 + 16: maximum window with a gzip header and trailer
+        if (deflateInit2(&zs, level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        {
+            failed = true;
+            return;
+        }
+        worker = std::thread(&GzipPipe::run, this);
     }
 
-    out.close();
+    //! Deflates `size` bytes (or finishes the stream) and writes the output.
+    void deflateBytes(char *data, size_t size, int flush)
+    {
+        zs.next_in = reinterpret_cast<Bytef *>(data);
+        zs.avail_in = static_cast<uInt>(size);
+        do
+        {
+            zs.next_out = deflated.data();
+            zs.avail_out = static_cast<uInt>(deflated.size());
+            if (deflate(&zs, flush) == Z_STREAM_ERROR)
+            {
+                failed = true;
+                return;
+            }
+            const size_t have = deflated.size() - zs.avail_out;
+            if (have > 0 && std::fwrite(deflated.data(), 1, have, file) != have)
+                failed = true;
+        } while (zs.avail_out == 0);
+    }
+
+    void run()
+    {
+        for (;;)
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            changed.wait(lock, [this]() { return busy || stop; });
+            if (!busy)
+                break;
+            lock.unlock();
+
+            // Buffers are far smaller than 4 GiB, the limit of avail_in
+            deflateBytes(pending.data(), pendingSize, Z_NO_FLUSH);
+
+            lock.lock();
+            busy = false;
+            lock.unlock();
+            changed.notify_all();
+        }
+        deflateBytes(nullptr, 0, Z_FINISH);
+    }
+
+    //! Waits for the previous buffer, then swaps `buffer` in for deflating.
+    void submit(std::vector<char> &buffer, size_t size)
+    {
+        if (!worker.joinable())
+            return; // deflateInit2() failed; `failed` is already set
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [this]() { return !busy; });
+        pending.swap(buffer);
+        pendingSize = size;
+        busy = true;
+        lock.unlock();
+        changed.notify_all();
+        if (buffer.size() < pending.size())
+            buffer.resize(pending.size());
+    }
+
+    //! Deflates what is left, writes the gzip trailer and stops the worker.
+    bool finish()
+    {
+        if (worker.joinable())
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stop = true;
+            }
+            changed.notify_all();
+            worker.join();
+            deflateEnd(&zs);
+        }
+        return !failed;
+    }
+
+    ~GzipPipe()
+    {
+        finish();
+    }
+};
+
+//! Opens the output file and allocates the write buffer; ".gz" files get a compression thread.
+BufferedFileWriter::BufferedFileWriter(const std::string &filename, size_t capacity)
+    : file(std::fopen(filename.c_str(), "wb")), buffer(std::max<size_t>(capacity, 1))
+{
+    if (file && is_gzip_filename(filename))
+        gzip = std::make_unique<GzipPipe>(file, gzipLevel);
+}
+
+BufferedFileWriter::~BufferedFileWriter()
+{
+    close();
 }
 
-//! Writes a multi-isovalue isosurface mesh in OFF format.
-void writeOFFMulti(const std::string &filename, const VoronoiDiagram &voronoiDiagram, const std::vector<std::tuple<int, int, int>> &isoTriangles, IsoSurface &iso_surface)
+//! Copies into the buffer, writing it out whenever it fills up.
+void BufferedFileWriter::write(const void *data, size_t size)
 {
-    std::ofstream out(filename);
-    if (!out)
+    const char *bytes = static_cast<const char *>(data);
+    if (size >= buffer.size() / 2 && !gzip)
     {
-        std::cerr << "Cannot open file for writing: " << filename << std::endl;
+        // Large blocks go straight to the file
+        flush();
+        if (file && std::fwrite(bytes, 1, size, file) != size)
+            failed = true;
+        written += size;
         return;
     }
+    while (size > 0)
+    {
+        if (used == buffer.size())
+            flush();
+        const size_t n = std::min(size, buffer.size() - used);
+        std::memcpy(buffer.data() + used, bytes, n);
+        used += n;
+        bytes += n;
+        size -= n;
+    }
+}
 
-    // Header
-    out << "OFF\n";
-    out << iso_surface.isosurfaceVertices.size() << " " << iso_surface.isosurfaceTrianglesMulti.size() << " 0\n";
-
-    // Write vertex coordinates
-    for (const auto &v : iso_surface.isosurfaceVertices)
+//! Hands the pending bytes to the file, or to the compression thread.
+void BufferedFileWriter::flush()
+{
+    if (gzip)
     {
-        out << v.x() << " " << v.y() << " " << v.z() << "\n";
+        if (used > 0)
+            gzip->submit(buffer, used);
     }
+    else if (file && used > 0 && std::fwrite(buffer.data(), 1, used, file) != used)
+        failed = true;
+    written += used;
+    used = 0;
+}
 
-    // Write face indices
-    for (const auto &triangle : iso_surface.isosurfaceTrianglesMulti)
+//! Flushes, seeks back to `offset`, overwrites and returns to the end of the file.
+void BufferedFileWriter::patch(size_t offset, const void *data, size_t size)
+{
+    if (!file)
+        return;
+    if (gzip)
     {
-        int idx1 = std::get<0>(triangle);
-        int idx2 = std::get<1>(triangle);
-        int idx3 = std::get<2>(triangle);
-        out << "3 " << idx1 << " " << idx2 << " " << idx3 << "\n";
+        failed = true; // A compressed stream cannot be rewritten in place
+        return;
     }
+    flush();
+    if (std::fseek(file, static_cast<long>(offset), SEEK_SET) != 0 ||
+        std::fwrite(data, 1, size, file) != size ||
+        std::fseek(file, 0, SEEK_END) != 0)
+        failed = true;
+}
 
-    out.close();
+//! Flushes the buffer and closes the file.
+bool BufferedFileWriter::close()
+{
+    if (file)
+    {
+        flush();
+        if (gzip && !gzip->finish())
+            failed = true;
+        if (std::fclose(file) != 0)
+            failed = true;
+        file = nullptr;
+    }
+    return !failed;
 }
 
-//! Writes a single-isovalue isosurface mesh in PLY format.
-void writePLYSingle(const std::string &filename, const std::vector<Point> &vertices, const std::vector<DelaunayTriangle> &triangles)
+//! Writes an isosurface mesh in binary little-endian PLY format.
+void writePLYBinary(const std::string &filename, const IsoMesh &mesh)
 {
-    std::ofstream out(filename);
-    if (!out)
+    BufferedFileWriter out(filename);
+    if (!out.is_open())
     {
         std::cerr << "Cannot open file for writing: " << filename << std::endl;
         return;
     }
 
     // Write PLY header
-    out << "ply\n";
-    out << "format ascii 1.0\n";
-    out << "element vertex " << vertices.size() << "\n";
-    out << "property float x\n";
-    out << "property float y\n";
-    out << "property float z\n";
-    out << "element face " << triangles.size() << "\n";
-    out << "property list uchar int vertex_index\n";
-    out << "end_header\n";
+    std::ostringstream header;
+    header << "ply\n";
+    header << "format binary_little_endian 1.0\n";
+    header << "element vertex " << mesh.numVertices() << "\n";
+    header << "property float x\n";
+    header << "property float y\n";
+    header << "property float z\n";
+    header << "element face " << mesh.numTriangles() << "\n";
+    header << "property list uchar int " << plyFaceProperty(mesh.multi_isov) << "\n";
+    header << "end_header\n";
+    out.write(header.str());
 
-    // Write vertices
-    for (const auto &vertex : vertices)
+    // Vertices are interleaved in the file
+    for (size_t i = 0; i < mesh.numVertices(); ++i)
     {
-        out << vertex.x() << " " << vertex.y() << " " << vertex.z() << "\n";
+        out.writeLE(mesh.x[i]);
+        out.writeLE(mesh.y[i]);
+        out.writeLE(mesh.z[i]);
     }
 
-    // Write faces
-    for (const auto &triangle : triangles)
+    // Faces: count byte followed by three int32 indices
+    const unsigned char count = 3;
+    for (size_t k = 0; k + 2 < mesh.indices.size(); k += 3)
     {
-        out << "3 " << triangle.vertex1->info().index << " " << triangle.vertex2->info().index << " " << triangle.vertex3->info().index << "\n";
+        out.write(&count, 1);
+        out.writeLE(static_cast<std::int32_t>(mesh.indices[k]));
+        out.writeLE(static_cast<std::int32_t>(mesh.indices[k + 1]));
+        out.writeLE(static_cast<std::int32_t>(mesh.indices[k + 2]));
     }
 
-    out.close();
+    if (!out.close())
+        std::cerr << "Error while writing file: " << filename << std::endl;
 }
 
-//! Writes a multi-isovalue isosurface mesh in PLY format.
-void writePLYMulti(const std::string &filename, const VoronoiDiagram &voronoiDiagram, const std::vector<std::tuple<int, int, int>> &isoTriangles, IsoSurface &iso_surface)
+//! Writes the mesh as a raw little-endian binary dump.
+void writeMeshBinary(const std::string &filename, const IsoMesh &mesh)
 {
-    std::ofstream out(filename);
-    if (!out)
+    BufferedFileWriter out(filename);
+    if (!out.is_open())
     {
         std::cerr << "Cannot open file for writing: " << filename << std::endl;
         return;
     }
 
-    // Write PLY header
-    out << "ply\n";
-    out << "format ascii 1.0\n";
-    out << "element vertex " << iso_surface.isosurfaceVertices.size() << "\n";
-    out << "property float x\n";
-    out << "property float y\n";
-    out << "property float z\n";
-    out << "element face " << iso_surface.isosurfaceTrianglesMulti.size() << "\n";
-    out << "property list uchar int vertex_indices\n";
-    out << "end_header\n";
+    out.write("VDCMESH1", 8);
+    out.writeLE(static_cast<std::uint64_t>(mesh.numVertices()));
+    out.writeLE(static_cast<std::uint64_t>(mesh.numTriangles()));
+    for (size_t i = 0; i < mesh.numVertices(); ++i)
+    {
+        out.writeLE(mesh.x[i]);
+        out.writeLE(mesh.y[i]);
+        out.writeLE(mesh.z[i]);
+    }
+    for (size_t k = 0; k + 2 < mesh.indices.size(); k += 3)
+    {
+        out.writeLE(mesh.indices[k]);
+        out.writeLE(mesh.indices[k + 1]);
+        out.writeLE(mesh.indices[k + 2]);
+    }
+
+    if (!out.close())
+        std::cerr << "Error while writing file: " << filename << std::endl;
+}
+
+//! @brief Stores `value` at `bytes` in little-endian order.
+template <typename T>
+static void storeLE(unsigned char *bytes, T value)
+{
+    std::memcpy(bytes, &value, sizeof(T));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    std::reverse(bytes, bytes + sizeof(T));
+#endif
+}
+
+//! Opens the file; nothing is written before writeVertices().
+MeshStreamWriter::MeshStreamWriter(const std::string &filename, Format format, bool multi_isov, size_t maxQueuedBlocks)
+    : out(filename), format(format), multi_isov(multi_isov), maxQueued(std::max<size_t>(maxQueuedBlocks, 1))
+{
+}
+
+MeshStreamWriter::~MeshStreamWriter()
+{
+    finish();
+}
+
+//! Writes the header with a placeholder triangle count, then the vertices, and starts the writer thread.
+void MeshStreamWriter::writeVertices(const std::vector<Point> &vertices)
+{
+    if (started)
+        throw std::runtime_error("MeshStreamWriter: vertices were already written");
+    started = true;
+
+    if (format == Format::PLYBinary)
+    {
+        std::ostringstream header;
+        header << "ply\n";
+        header << "format binary_little_endian 1.0\n";
+        header << "element vertex " << vertices.size() << "\n";
+        header << "property float x\n";
+        header << "property float y\n";
+        header << "property float z\n";
+        header << "element face ";
+        out.write(header.str());
+        countOffset = out.position();
+        out.write("0000000000\n"); // Patched by finish()
+        out.write("property list uchar int " + std::string(plyFaceProperty(multi_isov)) + "\n");
+        out.write("end_header\n");
+    }
+    else
+    {
+        out.write("VDCMESH1", 8);
+        out.writeLE(static_cast<std::uint64_t>(vertices.size()));
+        countOffset = out.position();
+        out.writeLE(static_cast<std::uint64_t>(0)); // Patched by finish()
+    }
 
-    // Write vertex coordinates
-    for (const auto &vertex : iso_surface.isosurfaceVertices)
+    for (const Point &p : vertices)
     {
-        out << vertex.x() << " " << vertex.y() << " " << vertex.z() << "\n";
+        out.writeLE(static_cast<float>(p.x()));
+        out.writeLE(static_cast<float>(p.y()));
+        out.writeLE(static_cast<float>(p.z()));
     }
 
-    // Write face indices
-    for (const auto &triangle : iso_surface.isosurfaceTrianglesMulti)
+    writer = std::thread(&MeshStreamWriter::writerLoop, this);
+}
+
+//! Waits while the queue is full, then hands the block to the writer thread.
+void MeshStreamWriter::appendTriangles(std::vector<std::uint32_t> &&indices)
+{
+    if (!started)
+        throw std::runtime_error("MeshStreamWriter: triangles appended before the vertices");
+    if (indices.empty())
+        return;
+
+    std::unique_lock<std::mutex> lock(queueMutex);
+    queueChanged.wait(lock, [this]() { return queue.size() < maxQueued; });
+    queue.push_back(std::move(indices));
+    lock.unlock();
+    queueChanged.notify_all();
+}
+
+//! Writer thread: takes blocks off the queue until finish() closes it.
+void MeshStreamWriter::writerLoop()
+{
+    for (;;)
     {
-        int idx1 = std::get<0>(triangle);
-        int idx2 = std::get<1>(triangle);
-        int idx3 = std::get<2>(triangle);
-        out << "3 " << idx1 << " " << idx2 << " " << idx3 << "\n";
+        std::vector<std::uint32_t> block;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueChanged.wait(lock, [this]() { return closing || !queue.empty(); });
+            if (queue.empty())
+                return;
+            block = std::move(queue.front());
+            queue.pop_front();
+        }
+        queueChanged.notify_all();
+        writeTriangleBlock(block);
     }
+}
 
-    out.close();
+//! Encodes a block of triangles into one byte buffer and appends it.
+void MeshStreamWriter::writeTriangleBlock(const std::vector<std::uint32_t> &indices)
+{
+    const size_t numTris = indices.size() / 3;
+    const size_t recordBytes = (format == Format::PLYBinary) ? 13 : 12;
+    std::vector<unsigned char> bytes(numTris * recordBytes);
+    unsigned char *p = bytes.data();
+    for (size_t t = 0; t < numTris; ++t)
+    {
+        if (format == Format::PLYBinary)
+            *p++ = 3;
+        for (int k = 0; k < 3; ++k, p += 4)
+            storeLE(p, indices[3 * t + k]);
+    }
+    out.write(bytes.data(), bytes.size());
+    trianglesWritten += numTris;
 }
 
+//! Drains the queue, joins the writer thread and patches the triangle count.
+bool MeshStreamWriter::finish()
+{
+    if (finished)
+        return out.close();
+    finished = true;
+
+    if (!started)
+        writeVertices(std::vector<Point>());
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        closing = true;
+    }
+    queueChanged.notify_all();
+    if (writer.joinable())
+        writer.join();
+
+    if (format == Format::PLYBinary)
+    {
+        char digits[16];
+        std::snprintf(digits, sizeof(digits), "%010llu", static_cast<unsigned long long>(trianglesWritten));
+        out.patch(countOffset, digits, 10);
+    }
+    else
+    {
+        unsigned char count[8];
+        storeLE(count, trianglesWritten);
+        out.patch(countOffset, count, 8);
+    }
+    return out.close();
+}
 
 //! Exports Voronoi diagram data to a CSV file for visualization and debugging
 void export_voronoi_to_csv(const VoronoiDiagram &voronoiDiagram, const std::string &filename)
 {
-    std::ofstream file(filename);
-
-    if (!file)
+    BufferedFileWriter out(filename);
+    if (!out.is_open())
     {
         std::cerr << "Cannot open file for writing: " << filename << std::endl;
         return;
     }
 
+    // Lines are formatted by a stream and handed to the writer in blocks
+    std::ostringstream file;
+    auto flushLines = [&](size_t threshold)
+    {
+        if (static_cast<size_t>(file.tellp()) < threshold)
+            return;
+        out.write(file.str());
+        file.str(std::string());
+    };
+    const size_t blockBytes = size_t(1) << 20;
+
     // Export vertices
     file << "vertices\n";
-    for (const auto &vVertex : voronoiDiagram.vertices)
+    for (const Point &vertex : voronoiDiagram.vertices.coords)
     {
-        Point vertex = vVertex.coord;
         file << vertex.x() << "," << vertex.y() << "," << vertex.z() << "\n";
+        flushLines(blockBytes);
     }
 
     // Export edges
     file << "edges\n";
     for (const auto &edge : voronoiDiagram.edges)
     {
-        Segment3 segment;
-        Line3 line;
-        Ray3 ray;
-
-        if (CGAL::assign(segment, edge.edgeObject))
+        if (edge.type == 0)
         {
-            Point p1 = segment.source();
-            Point p2 = segment.target();
+            const Point &p1 = voronoiDiagram.vertices.coords[edge.vertex1];
+            const Point &p2 = voronoiDiagram.vertices.coords[edge.vertex2];
             file << "Segment3," << p1.x() << "," << p1.y() << "," << p1.z() << ","
                  << p2.x() << "," << p2.y() << "," << p2.z() << "\n";
         }
-        else if (CGAL::assign(line, edge.edgeObject))
+        else if (edge.type == 2)
         {
+            Line3 line = voronoiDiagram.edgeLine(edge);
             Point p1 = line.point(0);
             Point p2 = line.point(1);
             file << "Line3," << p1.x() << "," << p1.y() << "," << p1.z() << ","
                  << p2.x() << "," << p2.y() << "," << p2.z() << "\n";
         }
-        else if (CGAL::assign(ray, edge.edgeObject))
+        else if (edge.type == 1)
         {
-            Point p1 = ray.source();
-            Vector3 direction = ray.direction().vector();
+            const Point &p1 = voronoiDiagram.vertices.coords[edge.vertex1];
+            Vector3 direction = edge.directionVector();
             file << "Ray3," << p1.x() << "," << p1.y() << "," << p1.z() << ","
                  << direction.x() << "," << direction.y() << "," << direction.z() << "\n";
         }
+        flushLines(blockBytes);
+    }
+
+    flushLines(0);
+    if (!out.close())
+        std::cerr << "Error while writing file: " << filename << std::endl;
+}
+
+//! @brief Appends one column of a binary Voronoi diagram dump.
+/*!
+ * Column record: uint16 name length, name, uint8 type code ('i' int32,
+ * 'f' float32, 'd' float64), uint8 components per row, uint64 rows, then
+ * rows * components values in little-endian order.
+ */
+template <typename T>
+static void writeColumn(BufferedFileWriter &out, const std::string &name, char type, int components, const T *values, size_t rows)
+{
+    out.writeLE(static_cast<std::uint16_t>(name.size()));
+    out.write(name);
+    out.writeLE(static_cast<std::uint8_t>(type));
+    out.writeLE(static_cast<std::uint8_t>(components));
+    out.writeLE(static_cast<std::uint64_t>(rows));
+    const size_t count = rows * components;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    for (size_t i = 0; i < count; ++i)
+        out.writeLE(values[i]);
+#else
+    out.write(values, count * sizeof(T));
+#endif
+}
+
+template <typename T>
+static void writeColumn(BufferedFileWriter &out, const std::string &name, char type, int components, const std::vector<T> &values)
+{
+    writeColumn(out, name, type, components, values.data(), values.size() / components);
+}
+
+//! Writes the diagram column by column; see the header for the layout.
+void writeVoronoiDiagramBinary(const std::string &filename, const VoronoiDiagram &vd, const IsoSurface *iso_surface)
+{
+    BufferedFileWriter out(filename);
+    if (!out.is_open())
+    {
+        std::cerr << "Cannot open file for writing: " << filename << std::endl;
+        return;
+    }
+    out.write("VDCVD001", 8);
+
+    // Vertices
+    const size_t numVertices = vd.vertices.size();
+    std::vector<double> coords(3 * numVertices);
+    for (size_t i = 0; i < numVertices; ++i)
+    {
+        coords[3 * i] = vd.vertices.coords[i].x();
+        coords[3 * i + 1] = vd.vertices.coords[i].y();
+        coords[3 * i + 2] = vd.vertices.coords[i].z();
+    }
+    writeColumn(out, "vertex", 'd', 3, coords);
+    writeColumn(out, "vertex_value", 'f', 1, vd.vertices.values);
+
+    // Edges
+    const size_t numEdges = vd.edges.size();
+    std::vector<int> edgeInts(3 * numEdges);
+    std::vector<double> edgeDirections(3 * numEdges);
+    for (size_t e = 0; e < numEdges; ++e)
+    {
+        const VoronoiEdge &edge = vd.edges[e];
+        edgeInts[3 * e] = edge.type;
+        edgeInts[3 * e + 1] = edge.vertex1;
+        edgeInts[3 * e + 2] = edge.vertex2;
+        std::copy(edge.direction, edge.direction + 3, edgeDirections.begin() + 3 * e);
+    }
+    writeColumn(out, "edge_type_vertices", 'i', 3, edgeInts);
+    writeColumn(out, "edge_direction", 'd', 3, edgeDirections);
+
+    // Facets
+    writeColumn(out, "facet_offsets", 'i', 1, vd.facetVertices.offsets);
+    writeColumn(out, "facet_vertices", 'i', 1, vd.facetVertices.data);
+
+    // Cells
+    const size_t numCells = vd.cells.size();
+    std::vector<int> cellInts(3 * numCells);
+    std::vector<double> cellSites(3 * numCells);
+    for (size_t c = 0; c < numCells; ++c)
+    {
+        const VoronoiCell &vc = vd.cells[c];
+        cellInts[3 * c] = vc.cellIndex;
+        cellInts[3 * c + 1] = vc.isoVertexStartIndex;
+        cellInts[3 * c + 2] = vc.numIsoVertices;
+        const Point site = vc.delaunay_vertex->point();
+        cellSites[3 * c] = site.x();
+        cellSites[3 * c + 1] = site.y();
+        cellSites[3 * c + 2] = site.z();
+    }
+    writeColumn(out, "cell_index_isovertices", 'i', 3, cellInts);
+    writeColumn(out, "cell_site", 'd', 3, cellSites);
+    writeColumn(out, "cell_vertex_offsets", 'i', 1, vd.cellVertices.offsets);
+    writeColumn(out, "cell_vertices", 'i', 1, vd.cellVertices.data);
+
+    std::vector<int> cellFacets(2 * vd.cellFacets.entries());
+    for (size_t k = 0; k < vd.cellFacets.entries(); ++k)
+    {
+        cellFacets[2 * k] = vd.cellFacets.data[k].facet_index;
+        cellFacets[2 * k + 1] = vd.cellFacets.data[k].orientation;
+    }
+    writeColumn(out, "cell_facet_offsets", 'i', 1, vd.cellFacets.offsets);
+    writeColumn(out, "cell_facets", 'i', 2, cellFacets);
+
+    // Cell edges
+    std::vector<int> cellEdges(3 * vd.cellEdges.size());
+    for (size_t k = 0; k < vd.cellEdges.size(); ++k)
+    {
+        cellEdges[3 * k] = vd.cellEdges[k].cellIndex;
+        cellEdges[3 * k + 1] = vd.cellEdges[k].edgeIndex;
+        cellEdges[3 * k + 2] = vd.cellEdges[k].nextCellEdge;
+    }
+    writeColumn(out, "cell_edges", 'i', 3, cellEdges);
+
+    // Isosurface vertices, if given
+    if (iso_surface)
+    {
+        const std::vector<Point> &isoVertices = iso_surface->isosurfaceVertices;
+        std::vector<double> isoCoords(3 * isoVertices.size());
+        for (size_t i = 0; i < isoVertices.size(); ++i)
+        {
+            isoCoords[3 * i] = isoVertices[i].x();
+            isoCoords[3 * i + 1] = isoVertices[i].y();
+            isoCoords[3 * i + 2] = isoVertices[i].z();
+        }
+        writeColumn(out, "isovertex", 'd', 3, isoCoords);
     }
 
-    file.close();
+    out.writeLE(static_cast<std::uint16_t>(0)); // End of columns
+    if (!out.close())
+        std::cerr << "Error while writing file: " << filename << std::endl;
 }
 
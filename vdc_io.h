@@ -6,48 +6,258 @@
 
 #include "vdc_utilities.h"
 #include "vdc_voronoi.h"
+#include "vdc_mesh.h"
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
 
-//! @brief Writes an isosurface mesh in OFF format (single-isovalue case).
+//! @brief Output file written through one large in-memory buffer.
 /*!
+ * Bytes are collected in a buffer of `capacity` bytes and handed to the C
+ * library in one fwrite() per full buffer, instead of one stream insertion
+ * per value. Blocks of at least half the capacity are written directly.
+ * Multi-byte values can be appended in little-endian order regardless of the
+ * host byte order.
+ *
+ * If `filename` ends in ".gz" the file is written gzip-compressed. Full
+ * buffers are then deflated on a separate thread while the caller fills the
+ * next one, so compression runs behind formatting; patch() is not available.
+ */
+class BufferedFileWriter
+{
+public:
+    //! @brief Opens `filename` for binary writing; check is_open() afterwards.
+    explicit BufferedFileWriter(const std::string &filename, size_t capacity = size_t(8) << 20);
+
+    //! @brief Flushes and closes the file if close() was not called.
+    ~BufferedFileWriter();
+
+    BufferedFileWriter(const BufferedFileWriter &) = delete;
+    BufferedFileWriter &operator=(const BufferedFileWriter &) = delete;
+
+    //! @brief True if the file was opened.
+    bool is_open() const { return file != nullptr; }
+
+    //! @brief True if the file is written gzip-compressed.
+    bool compressed() const { return gzip != nullptr; }
+
+    //! @brief Sets the deflate level (0-9) of files opened afterwards; the default is 6.
+    static void setGzipLevel(int level);
+
+    //! @brief Appends `size` bytes.
+    void write(const void *data, size_t size);
+
+    //! @brief Appends the characters of `text`.
+    void write(const std::string &text) { write(text.data(), text.size()); }
+
+    //! @brief Appends an arithmetic value in little-endian byte order.
+    template <typename T>
+    void writeLE(T value)
+    {
+        unsigned char bytes[sizeof(T)];
+        std::memcpy(bytes, &value, sizeof(T));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        std::reverse(bytes, bytes + sizeof(T));
+#endif
+        write(bytes, sizeof(T));
+    }
+
+    //! @brief Number of bytes appended so far, i.e. the offset of the next byte.
+    size_t position() const { return written + used; }
+
+    //! @brief Overwrites bytes that were already appended, e.g. a count in a header.
+    /*!
+     * Not supported for compressed files; the writer is then marked failed.
+     *
+     * @param offset Offset of the first byte to overwrite; `offset + size` must not exceed position().
+     * @param data The replacement bytes.
+     * @param size Number of bytes.
+     */
+    void patch(size_t offset, const void *data, size_t size);
+
+    //! @brief Flushes the buffer and closes the file.
+    /*!
+     * @return False if any write failed.
+     */
+    bool close();
+
+private:
+    struct GzipPipe;
+
+    void flush();
+
+    FILE *file;                     //!< Output file, nullptr once closed
+    std::vector<char> buffer;       //!< Pending bytes
+    size_t used = 0;                //!< Number of pending bytes
+    size_t written = 0;             //!< Number of (uncompressed) bytes handed on
+    bool failed = false;            //!< Set when a write to the file fails
+    std::unique_ptr<GzipPipe> gzip; //!< Compression thread, for ".gz" files
+};
+
+//! @brief True if `filename` ends in ".gz", i.e. BufferedFileWriter compresses it.
+bool is_gzip_filename(const std::string &filename);
+
+//! @brief Appends a double formatted as printf("%.*g") would, or in shortest round-trip form.
+/*!
+ * With a precision of 6 this is the text `std::ostream << value` gives under
+ * default stream settings, which the mesh writers used before.
+ *
+ * @param p Write position; at least 32 bytes must be available.
+ * @param value The value to format.
+ * @param precision Significant digits, or a negative value for the shortest round-trip form.
+ * @return One past the last character written.
+ */
+char *formatDouble(char *p, double value, int precision);
+
+//! @brief Binary mesh file that is written while the triangles are still being generated.
+/*!
+ * The vertices are written first. Triangle index blocks are then queued with
+ * appendTriangles() and written by a background thread, so file output
+ * overlaps with triangle generation and the complete triangle list is never
+ * held in memory. The header carries a placeholder triangle count that
+ * finish() patches. At most `maxQueuedBlocks` blocks wait in the queue;
+ * appendTriangles() blocks while it is full.
+ *
+ * Supports binary little-endian PLY (as writePLYBinary()) and the raw layout
+ * of writeMeshBinary().
+ */
+class MeshStreamWriter
+{
+public:
+    //! @brief File layouts that can be streamed.
+    enum class Format
+    {
+        PLYBinary, //!< binary_little_endian PLY
+        Raw        //!< "VDCMESH1" raw dump
+    };
+
+    //! @brief Opens `filename`; check is_open() afterwards.
+    /*!
+     * @param multi_isov True if the triangles are multi-isovertex ones; selects the PLY face property name.
+     */
+    MeshStreamWriter(const std::string &filename, Format format, bool multi_isov, size_t maxQueuedBlocks = 8);
+
+    //! @brief Calls finish() if it was not called.
+    ~MeshStreamWriter();
+
+    MeshStreamWriter(const MeshStreamWriter &) = delete;
+    MeshStreamWriter &operator=(const MeshStreamWriter &) = delete;
+
+    //! @brief True if the file was opened.
+    bool is_open() const { return out.is_open(); }
+
+    //! @brief Writes the header and all vertices; must be called once, before any triangles.
+    void writeVertices(const std::vector<Point> &vertices);
+
+    //! @brief Queues a block of triangles, three vertex indices each, for writing.
+    void appendTriangles(std::vector<std::uint32_t> &&indices);
+
+    //! @brief Writes the queued triangles, patches the triangle count and closes the file.
+    /*!
+     * @return False if any write failed.
+     */
+    bool finish();
+
+    //! @brief Number of triangles written; final once finish() returned.
+    std::uint64_t numTriangles() const { return trianglesWritten; }
+
+private:
+    void writerLoop();
+    void writeTriangleBlock(const std::vector<std::uint32_t> &indices);
+
+    BufferedFileWriter out;
+    Format format;
+    bool multi_isov;                               //!< Selects the PLY face property name
+    size_t maxQueued;                              //!< Capacity of the block queue
+    size_t countOffset = 0;                        //!< File offset of the triangle count placeholder
+    std::uint64_t trianglesWritten = 0;            //!< Updated by the writer thread
+    bool started = false;                          //!< Set by writeVertices()
+    bool finished = false;                         //!< Set by finish()
+    std::deque<std::vector<std::uint32_t>> queue;  //!< Blocks waiting to be written
+    std::mutex queueMutex;
+    std::condition_variable queueChanged;
+    bool closing = false;                          //!< No more blocks will be queued
+    std::thread writer;
+};
+
+//! @brief Writes an isosurface mesh in OFF format.
+/*!
+ * Coordinates are formatted from the double positions the mesh kept (see
+ * build_iso_mesh()) like `printf("%.*g")` with `precision` digits; the
+ * default of 6 gives the same text as streaming the doubles with default
+ * iostream settings. Without kept positions the float copies are printed.
+ * All mesh writers compress their output when the file name ends in ".gz"
+ * (see BufferedFileWriter).
+ *
  * @param filename The output file path.
- * @param vertices The list of vertices in the mesh.
- * @param triangles The list of Delaunay triangles forming the mesh.
+ * @param mesh The mesh to write (either isovertex mode).
+ * @param precision Significant digits per coordinate, or negative for the shortest round-trip form.
  */
-void writeOFFSingle(const std::string &filename, const std::vector<Point> &vertices,
-                    const std::vector<DelaunayTriangle> &triangles);
+void writeOFF(const std::string &filename, const IsoMesh &mesh, int precision = 6);
 
-//! @brief Writes an isosurface mesh in PLY format (single-isovalue case).
+//! @brief Writes an isosurface mesh in ASCII PLY format.
 /*!
  * @param filename The output file path.
- * @param vertices The list of vertices in the mesh.
- * @param triangles The list of Delaunay triangles forming the mesh.
+ * @param mesh The mesh to write (either isovertex mode).
+ * @param precision Significant digits per coordinate, or negative for the shortest round-trip form.
  */
-void writePLYSingle(const std::string &filename, const std::vector<Point> &vertices,
-                    const std::vector<DelaunayTriangle> &triangles);
+void writePLY(const std::string &filename, const IsoMesh &mesh, int precision = 6);
 
-//! @brief Writes an isosurface mesh in OFF format (multi-isovalue case).
+//! @brief Writes an isosurface mesh in binary little-endian PLY format.
 /*!
+ * Same elements and properties as writePLY(): float x, y, z per vertex and a
+ * uchar-counted int list per face, named `vertex_index` for single-isovertex
+ * meshes and `vertex_indices` for multi-isovertex ones.
+ *
  * @param filename The output file path.
- * @param voronoiDiagram The Voronoi diagram containing isosurface data.
- * @param isoTriangles The list of isosurface triangles.
+ * @param mesh The mesh to write (either isovertex mode).
  */
-void writeOFFMulti(const std::string &filename, const VoronoiDiagram &voronoiDiagram,
-                   const std::vector<std::tuple<int, int, int>> &isoTriangles, IsoSurface &iso_surface);
+void writePLYBinary(const std::string &filename, const IsoMesh &mesh);
 
-//! @brief Writes an isosurface mesh in PLY format (multi-isovalue case).
+//! @brief Writes the mesh as a raw little-endian binary dump.
 /*!
+ * Layout: the 8 bytes "VDCMESH1", uint64 vertex count, uint64 triangle
+ * count, then x, y, z as float32 for every vertex, then three uint32
+ * indices per triangle.
+ *
  * @param filename The output file path.
- * @param voronoiDiagram The Voronoi diagram containing isosurface data.
- * @param isoTriangles The list of isosurface triangles.
+ * @param mesh The mesh to write (either isovertex mode).
  */
-void writePLYMulti(const std::string &filename, const VoronoiDiagram &voronoiDiagram,
-                   const std::vector<std::tuple<int, int, int>> &isoTriangles, IsoSurface &iso_surface);
+void writeMeshBinary(const std::string &filename, const IsoMesh &mesh);
 
 //! @brief Exports Voronoi diagram data to a CSV file.
 /*!
+ * A file name ending in ".gz" gives gzip-compressed output.
+ *
  * @param voronoiDiagram The Voronoi diagram containing vertices and edges.
  * @param filename The output CSV file path.
  */
 void export_voronoi_to_csv(const VoronoiDiagram &voronoiDiagram, const std::string &filename);
 
+//! @brief Writes the Voronoi diagram as a compact binary columnar dump.
+/*!
+ * The file starts with the magic "VDCVD001", followed by named columns and a
+ * zero name length that ends the list. Each column holds one array:
+ * uint16 name length, name, uint8 type ('i' int32, 'f' float32, 'd' float64),
+ * uint8 components per row, uint64 rows and the values, little-endian.
+ *
+ * Columns: vertex (3d), vertex_value, edge_type_vertices (type, vertex1,
+ * vertex2), edge_direction (3d), facet_offsets and facet_vertices (CSR),
+ * cell_index_isovertices (index, isovertex start, count), cell_site (3d),
+ * cell_vertex_offsets and cell_vertices (CSR), cell_facet_offsets and
+ * cell_facets (facet, orientation), cell_edges (cell, edge, next) and, if
+ * `iso_surface` is given, isovertex (3d). The lookup maps of the text dump
+ * are left out; they can be rebuilt from the edges and cell edges.
+ * readVD.py reads the format.
+ *
+ * @param filename The output file path; a ".gz" suffix compresses it.
+ * @param vd The Voronoi diagram.
+ * @param iso_surface Optional isosurface whose vertices are included.
+ */
+void writeVoronoiDiagramBinary(const std::string &filename, const VoronoiDiagram &vd, const IsoSurface *iso_surface = nullptr);
+
 #endif // VDC_IO_H
\ No newline at end of file
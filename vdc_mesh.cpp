@@ -0,0 +1,123 @@
+//! @file vdc_mesh.cpp
+//! @brief Implementation of the compact output mesh.
+
+#include "vdc_mesh.h"
+
+//! Removes unreferenced vertices with a mark, prefix-sum and gather pass.
+size_t IsoMesh::compact()
+{
+    const long long numVerts = static_cast<long long>(numVertices());
+    const long long numIndices = static_cast<long long>(indices.size());
+
+    // Mark the vertices used by some triangle
+    std::vector<unsigned char> referenced(numVerts, 0);
+#pragma omp parallel for
+    for (long long k = 0; k < numIndices; ++k)
+    {
+        const std::uint32_t v = indices[k];
+        if (v < numVerts)
+        {
+#pragma omp atomic write
+            referenced[v] = 1;
+        }
+    }
+
+    // Exclusive prefix sum: new index of every surviving vertex
+    std::vector<std::uint32_t> newIndex(numVerts);
+    std::uint32_t kept = 0;
+    for (long long i = 0; i < numVerts; ++i)
+    {
+        newIndex[i] = kept;
+        kept += referenced[i];
+    }
+    if (kept == numVerts)
+        return 0;
+
+    std::vector<float> nx(kept), ny(kept), nz(kept);
+#pragma omp parallel for
+    for (long long i = 0; i < numVerts; ++i)
+    {
+        if (!referenced[i])
+            continue;
+        nx[newIndex[i]] = x[i];
+        ny[newIndex[i]] = y[i];
+        nz[newIndex[i]] = z[i];
+    }
+
+    if (!exact.empty())
+    {
+        std::vector<double> nexact(3 * static_cast<size_t>(kept));
+#pragma omp parallel for
+        for (long long i = 0; i < numVerts; ++i)
+        {
+            if (!referenced[i])
+                continue;
+            std::copy_n(&exact[3 * i], 3, &nexact[3 * static_cast<size_t>(newIndex[i])]);
+        }
+        exact.swap(nexact);
+    }
+
+#pragma omp parallel for
+    for (long long k = 0; k < numIndices; ++k)
+    {
+        if (indices[k] < numVerts)
+            indices[k] = newIndex[indices[k]];
+    }
+
+    x.swap(nx);
+    y.swap(ny);
+    z.swap(nz);
+    return static_cast<size_t>(numVerts - kept);
+}
+
+//! Copies the isosurface into float vertex arrays and a flat index buffer.
+void build_iso_mesh(const IsoSurface &iso_surface, bool multi_isov, IsoMesh &mesh, bool keep_exact)
+{
+    const std::vector<Point> &vertices = iso_surface.isosurfaceVertices;
+    const size_t numVerts = vertices.size();
+    mesh.x.resize(numVerts);
+    mesh.y.resize(numVerts);
+    mesh.z.resize(numVerts);
+    for (size_t i = 0; i < numVerts; ++i)
+    {
+        mesh.x[i] = static_cast<float>(vertices[i].x());
+        mesh.y[i] = static_cast<float>(vertices[i].y());
+        mesh.z[i] = static_cast<float>(vertices[i].z());
+    }
+
+    mesh.exact.clear();
+    if (keep_exact)
+    {
+        mesh.exact.resize(3 * numVerts);
+        for (size_t i = 0; i < numVerts; ++i)
+        {
+            mesh.exact[3 * i] = vertices[i].x();
+            mesh.exact[3 * i + 1] = vertices[i].y();
+            mesh.exact[3 * i + 2] = vertices[i].z();
+        }
+    }
+
+    mesh.multi_isov = multi_isov;
+
+    mesh.indices.clear();
+    if (multi_isov)
+    {
+        mesh.indices.reserve(3 * iso_surface.isosurfaceTrianglesMulti.size());
+        for (const auto &triangle : iso_surface.isosurfaceTrianglesMulti)
+        {
+            mesh.indices.push_back(static_cast<std::uint32_t>(std::get<0>(triangle)));
+            mesh.indices.push_back(static_cast<std::uint32_t>(std::get<1>(triangle)));
+            mesh.indices.push_back(static_cast<std::uint32_t>(std::get<2>(triangle)));
+        }
+    }
+    else
+    {
+        mesh.indices.reserve(3 * iso_surface.isosurfaceTrianglesSingle.size());
+        for (const auto &triangle : iso_surface.isosurfaceTrianglesSingle)
+        {
+            mesh.indices.push_back(triangle.vertex1);
+            mesh.indices.push_back(triangle.vertex2);
+            mesh.indices.push_back(triangle.vertex3);
+        }
+    }
+}
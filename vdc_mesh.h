@@ -0,0 +1,61 @@
+//! @file vdc_mesh.h
+//! @brief Compact output mesh: float32 vertex arrays and a flat uint32 triangle index buffer.
+
+#ifndef VDC_MESH_H
+#define VDC_MESH_H
+
+#include "vdc_voronoi.h"
+#include <cstdint>
+
+//! @brief Triangle mesh in the form it is written to file.
+/*!
+ * Vertex positions are stored as three float arrays (structure of arrays) and
+ * the triangles as one flat index buffer, three indices per triangle. The
+ * mesh does not refer to the triangulation or the Voronoi diagram, so both
+ * can be released before it is written.
+ *
+ * The ASCII writers print the double-precision positions the isosurface was
+ * computed with, so build_iso_mesh() can also keep those in `exact`; the
+ * binary writers only use the float arrays.
+ */
+struct IsoMesh
+{
+    std::vector<float> x;                //!< x coordinate of each vertex.
+    std::vector<float> y;                //!< y coordinate of each vertex.
+    std::vector<float> z;                //!< z coordinate of each vertex.
+    std::vector<std::uint32_t> indices;  //!< Vertex indices, three per triangle.
+    std::vector<double> exact;           //!< x, y, z of each vertex in double precision; empty unless requested.
+    bool multi_isov = false;             //!< Built from the multi-isovertex triangles.
+
+    //! @brief Number of vertices.
+    size_t numVertices() const { return x.size(); }
+
+    //! @brief Number of triangles.
+    size_t numTriangles() const { return indices.size() / 3; }
+
+    //! @brief Heap footprint of the arrays in bytes.
+    size_t bytes() const
+    {
+        return (x.capacity() + y.capacity() + z.capacity()) * sizeof(float) +
+               indices.capacity() * sizeof(std::uint32_t) + exact.capacity() * sizeof(double);
+    }
+
+    //! @brief Drops vertices that no triangle references and renumbers the triangles.
+    /*!
+     * The surviving vertices keep their relative order.
+     *
+     * @return Number of vertices removed.
+     */
+    size_t compact();
+};
+
+//! @brief Builds the output mesh from the isosurface of either isovertex mode.
+/*!
+ * @param iso_surface The isosurface; its vertices and the triangles of the selected mode are copied.
+ * @param multi_isov True to take the multi-isovertex triangles, false for the single-isovertex ones.
+ * @param mesh Output mesh; previous contents are replaced.
+ * @param keep_exact True to also keep the double-precision positions, for ASCII output.
+ */
+void build_iso_mesh(const IsoSurface &iso_surface, bool multi_isov, IsoMesh &mesh, bool keep_exact = false);
+
+#endif // VDC_MESH_H
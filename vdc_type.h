@@ -33,6 +33,9 @@
 #include <CGAL/Vector_3.h>                                      // Represents a vector in 3D space.
 #include <CGAL/Polyhedron_3.h>                                  // Represents 3D polyhedral surfaces.
 #include <CGAL/convex_hull_3.h>                                 // Compute convex hulls in 3D.
+#include <CGAL/Extreme_points_traits_adapter_3.h>               // Run convex hulls on indices through a point property map.
+#include <CGAL/property_map.h>                                  // make_property_map for index-carrying hulls.
+#include <CGAL/Polygon_mesh_processing/polygon_soup_to_polygon_mesh.h> // Build polyhedra from facet lists.
 #include <CGAL/Convex_hull_3/dual/halfspace_intersection_3.h>   // Compute Halfspace Intersections in 3D
 #include <CGAL/centroid.h>                                      // Compute centroids of geometric objects.
 #include <CGAL/Exact_predicates_inexact_constructions_kernel.h> // Kernel for exact predicates and inexact constructions.
@@ -535,4 +538,12 @@ struct ObjectComparator
     }
 };
 
+//! @brief How much of the Voronoi diagram is validated after construction.
+enum class ValidationLevel
+{
+    None,  //!< No checks
+    Cheap, //!< Linear-time index and count invariants
+    Full   //!< Every check, including topology and orientation
+};
+
 #endif // VDC_TYPE_H
@@ -1,4 +1,5 @@
 #include "vdc_utilities.h"
+#include <sys/resource.h>
 
 //! Converts a CGAL::Object to a string for debugging purposes.
 std::string objectToString(const Object &obj)
@@ -197,4 +198,17 @@ void write_voronoiDiagram(VoronoiDiagram &vd, std::string &output_filename) {
 
     file.close();
     std::cout << "voronoi diagram saved to VoronoiDiagram_" << out + ".txt\n";
-}
\ No newline at end of file
+}
+
+//! Reads the peak resident set size from getrusage().
+long peak_rss_kb()
+{
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024; // Bytes on macOS
+#else
+    return usage.ru_maxrss; // KiB on Linux
+#endif
+}
@@ -99,4 +99,17 @@ bool readPointsFromFile(const std::string &filename, std::vector<Point> &points)
 void write_triangulation(Delaunay dt, std::vector<Point> &points, std::string &input_filename);
 
 void write_voronoiDiagram(VoronoiDiagram &vd, std::string &output_filename);
+
+//! @brief Frees the storage held by a container.
+/*!
+ * `clear()` keeps the capacity of a vector; swapping with an empty instance releases it.
+ */
+template <typename T>
+void release_memory(T &container)
+{
+    T().swap(container);
+}
+
+//! @brief Peak resident set size of the process so far, in KiB (0 if unavailable).
+long peak_rss_kb();
 #endif // VDC_UTILITIES_H
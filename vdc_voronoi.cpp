@@ -1,58 +1,34 @@
 #include "vdc_voronoi.h"
 
+#include <chrono>
+#include <cstdio>
+#include <sstream>
+
 //! @brief Finds the index of the vertex corresponding to the given point in the Voronoi diagram.
 /*!
- * Implements a spatial hashing technique for efficient point lookup in 3D space.
- * Scales the point coordinates to integers and uses a hash map for quick vertex index retrieval.
- * 
- * Algorithm details:
- * 1. Scales coordinates by 1e6 to convert to integer space
- * 2. Uses tuple-based hash map for spatial partitioning
- * 3. Performs exact match check within hash bucket
- *
- * Performance considerations:
- * - O(1) average case lookup time
- * - Scales well with large number of vertices
+ * Queries the vertexWeld grid hash: the cube containing the point and the
+ * neighbouring cubes nearest to it are searched, so points close to a cube
+ * boundary are still found. Cube coordinates are 64-bit, so large domains
+ * do not overflow.
  *
  * @param p The 3D point to locate in the Voronoi diagram (must be finite)
  * @return The index of the vertex if found, otherwise -1 indicating point not found
- * @note The scaling factor (1e6) provides ~1 micron precision for coordinates in meter units
+ * @note Matches within the weld tolerance (5e-5 per axis, as PointApproxEqual)
  */
 int VoronoiDiagram::find_vertex(const Point& p) const {
-    // Scale coordinates for spatial hashing
-    const double SCALE_FACTOR = 1e6;
-    int ix = static_cast<int>(std::round(p.x() * SCALE_FACTOR));
-    int iy = static_cast<int>(std::round(p.y() * SCALE_FACTOR));
-    int iz = static_cast<int>(std::round(p.z() * SCALE_FACTOR));
-    
-    // Create hash key from scaled coordinates
-    std::tuple<int, int, int> key(ix, iy, iz);
-    
-    // Look up in vertex map
-    auto it = vertexMap.find(key);
-    if (it != vertexMap.end()) {
-        // Check all vertices in this hash bucket for exact match
-        for (int idx : it->second) {
-            if (PointApproxEqual()(vertices[idx].coord, p)) {
-                return idx;
-            }
-        }
-    }
-    return -1;  // Not found
+    return vertexWeld.find(p, vertices.coords);
 }
 
 //! @brief Adds a vertex to the Voronoi diagram with the given point and value.
 /*!
- * Creates a new Voronoi vertex and updates both the vertex list and spatial hash map.
- * Maintains data structure consistency for efficient spatial queries.
+ * Creates a new Voronoi vertex and registers it in the vertexWeld index.
  *
  * Implementation details:
  * - Vertex indices are assigned sequentially
- * - Uses same spatial hashing scheme as find_vertex()
- * - Initializes empty cell indices list
+ * - No welding is done here; use find_vertex() first to reuse a vertex
  *
  * Thread safety:
- * - Not thread-safe due to shared vertex list and map modifications
+ * - Not thread-safe due to shared vertex arrays and index modifications
  * - External synchronization required for concurrent access
  *
  * @param p The 3D point coordinates for the new vertex (must be finite)
@@ -61,24 +37,8 @@ int VoronoiDiagram::find_vertex(const Point& p) const {
  * @throws May throw std::bad_alloc if memory allocation fails
  */
 int VoronoiDiagram::AddVertex(const Point& p, float value) {
-    // Create new vertex
-    int idx = vertices.size();
-    VoronoiVertex v(p);
-    v.index = idx;
-    v.value = value;
-    v.cellIndices = {};  // Initialize empty cell indices
-    
-    // Add to vertex list
-    vertices.push_back(v);
-    
-    // Update spatial hash map
-    const double SCALE_FACTOR = 1e6;
-    int ix = static_cast<int>(std::round(p.x() * SCALE_FACTOR));
-    int iy = static_cast<int>(std::round(p.y() * SCALE_FACTOR));
-    int iz = static_cast<int>(std::round(p.z() * SCALE_FACTOR));
-    std::tuple<int, int, int> key(ix, iy, iz);
-    vertexMap[key].push_back(idx);
-    
+    int idx = vertices.add(p, value);
+    vertexWeld.insert(p, idx);
     return idx;
 }
 
@@ -93,28 +53,27 @@ int VoronoiDiagram::AddVertex(const Point& p, float value) {
  * - Type 2: Line edge (infinite both ways)
  *
  * Data structures:
- * - Maintains segmentVertexPairToEdgeIndex map for O(1) duplicate checking
+ * - Maintains the segmentVertexPairToEdgeIndex hash table for O(1) duplicate checking
  * - Edge list stores all edges sequentially
  *
  * @param v1 Index of first vertex (must be valid, >= 0)
  * @param v2 Index of second vertex (must be valid, >= 0)
- * @param seg CGAL Segment_3 object defining the edge geometry
  * @return Index of the edge (existing if duplicate, new otherwise)
  * @throws std::out_of_range if vertex indices are invalid
  */
-int VoronoiDiagram::AddSegmentEdge(int v1, int v2, const Segment3& seg) {
+int VoronoiDiagram::AddSegmentEdge(int v1, int v2) {
     // Use sorted vertex indices for undirected edge representation
     int minV = std::min(v1, v2);
     int maxV = std::max(v1, v2);
     
     // Check if edge already exists
-    auto it = segmentVertexPairToEdgeIndex.find({minV, maxV});
-    if (it != segmentVertexPairToEdgeIndex.end()) {
-        return it->second;  // Return existing edge index
+    int existing = segmentVertexPairToEdgeIndex.find(minV, maxV);
+    if (existing >= 0) {
+        return existing;  // Return existing edge index
     }
     
     // Create new edge
-    VoronoiEdge edge(CGAL::make_object(seg));
+    VoronoiEdge edge;
     edge.vertex1 = v1;
     edge.vertex2 = v2;
     edge.type = 0;  // Type 0 = segment
@@ -122,7 +81,7 @@ int VoronoiDiagram::AddSegmentEdge(int v1, int v2, const Segment3& seg) {
     // Add to edge list and update mapping
     int edgeIdx = edges.size();
     edges.push_back(edge);
-    segmentVertexPairToEdgeIndex[{minV, maxV}] = edgeIdx;
+    segmentVertexPairToEdgeIndex.set(minV, maxV, edgeIdx);
     
     return edgeIdx;
 }
@@ -134,24 +93,22 @@ int VoronoiDiagram::AddSegmentEdge(int v1, int v2, const Segment3& seg) {
  *
  * Characteristics:
  * - Type 1 edge (ray)
- * - vertex1 and vertex2 set to -1 (no finite vertices)
- * - Stores source point and direction vector
+ * - vertex1 is the source vertex, vertex2 is -1
+ * - Stores the direction vector; the ray is rebuilt by edgeRay()
  *
  * Mathematical representation:
  * edge(t) = source + t * direction, t >= 0
  *
- * @param ray CGAL Ray_3 object defining the infinite edge
+ * @param sourceVertex Index of the Voronoi vertex at the ray source
+ * @param direction Direction of the ray
  * @return Index of the newly created edge
- * @note Ray edges don't participate in spatial hashing
  */
-int VoronoiDiagram::AddRayEdge(const Ray3& ray) {
-    // Create edge object
-    VoronoiEdge edge(CGAL::make_object(ray));
-    edge.vertex1 = -1;  // No start vertex (infinite)
+int VoronoiDiagram::AddRayEdge(int sourceVertex, const Vector3& direction) {
+    VoronoiEdge edge;
+    edge.vertex1 = sourceVertex;
     edge.vertex2 = -1;  // No end vertex (infinite)
     edge.type = 1;      // Type 1 = ray
-    edge.source = ray.source();
-    edge.direction = ray.direction().vector();
+    edge.setDirection(direction);
     
     // Add to edge list
     int edgeIdx = edges.size();
@@ -167,24 +124,22 @@ int VoronoiDiagram::AddRayEdge(const Ray3& ray) {
  *
  * Characteristics:
  * - Type 2 edge (line)
- * - vertex1 and vertex2 set to -1 (no finite vertices)
- * - Stores source point and direction vector
+ * - vertex1 is a Voronoi vertex on the line, vertex2 is -1
+ * - Stores the direction vector; the line is rebuilt by edgeLine()
  *
  * Mathematical representation:
- * edge(t) = source + t * direction, t ∈ ℝ
+ * edge(t) = anchor + t * direction, t ∈ ℝ
  *
- * @param line CGAL Line_3 object defining the infinite edge
+ * @param anchorVertex Index of a Voronoi vertex on the line
+ * @param direction Direction of the line
  * @return Index of the newly created edge
- * @note Line edges don't participate in spatial hashing
  */
-int VoronoiDiagram::AddLineEdge(const Line3& line) {
-    // Create edge object
-    VoronoiEdge edge(CGAL::make_object(line));
-    edge.vertex1 = -1;  // No start vertex (infinite)
+int VoronoiDiagram::AddLineEdge(int anchorVertex, const Vector3& direction) {
+    VoronoiEdge edge;
+    edge.vertex1 = anchorVertex;
     edge.vertex2 = -1;  // No end vertex (infinite)
     edge.type = 2;      // Type 2 = line
-    edge.source = line.point(0);
-    edge.direction = line.to_vector();
+    edge.setDirection(direction);
     
     // Add to edge list
     int edgeIdx = edges.size();
@@ -205,24 +160,15 @@ int VoronoiDiagram::AddLineEdge(const Line3& line) {
  * - Minimum 3 vertices required
  *
  * Data management:
- * - Initializes mirror_facet_index to -1 (no mirror)
+ * - Facets are shared; cells reference them through VoronoiFacetRef
  * - Facet indices are assigned sequentially
+ * - Vertex lists are appended as rows of facetVertices
  *
  * @param vertices_indices Vector of vertex indices forming the facet (size >= 3)
  * @return Index of the newly created facet
- * @throws std::invalid_argument if vertices_indices has fewer than 3 elements
  */
 int VoronoiDiagram::AddFacet(const std::vector<int>& vertices_indices) {
-    // Create new facet
-    VoronoiCellFacet facet;
-    facet.vertices_indices = vertices_indices;
-    facet.mirror_facet_index = -1;  // Initialize with no mirror facet
-    
-    // Add to facet list
-    int facetIdx = facets.size();
-    facets.push_back(facet);
-    
-    return facetIdx;
+    return facetVertices.appendRow(vertices_indices);
 }
 
 //! @brief Adds a cell to the Voronoi diagram.
@@ -236,12 +182,11 @@ int VoronoiDiagram::AddFacet(const std::vector<int>& vertices_indices) {
  *
  * Initial state:
  * - cellIndex set to current cells size
- * - vertices_indices and facet_indices empty
  * - delaunay_vertex stored for reference
  *
  * @param delaunay_vertex Handle to the associated Delaunay vertex
  * @return Index of the newly created cell
- * @note The cell geometry must be populated separately
+ * @note The cellVertices and cellFacets rows must be populated separately
  */
 int VoronoiDiagram::AddCell(Vertex_handle delaunay_vertex) {
     // Create new cell
@@ -254,354 +199,508 @@ int VoronoiDiagram::AddCell(Vertex_handle delaunay_vertex) {
     
     return cellIdx;
 }
-//! @brief Computes the centroid of a cycle using the associated midpoints.
+//! @brief Returns the polyhedron of a cell, building it on first request.
 /*!
- * Calculates the geometric center (isovertex) of a cycle by averaging the positions
- * of its constituent midpoints using CGAL's centroid function.
- *
- * Mathematical properties:
- * - Computes the arithmetic mean of point coordinates
- * - Result is the geometric center of mass
- * - Only valid for non-empty midpoint sets
+ * Converts the cell's facets, walked in outward orientation, into a polygon
+ * soup over cell-local vertex indices and stitches it into a Polyhedron_3.
+ * The result is cached until clearPolyhedronCache() is called.
  *
- * @param midpoints Vector of all MidpointNode objects in the diagram
- * @note Skips computation if midpoint_indices is empty
- * @see Cycle::compute_centroid(const std::vector<VoronoiVertex>&)
+ * @param cellIndex Index of the cell in `cells`
+ * @return Reference to the cached polyhedron
  */
-void Cycle::compute_centroid(const std::vector<MidpointNode> &midpoints)
+const Polyhedron_3 &VoronoiDiagram::cellPolyhedron(int cellIndex) const
 {
-    if (midpoint_indices.empty())
-    {
-        return; // No midpoints to compute centroid.
-    }
+    auto it = polyhedronCache.find(cellIndex);
+    if (it != polyhedronCache.end())
+        return it->second;
 
-    // Collect the points corresponding to the midpoint indices.
+    CsrSpan<const VoronoiFacetRef> refs = cellFacets.row(cellIndex);
     std::vector<Point> points;
-    for (int idx : midpoint_indices)
+    std::vector<std::vector<std::size_t>> polygons;
+    std::unordered_map<int, std::size_t> localIndex;
+    polygons.reserve(refs.size());
+    for (const auto &ref : refs)
     {
-        points.push_back(midpoints[idx].point);
+        const int n = facetVertices.rowSize(ref.facet_index);
+        std::vector<std::size_t> polygon;
+        polygon.reserve(n);
+        for (int k = 0; k < n; ++k)
+        {
+            int v = facetVertex(ref, k);
+            auto inserted = localIndex.emplace(v, points.size());
+            if (inserted.second)
+                points.push_back(vertices.coords[v]);
+            polygon.push_back(inserted.first->second);
+        }
+        polygons.push_back(std::move(polygon));
     }
 
-    // Compute the centroid using CGAL's centroid function.
-    isovertex = CGAL::centroid(points.begin(), points.end());
+    Polyhedron_3 &poly = polyhedronCache[cellIndex];
+    CGAL::Polygon_mesh_processing::polygon_soup_to_polygon_mesh(points, polygons, poly);
+    return poly;
 }
 
+/*
+ * Small Edge Collapsing Routines
+ */
 
-//! @brief Computes centroid using Voronoi vertex positions.
+//! @brief Disjoint-set forest with union by rank and path halving.
 /*!
- * Alternative centroid calculation using direct vertex coordinates instead of midpoints.
- * Provides more stable results when working with raw Voronoi vertices.
- *
- * Implementation details:
- * - Performs simple arithmetic mean of coordinates
- * - Handles empty vertex sets gracefully
- * - More efficient than midpoint-based version
- *
- * @param voronoiVertices Vector of all VoronoiVertex objects in the diagram
- * @note Prefer this version when midpoint data is unavailable
- * @see Cycle::compute_centroid(const std::vector<MidpointNode>&)
+ * Each set also remembers its smallest member, which becomes the surviving
+ * vertex of a collapsed group so that results do not depend on union order.
  */
-void Cycle::compute_centroid(const std::vector<VoronoiVertex> &voronoiVertices)
-{
-    double sumX = 0, sumY = 0, sumZ = 0;
-    for (int idx : midpoint_indices)
-    {
-        const Point &p = voronoiVertices[idx].coord;
-        sumX += p.x();
-        sumY += p.y();
-        sumZ += p.z();
+struct VertexDisjointSet {
+    std::vector<int> parent;          //!< Parent of each element; roots point to themselves
+    std::vector<unsigned char> rank;  //!< Upper bound on the height of each root's tree
+    std::vector<int> minMember;       //!< Smallest element of each root's set
+
+    explicit VertexDisjointSet(size_t n) : parent(n), rank(n, 0), minMember(n) {
+        for (size_t i = 0; i < n; ++i) {
+            parent[i] = static_cast<int>(i);
+            minMember[i] = static_cast<int>(i);
+        }
     }
-    double n = static_cast<double>(midpoint_indices.size());
-    isovertex = Point(sumX / n, sumY / n, sumZ / n);
-}
 
-/*
- * Small Edge Collapsing Routines
- */
+    //! @brief Root of the set containing `x`, halving the path on the way.
+    int find(int x) {
+        while (parent[x] != x) {
+            parent[x] = parent[parent[x]];
+            x = parent[x];
+        }
+        return x;
+    }
+
+    //! @brief Merges the sets of `a` and `b`; returns false if they were already joined.
+    bool unite(int a, int b) {
+        a = find(a);
+        b = find(b);
+        if (a == b) return false;
+        if (rank[a] < rank[b]) std::swap(a, b);
+        parent[b] = a;
+        if (rank[a] == rank[b]) ++rank[a];
+        minMember[a] = std::min(minMember[a], minMember[b]);
+        return true;
+    }
+};
 
 //! @brief Processes edges and marks vertices for merging based on distance threshold.
 /*!
- * Implements the first phase of edge collapsing by identifying vertices closer than
- * threshold D using a union-find (disjoint-set) data structure.
- *
- * Algorithm phases:
- * 1. Iterate through all finite edges
- * 2. Compute Euclidean distance between vertices
- * 3. Union vertex sets when distance <= D
+ * Implements the first phase of edge collapsing by joining the endpoints of
+ * every finite edge not longer than D.
  *
  * Complexity:
  * - O(E) edge iterations
- * - O(α(V)) per union operation (inverse Ackermann)
+ * - O(α(V)) amortized per union operation (inverse Ackermann)
  *
  * @param vd Voronoi diagram to process (read-only)
- * @param mapto Union-find structure (initially each vertex points to itself)
+ * @param sets Disjoint sets over the vertices (initially singletons)
  * @param D Distance threshold for merging (must be >= 0)
+ * @return Number of merges performed
  * @note Only processes finite edges (skips rays and lines)
  */
-static void processEdges(const VoronoiDiagram& vd, std::vector<int>& mapto, double D) {
-    for (size_t edgeIdx = 0; edgeIdx < vd.edges.size(); ++edgeIdx) {
-
-        const auto& edge = vd.edges[edgeIdx];
-
-
-        // Get vertex indices for the current edge
-        int v1 = edge.vertex1;
-        int v2 = edge.vertex2;
-
+static int processEdges(const VoronoiDiagram& vd, VertexDisjointSet& sets, double D) {
+    const double D2 = D * D;
+    int merges = 0;
+    for (const auto& edge : vd.edges) {
         // Skip edges that are not finite segments (rays or lines)
-        if (v1 < 0 || v2 < 0) continue;
-
-        // Find the roots of the vertex sets in the union-find structure
-        int root1 = v1;
-        while (mapto[root1] != root1) root1 = mapto[root1];
-        int root2 = v2;
-        while (mapto[root2] != root2) root2 = mapto[root2];
-
-        // If vertices are already in the same set, skip
-        if (root1 == root2) continue;
-
-        // Compute the distance between the vertex positions
-        Point p1 = vd.vertices[v1].coord;
-        Point p2 = vd.vertices[v2].coord;
-        double dist = CGAL::sqrt(CGAL::squared_distance(p1, p2));
-
-        // Merge vertices if the distance is less than or equal to threshold D
-        if (dist <= D) {
-            // Union by setting the parent; use smaller index as parent for consistency
-            if (root1 < root2) {
-                mapto[root2] = root1;
-            } else {
-                mapto[root1] = root2;
-            }
-        }
-    }
-}
-
+        if (edge.type != 0 || edge.vertex1 < 0 || edge.vertex2 < 0) continue;
 
-//! @brief Performs path compression on the union-find structure.
-/*!
- * Optimizes the union-find data structure by flattening the tree structure,
- * making future find operations nearly constant time.
- *
- * Algorithm details:
- * - Performs one-pass path compression
- * - Updates all nodes along path to point directly to root
- * - Preserves union-find invariants
- *
- * @param mapto Union-find structure to compress (modified in-place)
- * @note Should be called after all unions are complete
- * @see processEdges()
- */
-static void compressMapping(std::vector<int>& mapto) {
-    for (size_t i = 0; i < mapto.size(); ++i) {
-        int root = i;
-        while (mapto[root] != root) root = mapto[root];
-        mapto[i] = root;
+        // Compare squared lengths; no square root needed
+        if (CGAL::squared_distance(vd.vertices.coords[edge.vertex1], vd.vertices.coords[edge.vertex2]) <= D2) {
+            if (sets.unite(edge.vertex1, edge.vertex2)) ++merges;
+        }
     }
+    return merges;
 }
 
-//! @brief Rebuilds vertex list after edge collapsing.
+//! @brief Compacts the vertex arrays in place after edge collapsing.
 /*!
- * Creates a consolidated vertex list containing only representative vertices
- * after edge collapsing, and builds index remapping table.
- *
- * Postconditions:
- * - vd.vertices contains only root vertices
- * - oldToNewVertexIndex maps each original index to its new representative
- * - Vertex count <= original count
+ * Each group keeps the coordinates and value of its smallest member. New
+ * indices follow the order of those members, so a vertex never moves to a
+ * higher index and the arrays can be compacted front to back.
  *
  * @param vd Voronoi diagram to modify (vertices updated)
- * @param mapto Union-find structure after path compression
+ * @param sets Disjoint sets after all unions
  * @param oldToNewVertexIndex Output mapping (resized and populated)
- * @note Clears and rebuilds the vertexMap spatial index
  */
-static void rebuildVertices(VoronoiDiagram& vd, const std::vector<int>& mapto, std::vector<int> &oldToNewVertexIndex) {
-    std::map<int, int> oldToNewIndex;
-    std::vector<VoronoiVertex> newVertices;
-    for (size_t i = 0; i < vd.vertices.size(); ++i) {
-        int root = mapto[i];
-        if (oldToNewIndex.count(root) == 0) {
-            VoronoiVertex v = vd.vertices[root];
-            v.index = newVertices.size();
-            oldToNewIndex[root] = v.index;
-            newVertices.push_back(v);
+static void rebuildVertices(VoronoiDiagram& vd, VertexDisjointSet& sets, std::vector<int> &oldToNewVertexIndex) {
+    const int numVertices = static_cast<int>(vd.vertices.size());
+    oldToNewVertexIndex.assign(numVertices, -1);
+    int numKept = 0;
+    for (int i = 0; i < numVertices; ++i) {
+        int root = sets.find(i);
+        if (sets.minMember[root] == i) {
+            vd.vertices.coords[numKept] = vd.vertices.coords[i];
+            vd.vertices.values[numKept] = vd.vertices.values[i];
+            oldToNewVertexIndex[i] = numKept++;
+        } else {
+            // The smallest member precedes i and is already numbered
+            oldToNewVertexIndex[i] = oldToNewVertexIndex[sets.minMember[root]];
         }
     }
-    vd.vertices = std::move(newVertices);
-
-    oldToNewVertexIndex.resize(mapto.size());
-    for (size_t i = 0; i < mapto.size(); ++i) {
-        oldToNewVertexIndex[i] = oldToNewIndex[mapto[i]];
-    }
+    vd.vertices.coords.resize(numKept);
+    vd.vertices.values.resize(numKept);
 }
 
-//! @brief Rebuilds edge list after vertex collapsing.
+//! @brief Remaps and deduplicates the edge list in place after vertex collapsing.
 /*!
- * Consolidates and deduplicates edges after vertex merging, handling:
- * - Segment edges (finite)
- * - Ray edges (semi-infinite)
- * - Line edges (bi-infinite)
- *
- * Edge processing:
- * 1. Segments: deduplicate using vertex pairs
- * 2. Rays/Lines: deduplicate using geometric equality
- * 3. Updates all vertex references
+ * Handles segments (finite), rays (semi-infinite) and lines (bi-infinite):
+ * 1. Segments: collapsed ones are dropped, duplicates found with the vertex-pair table
+ * 2. Rays/Lines: duplicates by remapped source vertex and direction, found by sorting
+ * 3. Surviving edges keep their relative order and their first Delaunay facet row
  *
  * @param vd Voronoi diagram to modify (edges updated)
  * @param oldToNewVertexIndex Vertex index mapping from rebuildVertices()
- * @note Rebuilds segmentVertexPairToEdgeIndex lookup table
+ * @note Rebuilds the segmentVertexPairToEdgeIndex table and edgeFacets
  */
-static void rebuildEdges(VoronoiDiagram& vd, std::vector<int> &oldToNewVertexIndex) {
-    std::map<std::pair<int, int>, int> segmentMap;
-    std::set<VoronoiEdge> rayLineSet;
-
-    // Process all edges to identify unique ones
-    for (size_t edgeIdx = 0; edgeIdx < vd.edges.size(); ++edgeIdx) {
-        const auto& edge = vd.edges[edgeIdx];
-        Segment3 seg;
-        Ray3 ray;
-        Line3 line;
-
-        if (CGAL::assign(seg, edge.edgeObject)) {
-            // Handle segments using vertex indices
-            int oldIdx1 = edge.vertex1;
-            int oldIdx2 = edge.vertex2;
-            if (oldIdx1 >= 0 && oldIdx2 >= 0) {
-                int newIdx1 = oldToNewVertexIndex[oldIdx1];
-                int newIdx2 = oldToNewVertexIndex[oldIdx2];
-                if (newIdx1 != newIdx2) { // Skip collapsed edges (same vertex)
-                    int v1 = std::min(newIdx1, newIdx2);
-                    int v2 = std::max(newIdx1, newIdx2);
-                    if (segmentMap.find({v1, v2}) == segmentMap.end()) {
-                        segmentMap[{v1, v2}] = edgeIdx;
-                    }
-                }
-            }
-        } else if (CGAL::assign(ray, edge.edgeObject) || CGAL::assign(line, edge.edgeObject)) {
-            // Handle rays and lines with geometric comparison
-            rayLineSet.insert(edge);
+static void rebuildEdges(VoronoiDiagram& vd, const std::vector<int> &oldToNewVertexIndex) {
+    const int numEdges = static_cast<int>(vd.edges.size());
+    std::vector<unsigned char> keep(numEdges, 0);
+    std::vector<int> rayLineEdges;
+    vd.segmentVertexPairToEdgeIndex.clear();
+
+    for (int edgeIdx = 0; edgeIdx < numEdges; ++edgeIdx) {
+        VoronoiEdge& edge = vd.edges[edgeIdx];
+        if (edge.vertex1 >= 0) edge.vertex1 = oldToNewVertexIndex[edge.vertex1];
+        if (edge.vertex2 >= 0) edge.vertex2 = oldToNewVertexIndex[edge.vertex2];
+
+        if (edge.type == 0) {
+            // Skip collapsed edges (same vertex) and duplicates of an earlier segment
+            if (edge.vertex1 < 0 || edge.vertex2 < 0 || edge.vertex1 == edge.vertex2) continue;
+            if (vd.segmentVertexPairToEdgeIndex.find(edge.vertex1, edge.vertex2) >= 0) continue;
+            vd.segmentVertexPairToEdgeIndex.set(edge.vertex1, edge.vertex2, edgeIdx);
+            keep[edgeIdx] = 1;
+        } else if (edge.type == 1 || edge.type == 2) {
+            rayLineEdges.push_back(edgeIdx);
         }
     }
 
-    // Rebuild the edges and edgeVertexIndices vectors
-    std::vector<VoronoiEdge> newEdges;
-    newEdges.reserve(segmentMap.size() + rayLineSet.size());
-
-    for (auto& kv : segmentMap) {
-        size_t edgeIdx = kv.second;
-        VoronoiEdge edge = vd.edges[edgeIdx];
-
-        edge.vertex1 = oldToNewVertexIndex[vd.edges[edgeIdx].vertex1];
-        edge.vertex2 = oldToNewVertexIndex[vd.edges[edgeIdx].vertex2];
-
-        newEdges.push_back(edge);
-    }
-    for (auto& edge : rayLineSet) {
-        newEdges.push_back(edge);
+    // Equal rays/lines become adjacent; the first of each run is kept
+    std::stable_sort(rayLineEdges.begin(), rayLineEdges.end(), [&](int a, int b) {
+        return vd.edges[a] < vd.edges[b];
+    });
+    for (size_t k = 0; k < rayLineEdges.size(); ++k) {
+        if (k == 0 || vd.edges[rayLineEdges[k - 1]] < vd.edges[rayLineEdges[k]])
+            keep[rayLineEdges[k]] = 1;
     }
 
-    vd.edges = std::move(newEdges);
-    vd.segmentVertexPairToEdgeIndex.clear();
-
-    // Rebuild segmentVertexPairToEdgeIndex
-    for (size_t edgeIdx = 0; edgeIdx < vd.edges.size(); ++edgeIdx) {
-        const auto& edge = vd.edges[edgeIdx];
-        if (edge.type == 0 && edge.vertex1 >= 0 && edge.vertex2 >= 0) {
-            int v1 = std::min(edge.vertex1, edge.vertex2);
-            int v2 = std::max(edge.vertex1, edge.vertex2);
-            vd.segmentVertexPairToEdgeIndex[{v1, v2}] = edgeIdx;
-        }
+    // Compact edges and their facet rows front to back
+    CsrArray<Facet>& edgeFacets = vd.edgeFacets;
+    int numKept = 0;
+    int facetEnd = 0;
+    for (int edgeIdx = 0; edgeIdx < numEdges; ++edgeIdx) {
+        if (!keep[edgeIdx]) continue;
+        const int fBegin = edgeFacets.offsets[edgeIdx];
+        const int fEnd = edgeFacets.offsets[edgeIdx + 1];
+        std::copy(edgeFacets.data.begin() + fBegin, edgeFacets.data.begin() + fEnd, edgeFacets.data.begin() + facetEnd);
+        facetEnd += fEnd - fBegin;
+        edgeFacets.offsets[numKept + 1] = facetEnd;
+        vd.edges[numKept] = vd.edges[edgeIdx];
+        if (vd.edges[numKept].type == 0)
+            vd.segmentVertexPairToEdgeIndex.set(vd.edges[numKept].vertex1, vd.edges[numKept].vertex2, numKept);
+        ++numKept;
     }
+    vd.edges.resize(numKept);
+    edgeFacets.offsets.resize(numKept + 1);
+    edgeFacets.data.resize(facetEnd);
 }
 
-// Standalone function to collapse small edges
-//! @brief Collapses small edges in a Voronoi diagram.
+//! @brief Collapses small edges of a Voronoi diagram in place.
 /*!
- * Processes a Voronoi diagram to merge vertices connected by edges shorter than D.
- * Uses union-find data structure to track vertex merges.
+ * Merges the endpoints of every finite edge not longer than D (transitively),
+ * compacts vertices and edges without copying the diagram, and points the
+ * Delaunay cells at the surviving Voronoi vertices. Must run before cells are
+ * built; any cell data present is cleared.
  *
- * @param input_vd Input Voronoi diagram
- * @param D Distance threshold for edge collapsing
- * @param bbox Bounding box of the diagram (unused)
- * @return New Voronoi diagram with small edges collapsed
+ * @param vd Voronoi diagram to modify
+ * @param D Distance threshold for edge collapsing; D <= 0 disables collapsing
+ * @param dt Delaunay triangulation whose dualVoronoiVertexIndex fields are remapped
  */
-VoronoiDiagram collapseSmallEdges(const VoronoiDiagram& input_vd, double D, const CGAL::Epick::Iso_cuboid_3& bbox) {
-    // Create a copy of the input VoronoiDiagram
-    VoronoiDiagram vd = input_vd;
+void collapseSmallEdges(VoronoiDiagram& vd, double D, Delaunay& dt) {
+    if (D <= 0.0) return;
 
     std::cout << "[DEBUG] Starting collapseSmallEdges with D = " << D << "\n";
     std::cout << "[DEBUG] Initial vertex count: " << vd.vertices.size() << ", edge count: " << vd.edges.size() << "\n";
 
-    // Initialize union-find structure
-    std::vector<int> mapto(vd.vertices.size());
-    for (size_t i = 0; i < mapto.size(); ++i) {
-        mapto[i] = i;
-    }
-
-    // Process edges to mark vertices for merging
-    processEdges(vd, mapto, D);
-
-    // Perform path compression
-    std::cout << "[DEBUG] Performing path compression\n";
-    compressMapping(mapto);
+    VertexDisjointSet sets(vd.vertices.size());
+    int merges = processEdges(vd, sets, D);
+    std::cout << "[DEBUG] Merged " << merges << " vertex pairs\n";
 
     std::vector<int> oldToNewVertexIndex;
-    // Rebuild vertices
-    std::cout << "[DEBUG] Rebuilding vertices\n";
-    rebuildVertices(vd, mapto, oldToNewVertexIndex);
+    rebuildVertices(vd, sets, oldToNewVertexIndex);
     std::cout << "[DEBUG] New vertex count: " << vd.vertices.size() << "\n";
 
-    // Rebuild vertexMap
-    vd.vertexMap.clear();
-    const double SCALE_FACTOR = 1e6;
-    for (size_t i = 0; i < vd.vertices.size(); ++i) {
-        const Point& p = vd.vertices[i].coord;
-        int ix = static_cast<int>(std::round(p.x() * SCALE_FACTOR));
-        int iy = static_cast<int>(std::round(p.y() * SCALE_FACTOR));
-        int iz = static_cast<int>(std::round(p.z() * SCALE_FACTOR));
-        std::tuple<int, int, int> key(ix, iy, iz);
-        vd.vertexMap[key].push_back(i);
-    }
+    // Rebuild the weld index in one bulk pass
+    vd.vertexWeld.build(vd.vertices.coords);
 
-    // Rebuild edges
-    std::cout << "[DEBUG] Rebuilding edges with duplicate removal\n";
     rebuildEdges(vd, oldToNewVertexIndex);
     std::cout << "[DEBUG] New edge count: " << vd.edges.size() << "\n";
-    std::cout << "[DEBUG] Cleared segmentVertexPairToEdgeIndex\n";
+
+    // Delaunay cells refer to the surviving vertices from now on
+    for (auto cit = dt.finite_cells_begin(); cit != dt.finite_cells_end(); ++cit) {
+        int &vertexIndex = cit->info().dualVoronoiVertexIndex;
+        if (vertexIndex >= 0 && vertexIndex < static_cast<int>(oldToNewVertexIndex.size()))
+            vertexIndex = oldToNewVertexIndex[vertexIndex];
+    }
 
     // Clear cell edges and related mappings (since cells/facets may need reconstruction)
     vd.cellEdges.clear();
     vd.cellEdgeLookup.clear();
     vd.cells.clear();
-    vd.facets.clear();
-
-    return vd;
+    vd.facetVertices.clear();
+    vd.cellVertices.clear();
+    vd.cellFacets.clear();
+    vd.cellEdgeCycles.clear();
+    vd.cycles.clear();
+    vd.cycleMidpoints.clear();
+    vd.vertexCells.clear();
+    vd.clippedEdges.clear();
+    for (VoronoiEdge &edge : vd.edges)
+        edge.clipIndex = -1;
 }
 
 
 
+//! @brief Rebuilds cellEdgeLookup from cellEdges.
+/*!
+ * One row per cell holding (edgeIndex, cellEdges index) pairs sorted by edge
+ * index, built with two counting passes. findCellEdge() then answers a
+ * (cell, edge) query with a binary search over the few edges of one cell.
+ */
+void VoronoiDiagram::buildCellEdgeLookup()
+{
+    cellEdgeLookup.startCounts(cells.size());
+    for (const VoronoiCellEdge &ce : cellEdges)
+        cellEdgeLookup.count(ce.cellIndex);
+    cellEdgeLookup.allocate();
+    for (int ceIdx = 0; ceIdx < static_cast<int>(cellEdges.size()); ++ceIdx)
+        cellEdgeLookup.fill(cellEdges[ceIdx].cellIndex, {cellEdges[ceIdx].edgeIndex, ceIdx});
+    cellEdgeLookup.finish();
+
+    // Cell edges are usually emitted by increasing edge index already
+    for (int ci = 0; ci < static_cast<int>(cellEdgeLookup.rows()); ++ci)
+    {
+        CsrSpan<std::pair<int, int>> row = cellEdgeLookup.row(ci);
+        if (!std::is_sorted(row.begin(), row.end()))
+            std::sort(row.begin(), row.end());
+    }
+}
+
 //! @brief Checks internal consistency of the VoronoiDiagram.
 /*!
- * Performs comprehensive validation of the Voronoi diagram data structure,
- * including topological, geometric and combinatorial properties.
- *
- * Validation stages:
- * 1. Cell-edge lookup consistency
- * 2. Next-cell-edge pointer validity
- * 3. Cell facet relationships
- * 4. Advanced geometric checks
+ * Runs validate() at the full level and prints its JSON summary.
  *
  * @throws std::runtime_error if any inconsistency is detected
  * @note This is an expensive operation (O(V+E+F) time complexity)
  */
 void VoronoiDiagram::check() const
 {
-    std::cout << "Running validity checks.\n";
-    checkCellEdgeLookup();
-    checkNextCellEdgeConsistency();
-    checkCellFacets();
-    checkAdvanced();
-    std::cout << "VoronoiDiagram::check() passed all advanced checks.\n";
+    ValidationReport report = validate(ValidationLevel::Full);
+    std::cout << report.toJson() << "\n";
+    if (!report.ok())
+        throw std::runtime_error("VoronoiDiagram::check() found " + std::to_string(report.violations()) + " violation(s).");
+}
+
+//! @brief Runs the checks of the given level and collects their outcomes.
+/*!
+ * Levels:
+ * - None: nothing is checked.
+ * - Cheap: linear-time invariants (index ranges, facet and cell counts,
+ *   nextCellEdge targets). Intended to run on every build.
+ * - Full: every check, including the cell edge rings, facet membership and
+ *   the orientation predicates.
+ *
+ * The checks only read the diagram, so they are run concurrently; each one
+ * catches its own exception and records the message. Results are kept in
+ * the fixed order of the check table, independent of scheduling.
+ *
+ * @param level Validation level
+ * @return Report holding one result per check that was run
+ */
+ValidationReport VoronoiDiagram::validate(ValidationLevel level) const
+{
+    struct CheckEntry
+    {
+        const char *name;
+        void (VoronoiDiagram::*run)() const;
+        bool cheap;
+    };
+    static const CheckEntry table[] = {
+        {"indexRanges", &VoronoiDiagram::checkIndexRanges, true},
+        {"facetVertexCount", &VoronoiDiagram::checkFacetVertexCount, true},
+        {"cellFacetCount", &VoronoiDiagram::checkCellFacetCount, true},
+        {"nextCellEdgeValidity", &VoronoiDiagram::checkNextCellEdgeValidity, true},
+        {"cellEdgeLookup", &VoronoiDiagram::checkCellEdgeLookup, false},
+        {"edgeCycles", &VoronoiDiagram::checkEdgeCycles, false},
+        {"cellFacets", &VoronoiDiagram::checkCellFacets, false},
+        {"facetCellCount", &VoronoiDiagram::checkFacetCellCount, false},
+        {"edgeFacetCount", &VoronoiDiagram::checkEdgeFacetCount, false},
+        {"facetNormals", &VoronoiDiagram::checkFacetNormals, false},
+        {"pairedFacetOrientations", &VoronoiDiagram::checkPairedFacetOrientations, false},
+    };
+
+    ValidationReport report;
+    report.level = level;
+    if (level == ValidationLevel::None)
+        return report;
+
+    std::vector<const CheckEntry *> selected;
+    for (const CheckEntry &entry : table)
+    {
+        if (entry.cheap || level == ValidationLevel::Full)
+            selected.push_back(&entry);
+    }
+    report.results.resize(selected.size());
+
+    auto start = std::chrono::steady_clock::now();
+    const int numChecks = static_cast<int>(selected.size());
+#pragma omp parallel for schedule(dynamic, 1)
+    for (int i = 0; i < numChecks; ++i)
+    {
+        ValidationResult &result = report.results[i];
+        result.name = selected[i]->name;
+        auto t0 = std::chrono::steady_clock::now();
+        try
+        {
+            (this->*(selected[i]->run))();
+        }
+        catch (const std::exception &e)
+        {
+            result.passed = false;
+            result.message = e.what();
+        }
+        result.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    }
+    report.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return report;
+}
+
+//! @brief Escapes a string for use inside a JSON string literal.
+static std::string jsonEscape(const std::string &text)
+{
+    std::string out;
+    out.reserve(text.size());
+    for (unsigned char c : text)
+    {
+        switch (c)
+        {
+        case '"':
+            out += "\\\"";
+            break;
+        case '\\':
+            out += "\\\\";
+            break;
+        case '\n':
+            out += "\\n";
+            break;
+        case '\t':
+            out += "\\t";
+            break;
+        default:
+            if (c < 0x20)
+            {
+                char buf[8];
+                std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                out += buf;
+            }
+            else
+            {
+                out += static_cast<char>(c);
+            }
+        }
+    }
+    return out;
+}
+
+//! @brief One-line JSON summary of the report.
+/*!
+ * Format:
+ *
+ *     {"validation":{"level":"cheap","ok":true,"violations":0,"ms":1.2,
+ *      "checks":[{"name":"indexRanges","passed":true,"ms":0.3,"message":""},...]}}
+ */
+std::string ValidationReport::toJson() const
+{
+    static const char *levelNames[] = {"none", "cheap", "full"};
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(3);
+    out << "{\"validation\":{\"level\":\"" << levelNames[static_cast<int>(level)] << "\""
+        << ",\"ok\":" << (ok() ? "true" : "false")
+        << ",\"violations\":" << violations()
+        << ",\"ms\":" << ms
+        << ",\"checks\":[";
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const ValidationResult &r = results[i];
+        out << (i ? "," : "")
+            << "{\"name\":\"" << jsonEscape(r.name) << "\""
+            << ",\"passed\":" << (r.passed ? "true" : "false")
+            << ",\"ms\":" << r.ms
+            << ",\"message\":\"" << jsonEscape(r.message) << "\"}";
+    }
+    out << "]}}";
+    return out.str();
+}
+
+//! @brief Checks that every stored index refers to an existing element.
+/*!
+ * Checks performed:
+ * 1. Edge vertex indices are valid for the edge type
+ * 2. edgeFacets has one row per edge
+ * 3. Facet vertex indices are valid
+ * 4. Cell relations have one row per cell and refer to valid facets and vertices
+ *
+ * @throws std::runtime_error on the first out-of-range index
+ * @note O(V+E+F) time, no allocation
+ */
+void VoronoiDiagram::checkIndexRanges() const
+{
+    const int numVertices = static_cast<int>(vertices.size());
+    auto validVertex = [numVertices](int v)
+    { return v >= 0 && v < numVertices; };
+
+    if (vertices.values.size() != vertices.coords.size() && !vertices.values.empty())
+        throw std::runtime_error("Vertex value array size " + std::to_string(vertices.values.size()) +
+                                 " does not match vertex count " + std::to_string(numVertices) + ".");
+
+    for (size_t ei = 0; ei < edges.size(); ++ei)
+    {
+        const VoronoiEdge &edge = edges[ei];
+        if (edge.type < 0 || edge.type > 2 || !validVertex(edge.vertex1) ||
+            (edge.type == 0 && !validVertex(edge.vertex2)))
+            throw std::runtime_error("Edge " + std::to_string(ei) + " has an invalid type or vertex index.");
+    }
+    if (edgeFacets.rows() != edges.size())
+        throw std::runtime_error("edgeFacets has " + std::to_string(edgeFacets.rows()) +
+                                 " rows for " + std::to_string(edges.size()) + " edges.");
+
+    for (int v : facetVertices.data)
+    {
+        if (!validVertex(v))
+            throw std::runtime_error("Facet vertex index " + std::to_string(v) + " is out of range.");
+    }
+
+    if (cells.empty())
+        return;
+    if (cellVertices.rows() != cells.size() || cellFacets.rows() != cells.size())
+        throw std::runtime_error("Cell relations do not have one row per cell.");
+    for (int v : cellVertices.data)
+    {
+        if (!validVertex(v))
+            throw std::runtime_error("Cell vertex index " + std::to_string(v) + " is out of range.");
+    }
+    for (const auto &ref : cellFacets.data)
+    {
+        if (ref.facet_index < 0 || ref.facet_index >= numFacets() ||
+            (ref.orientation != 1 && ref.orientation != -1))
+            throw std::runtime_error("Cell facet reference " + std::to_string(ref.facet_index) + " is invalid.");
+    }
+    for (const VoronoiCellEdge &ce : cellEdges)
+    {
+        if (ce.cellIndex < 0 || ce.cellIndex >= static_cast<int>(cells.size()) ||
+            ce.edgeIndex < 0 || ce.edgeIndex >= static_cast<int>(edges.size()))
+            throw std::runtime_error("Cell edge refers to an invalid cell or edge.");
+    }
 }
 
 //! @brief Verifies that `cellEdgeLookup` matches the data in `cellEdges`.
@@ -618,28 +717,36 @@ void VoronoiDiagram::check() const
  */
 void VoronoiDiagram::checkCellEdgeLookup() const
 {
-    for (const auto &kv : cellEdgeLookup)
+    for (int ic = 0; ic < static_cast<int>(cellEdgeLookup.rows()); ++ic)
     {
-        // kv.first is (ic, ie) and kv.second is the index in cellEdges.
-        int ic = kv.first.first;  // cellIndex
-        int ie = kv.first.second; // edgeIndex
-        int cellEdgeIdx = kv.second;
-
-        if (cellEdgeIdx < 0 || cellEdgeIdx >= static_cast<int>(cellEdges.size()))
+        CsrSpan<const std::pair<int, int>> row = cellEdgeLookup.row(ic);
+        for (size_t k = 0; k < row.size(); ++k)
         {
-            throw std::runtime_error("cellEdgeLookup points to invalid VoronoiCellEdge index.");
-        }
+            // row[k] is (edgeIndex, index in cellEdges).
+            int ie = row[k].first;
+            int cellEdgeIdx = row[k].second;
 
-        const VoronoiCellEdge &ce = cellEdges[cellEdgeIdx];
+            if (k > 0 && row[k - 1].first >= ie)
+            {
+                throw std::runtime_error("cellEdgeLookup row is not sorted by edge index.");
+            }
 
-        if (ce.cellIndex != ic || ce.edgeIndex != ie)
-        {
-            std::cerr << "ERROR: cellEdgeLookup mismatch!\n";
-            std::cerr << "  Lookup says (cell=" << ic << ", edge=" << ie
-                      << ") => cellEdgeIdx=" << cellEdgeIdx << "\n";
-            std::cerr << "  But VoronoiCellEdge at cellEdgeIdx has (cellIndex="
-                      << ce.cellIndex << ", edgeIndex=" << ce.edgeIndex << ")\n";
-            throw std::runtime_error("Inconsistent cellEdgeLookup data.");
+            if (cellEdgeIdx < 0 || cellEdgeIdx >= static_cast<int>(cellEdges.size()))
+            {
+                throw std::runtime_error("cellEdgeLookup points to invalid VoronoiCellEdge index.");
+            }
+
+            const VoronoiCellEdge &ce = cellEdges[cellEdgeIdx];
+
+            if (ce.cellIndex != ic || ce.edgeIndex != ie)
+            {
+                std::cerr << "ERROR: cellEdgeLookup mismatch!\n";
+                std::cerr << "  Lookup says (cell=" << ic << ", edge=" << ie
+                          << ") => cellEdgeIdx=" << cellEdgeIdx << "\n";
+                std::cerr << "  But VoronoiCellEdge at cellEdgeIdx has (cellIndex="
+                          << ce.cellIndex << ", edgeIndex=" << ce.edgeIndex << ")\n";
+                throw std::runtime_error("Inconsistent cellEdgeLookup data.");
+            }
         }
     }
 }
@@ -699,24 +806,29 @@ void VoronoiDiagram::checkNextCellEdgeValidity() const
  */
 void VoronoiDiagram::checkEdgeCycles() const
 {
-    std::unordered_map<int, std::vector<int>> edgeIndexToCellEdges;
-    for (int ceIdx = 0; ceIdx < static_cast<int>(cellEdges.size()); ++ceIdx)
+    // Per edge: number of cell edges and the first one, in two flat arrays.
+    const int numCellEdges = static_cast<int>(cellEdges.size());
+    std::vector<int> ringSize(edges.size(), 0);
+    std::vector<int> ringStart(edges.size(), -1);
+    for (int ceIdx = 0; ceIdx < numCellEdges; ++ceIdx)
     {
         int eIdx = cellEdges[ceIdx].edgeIndex;
-        edgeIndexToCellEdges[eIdx].push_back(ceIdx);
+        if (eIdx < 0 || eIdx >= static_cast<int>(edges.size()))
+            throw std::runtime_error("Cell edge " + std::to_string(ceIdx) + " has an invalid edge index.");
+        if (ringSize[eIdx]++ == 0)
+            ringStart[eIdx] = ceIdx;
     }
 
-    for (const auto &kv : edgeIndexToCellEdges)
+    // visitedBy[ce] holds the edge whose ring walk last reached ce.
+    std::vector<int> visitedBy(numCellEdges, -1);
+    for (int eIdx = 0; eIdx < static_cast<int>(edges.size()); ++eIdx)
     {
-        const int eIdx = kv.first;
-        const auto &ceIndices = kv.second;
-        if (ceIndices.empty())
+        const int start = ringStart[eIdx];
+        if (start < 0)
             continue;
 
-        int start = ceIndices[0];
-        std::set<int> visited;
-        visited.insert(start);
-
+        visitedBy[start] = eIdx;
+        int visited = 1;
         int current = cellEdges[start].nextCellEdge;
         while (current != start)
         {
@@ -726,23 +838,25 @@ void VoronoiDiagram::checkEdgeCycles() const
                           << " do not form a complete cycle (nextCellEdge=-1 encountered).\n";
                 throw std::runtime_error("Incomplete ring around an edge.");
             }
-            if (visited.find(current) != visited.end())
+            if (current >= numCellEdges)
+                throw std::runtime_error("Invalid nextCellEdge index.");
+            if (visitedBy[current] == eIdx)
             {
                 std::cerr << "ERROR: The edges for edgeIndex=" << eIdx
                           << " contain a sub-loop. Edge " << current
                           << " was already visited.\n";
                 throw std::runtime_error("Multiple loops or early cycle detected.");
             }
-            visited.insert(current);
-            const VoronoiCellEdge &ceNext = cellEdges[current];
-            current = ceNext.nextCellEdge;
+            visitedBy[current] = eIdx;
+            ++visited;
+            current = cellEdges[current].nextCellEdge;
         }
 
-        if (visited.size() != ceIndices.size())
+        if (visited != ringSize[eIdx])
         {
             std::cerr << "ERROR: For edgeIndex=" << eIdx
-                      << ", visited " << visited.size()
-                      << " edges, but we expected " << ceIndices.size() << ".\n"
+                      << ", visited " << visited
+                      << " edges, but we expected " << ringSize[eIdx] << ".\n"
                       << "Implying there's a second disconnected cycle or missing edges.\n";
             throw std::runtime_error("Ring does not include all edges for edgeIndex.");
         }
@@ -771,28 +885,26 @@ void VoronoiDiagram::checkNextCellEdgeConsistency() const
  * 3. No dangling references
  *
  * @throws std::runtime_error if any vertex-facet inconsistency is found
- * @note O(F*V) time complexity in worst case
+ * @note Cell vertex rows are sorted, so membership is a binary search
  */
 void VoronoiDiagram::checkCellFacets() const
 {
     for (int cIdx = 0; cIdx < static_cast<int>(cells.size()); ++cIdx)
     {
-        const VoronoiCell &cell = cells[cIdx];
-        // Build a set of the cell's vertex indices for quick membership testing.
-        std::set<int> cellVertexSet(cell.vertices_indices.begin(), cell.vertices_indices.end());
+        CsrSpan<const int> cellVertexSet = cellVertices.row(cIdx);
 
-        for (int fIdx : cell.facet_indices)
+        for (const auto &ref : cellFacets.row(cIdx))
         {
-            if (fIdx < 0 || fIdx >= static_cast<int>(facets.size()))
+            int fIdx = ref.facet_index;
+            if (fIdx < 0 || fIdx >= numFacets())
             {
                 std::cerr << "ERROR: cell " << cIdx << " has invalid facet index " << fIdx << "\n";
                 throw std::runtime_error("Facet index out of range.");
             }
 
-            const VoronoiCellFacet &facet = facets[fIdx];
-            for (int vIdx : facet.vertices_indices)
+            for (int vIdx : facetVertices.row(fIdx))
             {
-                if (cellVertexSet.find(vIdx) == cellVertexSet.end())
+                if (!std::binary_search(cellVertexSet.begin(), cellVertexSet.end(), vIdx))
                 {
                     std::cerr << "ERROR: VoronoiFacet " << fIdx
                               << " has vertex " << vIdx
@@ -808,69 +920,6 @@ void VoronoiDiagram::checkCellFacets() const
 // Helper implementations for checks
 // ————————————————————————————————————————————————————————————————
 
-//! @brief Generates a hash key for a facet based on its vertices.
-/*!
- * Creates a canonical representation of a facet by selecting three
- * representative vertices in sorted order. Used for facet deduplication
- * and mirror facet identification.
- *
- * Key properties:
- * - Order-invariant (same key for any vertex ordering)
- * - Uses smallest three indices for consistency
- * - Suitable for use as map key
- *
- * @param verts Vector of vertex indices (must have >= 3 elements)
- * @return Tuple of three smallest indices in ascending order
- * @throws std::invalid_argument if verts has fewer than 3 elements
- */
-std::tuple<int, int, int> VoronoiDiagram::getFacetHashKey(const std::vector<int> &verts) const
-{
-    // pick three smallest indices
-    std::array<int, 3> a;
-    std::vector<int> tmp = verts;
-    std::sort(tmp.begin(), tmp.end());
-    a = {tmp[0], tmp[1], tmp[2]};
-    return std::make_tuple(a[0], a[1], a[2]);
-}
-
-//! @brief Checks if two facets have the same vertex ordering.
-/*!
- * Determines if two facets have identical vertex sequences (considering cyclic shifts).
- * Used to verify proper orientation of mirror facets.
- *
- * Algorithm:
- * - Checks all possible cyclic shifts of f2 against f1
- * - Early termination on first match
- *
- * @param f1 First facet's vertex indices
- * @param f2 Second facet's vertex indices
- * @return true if sequences match under any cyclic shift
- * @note O(n²) time complexity for n-vertex facets
- */
-bool VoronoiDiagram::haveSameOrientation(const std::vector<int> &f1,
-                                         const std::vector<int> &f2) const
-{
-    if (f1.size() != f2.size())
-        return false;
-    int n = (int)f1.size();
-    // try every cyclic shift
-    for (int shift = 0; shift < n; ++shift)
-    {
-        bool ok = true;
-        for (int i = 0; i < n; ++i)
-        {
-            if (f1[i] != f2[(i + shift) % n])
-            {
-                ok = false;
-                break;
-            }
-        }
-        if (ok)
-            return true;
-    }
-    return false;
-}
-
 //! @brief Verifies all facets have at least 3 vertices.
 /*!
  * Validates the minimum vertex count requirement for Voronoi facets.
@@ -885,10 +934,9 @@ bool VoronoiDiagram::haveSameOrientation(const std::vector<int> &f1,
  */
 void VoronoiDiagram::checkFacetVertexCount() const
 {
-    for (size_t fi = 0; fi < facets.size(); ++fi)
+    for (int fi = 0; fi < numFacets(); ++fi)
     {
-        auto const &F = facets[fi].vertices_indices;
-        if (F.size() < 3)
+        if (facetVertices.rowSize(fi) < 3)
             throw std::runtime_error("Facet " + std::to_string(fi) +
                                      " has fewer than 3 vertices.");
     }
@@ -910,7 +958,7 @@ void VoronoiDiagram::checkCellFacetCount() const
 {
     for (size_t ci = 0; ci < cells.size(); ++ci)
     {
-        if (cells[ci].facet_indices.size() < 4)
+        if (cellFacets.rowSize(static_cast<int>(ci)) < 4)
             throw std::runtime_error("Cell " + std::to_string(ci) +
                                      " has fewer than 4 facets.");
     }
@@ -922,23 +970,19 @@ void VoronoiDiagram::checkCellFacetCount() const
  * Ensures the Voronoi diagram forms a valid cell complex.
  *
  * Sharing properties:
- * - Each facet shared by exactly 2 cells (in 3D)
- * - No unshared or multiply-shared facets
+ * - Each facet referenced by at most 2 cells (in 3D)
+ * - Boundary facets (next to dropped or dummy cells) referenced once
  *
  * @throws std::runtime_error if facet sharing is invalid
- * @note Uses spatial hashing for efficient facet lookup
  */
 void VoronoiDiagram::checkFacetCellCount() const
 {
-    std::map<std::tuple<int, int, int>, std::vector<int>> hashToFacets;
-    for (size_t fi = 0; fi < facets.size(); ++fi)
+    std::vector<int> refCount(numFacets(), 0);
+    for (const auto &ref : cellFacets.data)
     {
-        auto key = getFacetHashKey(facets[fi].vertices_indices);
-        hashToFacets[key].push_back((int)fi);
-        if (hashToFacets[key].size() > 2)
-            throw std::runtime_error("Facet with hash “" + std::to_string(std::get<0>(key)) + "," +
-                                     std::to_string(std::get<1>(key)) + "," + std::to_string(std::get<2>(key)) +
-                                     "” appears in >2 cells.");
+        if (++refCount[ref.facet_index] > 2)
+            throw std::runtime_error("Facet " + std::to_string(ref.facet_index) +
+                                     " appears in >2 cells.");
     }
 }
 
@@ -952,38 +996,41 @@ void VoronoiDiagram::checkFacetCellCount() const
  * - Forms complete facet boundaries
  * - No dangling edges
  *
+ * Facets are walked in the orientation given by the cell's facet reference.
+ * Directed edges are collected into one reused buffer and sorted, so no
+ * per-cell map is allocated.
+ *
  * @throws std::runtime_error if edge-facet relationships are invalid
  * @note Essential for watertight mesh generation
  */
 void VoronoiDiagram::checkEdgeFacetCount() const {
-    for (const auto &cell : cells) {
-        std::map<std::pair<int, int>, int> edge_count;
-        for (int facet_idx : cell.facet_indices) {
-            const auto &vertices = facets[facet_idx].vertices_indices;
-            for (size_t i = 0; i < vertices.size(); ++i) {
-                int u = vertices[i];
-                int v = vertices[(i + 1) % vertices.size()];
-                std::pair<int, int> edge = {std::min(u, v), std::max(u, v)};
-                edge_count[edge]++;
+    // (min vertex, max vertex, 1 if walked min->max else 0)
+    std::vector<std::array<int, 3>> directed;
+    for (int ci = 0; ci < static_cast<int>(cells.size()); ++ci) {
+        const VoronoiCell &cell = cells[ci];
+        directed.clear();
+        for (const auto &ref : cellFacets.row(ci)) {
+            const int n = facetVertices.rowSize(ref.facet_index);
+            for (int i = 0; i < n; ++i) {
+                int a = facetVertex(ref, i);
+                int b = facetVertex(ref, i + 1);
+                directed.push_back({std::min(a, b), std::max(a, b), a < b ? 1 : 0});
             }
         }
-        for (const auto &[edge, count] : edge_count) {
-            if (count == 2) { // Internal edge
-                int u = edge.first;
-                int v = edge.second;
-                int uv_count = 0, vu_count = 0;
-                for (int facet_idx : cell.facet_indices) {
-                    const auto &vertices = facets[facet_idx].vertices_indices;
-                    for (size_t i = 0; i < vertices.size(); ++i) {
-                        if (vertices[i] == u && vertices[(i + 1) % vertices.size()] == v) uv_count++;
-                        if (vertices[i] == v && vertices[(i + 1) % vertices.size()] == u) vu_count++;
-                    }
-                }
-                if (uv_count != 1 || vu_count != 1) {
-                    throw std::runtime_error("In cell " + std::to_string(cell.cellIndex) + 
-                                             " edge {" + std::to_string(u) + "," + std::to_string(v) + 
-                                             "} does not have opposite orientations.");
-                }
+        std::sort(directed.begin(), directed.end());
+        for (size_t i = 0; i < directed.size();) {
+            size_t j = i;
+            int count = 0;    // occurrences of (u,v), u < v
+            int vu_count = 0; // occurrences of (v,u)
+            for (; j < directed.size() && directed[j][0] == directed[i][0] && directed[j][1] == directed[i][1]; ++j)
+                (directed[j][2] ? count : vu_count)++;
+            int u = directed[i][0];
+            int v = directed[i][1];
+            i = j;
+            if (count + vu_count == 2 && (count != 1 || vu_count != 1)) {
+                throw std::runtime_error("In cell " + std::to_string(cell.cellIndex) + 
+                                         " edge {" + std::to_string(u) + "," + std::to_string(v) + 
+                                         "} does not have opposite orientations.");
             }
         }
     }
@@ -1003,17 +1050,17 @@ void VoronoiDiagram::checkEdgeFacetCount() const {
  */
 void VoronoiDiagram::checkFacetNormals() const
 {
-    for (const auto &cell : cells)
+    for (int ci = 0; ci < static_cast<int>(cells.size()); ++ci)
     {
+        const VoronoiCell &cell = cells[ci];
         auto p = cell.delaunay_vertex->point();
-        for (int fi : cell.facet_indices)
+        for (const auto &ref : cellFacets.row(ci))
         {
-            auto const &V = facets[fi].vertices_indices;
-            const auto &P1 = vertices[V[0]].coord;
-            const auto &P2 = vertices[V[1]].coord;
-            const auto &P3 = vertices[V[2]].coord;
+            const auto &P1 = vertices.coords[facetVertex(ref, 0)];
+            const auto &P2 = vertices.coords[facetVertex(ref, 1)];
+            const auto &P3 = vertices.coords[facetVertex(ref, 2)];
             if (CGAL::orientation(P1, P2, P3, p) != CGAL::NEGATIVE)
-                throw std::runtime_error("Facet " + std::to_string(fi) +
+                throw std::runtime_error("Facet " + std::to_string(ref.facet_index) +
                                          " in cell " + std::to_string(cell.cellIndex) +
                                          " has inward‐pointing normal.");
         }
@@ -1022,36 +1069,30 @@ void VoronoiDiagram::checkFacetNormals() const
 
 //! @brief Verifies paired facets have opposite orientations.
 /*!
- * Validates the orientation consistency of mirror facets.
+ * Validates the orientation consistency of shared facets.
  * Ensures proper surface normal continuity across cell boundaries.
  *
  * Mirror properties:
- * - Shared facets must have opposite winding orders
+ * - The two references to a shared facet must carry opposite signs
  * - Maintains consistent surface orientation
  *
- * @throws std::runtime_error if mirror facets have same orientation
+ * @throws std::runtime_error if both cells see a facet with the same orientation
  * @note Preserves manifold property of the diagram
  */
 void VoronoiDiagram::checkPairedFacetOrientations() const
 {
-    std::map<std::tuple<int, int, int>, std::vector<int>> hashToFacets;
-    for (size_t fi = 0; fi < facets.size(); ++fi)
+    std::vector<int> orientationSum(numFacets(), 0);
+    std::vector<int> refCount(numFacets(), 0);
+    for (const auto &ref : cellFacets.data)
     {
-        auto key = getFacetHashKey(facets[fi].vertices_indices);
-        hashToFacets[key].push_back((int)fi);
+        orientationSum[ref.facet_index] += ref.orientation;
+        refCount[ref.facet_index]++;
     }
-    for (auto const &kv : hashToFacets)
+    for (int fi = 0; fi < numFacets(); ++fi)
     {
-        auto const &fvec = kv.second;
-        if (fvec.size() == 2)
-        {
-            auto &A = facets[fvec[0]].vertices_indices;
-            auto &B = facets[fvec[1]].vertices_indices;
-            if (haveSameOrientation(A, B))
-                throw std::runtime_error("Facet “" + std::to_string(fvec[0]) + "” and “" +
-                                         std::to_string(fvec[1]) +
-                                         "” have the SAME orientation in their two cells.");
-        }
+        if (refCount[fi] == 2 && orientationSum[fi] != 0)
+            throw std::runtime_error("Facet “" + std::to_string(fi) +
+                                     "” has the SAME orientation in its two cells.");
     }
 }
 
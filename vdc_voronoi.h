@@ -6,42 +6,169 @@
 
 #include "vdc_type.h"
 #include "vdc_delaunay.h"
+#include "vdc_csr.h"
+#include "vdc_hash.h"
+#include "vdc_weld.h"
 #include <utility>             // for std::make_tuple
 
-//! @brief Represents a vertex in a Voronoi diagram.
+//! @brief Vertices of a Voronoi diagram in structure-of-arrays form.
 /*!
- * A Voronoi vertex is a point where multiple Voronoi edges meet. Each vertex
- * may belong to multiple Voronoi cells.
+ * Coordinates are a packed array of points (three doubles each) and scalar
+ * values a separate float array, so passes that only test values (such as
+ * bipolarity) stream 4 bytes per vertex. Vertex `i` is `coords[i]`,
+ * `values[i]`; the cells containing it are VoronoiDiagram::vertexCells.
  */
-struct VoronoiVertex
+struct VoronoiVertexArray
 {
-    Point coord;                 //!< Geometric coordinates of the vertex.
-    int index;                    //!< The index of the vertex in the Voronoi diagram
-    float value;                  //!< The scalar value of the vertex, used for isosurface extraction
-    std::vector<int> cellIndices; //!< Indices of Voronoi cells that contain this vertex.
+    std::vector<Point> coords; //!< Geometric coordinates of each vertex.
+    std::vector<float> values; //!< Scalar value of each vertex, used for isosurface extraction.
 
-    //! @brief Constructor to initialize a Voronoi vertex.
+    //! @brief Number of vertices.
+    size_t size() const { return coords.size(); }
+
+    //! @brief True if there are no vertices.
+    bool empty() const { return coords.empty(); }
+
+    //! @brief Removes all vertices.
+    void clear()
+    {
+        coords.clear();
+        values.clear();
+    }
+
+    //! @brief Reserves storage for `n` vertices.
+    void reserve(size_t n)
+    {
+        coords.reserve(n);
+        values.reserve(n);
+    }
+
+    //! @brief Appends a vertex and returns its index.
+    int add(const Point &p, float value = 0.0f)
+    {
+        coords.push_back(p);
+        values.push_back(value);
+        return static_cast<int>(coords.size()) - 1;
+    }
+
+    //! @brief Marks each vertex whose value is at or above the isovalue.
     /*!
-     * @param p Coordinates of the vertex.
+     * An edge (a, b) is bipolar exactly when `above[a] != above[b]`, matching
+     * is_bipolar(). The loop touches only the value array and vectorizes.
+     *
+     * @param isovalue The isovalue.
+     * @param above Output flags, resized to size().
      */
-    VoronoiVertex(Point p) : coord(p) {}
+    void classify(float isovalue, std::vector<unsigned char> &above) const
+    {
+        const size_t n = values.size();
+        above.resize(n);
+        const float *v = values.data();
+        unsigned char *out = above.data();
+        for (size_t i = 0; i < n; ++i)
+            out[i] = static_cast<unsigned char>(v[i] >= isovalue);
+    }
+
+    //! @brief Approximate heap footprint in bytes.
+    size_t bytes() const
+    {
+        return coords.capacity() * sizeof(Point) + values.capacity() * sizeof(float);
+    }
+};
+
+//! @brief Clips the ray or line `origin + t * dir` to an axis-aligned box.
+/*!
+ * Slab method: the parameter interval is intersected with the slab of each
+ * axis using min/max only. The only branch is for an axis the direction is
+ * parallel to, where the origin must lie inside the slab.
+ *
+ * @param origin Source of the ray, or a point on the line.
+ * @param dir Direction (need not be normalized).
+ * @param isLine True for a line (t unbounded below), false for a ray (t >= 0).
+ * @param boxMin Minimum corner of the box.
+ * @param boxMax Maximum corner of the box.
+ * @param source Output entry point.
+ * @param target Output exit point.
+ * @return True if the clipped part has positive length.
+ */
+inline bool clipToBox(const Point &origin, const Vector3 &dir, bool isLine,
+                      const Point &boxMin, const Point &boxMax,
+                      Point &source, Point &target)
+{
+    const double o[3] = {origin.x(), origin.y(), origin.z()};
+    const double d[3] = {dir.x(), dir.y(), dir.z()};
+    const double lo[3] = {boxMin.x(), boxMin.y(), boxMin.z()};
+    const double hi[3] = {boxMax.x(), boxMax.y(), boxMax.z()};
+
+    double tEnter = isLine ? -std::numeric_limits<double>::infinity() : 0.0;
+    double tExit = std::numeric_limits<double>::infinity();
+    for (int a = 0; a < 3; ++a)
+    {
+        if (d[a] == 0.0)
+        {
+            if (o[a] < lo[a] || o[a] > hi[a])
+                return false;
+            continue;
+        }
+        const double inv = 1.0 / d[a];
+        const double t1 = (lo[a] - o[a]) * inv;
+        const double t2 = (hi[a] - o[a]) * inv;
+        tEnter = std::max(tEnter, std::min(t1, t2));
+        tExit = std::min(tExit, std::max(t1, t2));
+    }
+    if (!(tExit > tEnter) || std::isinf(tEnter) || std::isinf(tExit))
+        return false;
+
+    source = Point(o[0] + tEnter * d[0], o[1] + tEnter * d[1], o[2] + tEnter * d[2]);
+    target = Point(o[0] + tExit * d[0], o[1] + tExit * d[1], o[2] + tExit * d[2]);
+    if (!isLine && tEnter == 0.0)
+        source = origin; // Keep the source vertex bit-exact
+    return true;
+}
+
+//! @brief Part of a ray or line edge inside the bounding box.
+/*!
+ * Computed once per unbounded edge by clip_unbounded_edges(); the scalar
+ * values are filled in by compute_clipped_edge_values().
+ */
+struct ClippedEdge
+{
+    Point source;            //!< Entry point (the source vertex for rays starting inside the box)
+    Point target;            //!< Exit point
+    int sourceVertex = -1;   //!< Voronoi vertex at `source`, or -1
+    int targetVertex = -1;   //!< Voronoi vertex at `target`, or -1
+    float sourceValue = 0.f; //!< Scalar value at the source (the vertex value for rays)
+    float targetValue = 0.f; //!< Scalar value at the target
 };
 
+//! @brief Represents an edge in a Voronoi diagram.
+/*!
+ * A compact tagged record: segments are stored as two vertex indices, rays
+ * and lines as a source (anchor) vertex index plus a direction. The CGAL
+ * geometry is rebuilt on demand through VoronoiDiagram::edgeSegment(),
+ * edgeRay() and edgeLine(); the dual Delaunay facets are stored in
+ * VoronoiDiagram::edgeFacets.
+ */
 struct VoronoiEdge
 {
-    CGAL::Object edgeObject;
-    int vertex1;          //!< Index of the first vertex ( -1 if infinite )
-    int vertex2;          //!< Index of the second vertex ( -1 if infinite )
-    int type;             //!< 0 for segment, 1 for ray and 2 for lines; -1 for unknown
-    Point source;         //!< Source point for rays and lines; empty for segments
-    Vector3 direction;    //!< Direction vector for rays and lines; empty for segments
-    std::vector<Facet> delaunayFacets; //!< Facet indices in the Delaunay triangulation that correspond to this edge
-    //! @brief constructor
-    /*!
-     * @param obj instance of the edge in CGAL::Object
-     */
-    VoronoiEdge(CGAL::Object obj) : edgeObject(obj), vertex1(-1), vertex2(-1), type(-1), source(), direction(), delaunayFacets()
+    int type = -1;        //!< 0 for segment, 1 for ray and 2 for lines; -1 for unknown
+    int vertex1 = -1;     //!< Index of the first vertex; source vertex for rays, anchor vertex for lines
+    int vertex2 = -1;     //!< Index of the second vertex ( -1 if infinite )
+    int clipIndex = -1;   //!< Rays and lines: index in VoronoiDiagram::clippedEdges, -1 if not clipped or outside the box
+    double direction[3] = {0.0, 0.0, 0.0}; //!< Direction for rays and lines; zero for segments
+
+    //! @brief Direction of a ray or line edge as a CGAL vector.
+    Vector3 directionVector() const
+    {
+        return Vector3(direction[0], direction[1], direction[2]);
+    }
+
+    //! @brief Stores a CGAL direction vector in the compact record.
+    void setDirection(const Vector3 &d)
     {
+        direction[0] = d.x();
+        direction[1] = d.y();
+        direction[2] = d.z();
     }
 
     //! @brief operator< for sorting Voronoi edges
@@ -53,11 +180,9 @@ struct VoronoiEdge
         return std::tie(vertex1, vertex2)
              < std::tie(other.vertex1, other.vertex2);
       }
-      // for rays/lines: lexicographic on (source, direction)
-      auto t1 = std::make_tuple(source.x(), source.y(), source.z(),
-                                direction.x(), direction.y(), direction.z());
-      auto t2 = std::make_tuple(other.source.x(), other.source.y(), other.source.z(),
-                                other.direction.x(), other.direction.y(), other.direction.z());
+      // for rays/lines: lexicographic on (source index, direction)
+      auto t1 = std::make_tuple(vertex1, direction[0], direction[1], direction[2]);
+      auto t2 = std::make_tuple(other.vertex1, other.direction[0], other.direction[1], other.direction[2]);
       return t1 < t2;
     }
 };
@@ -67,69 +192,105 @@ struct VoronoiEdge
  * A midpoint lies on the edge of a Voronoi facet. This structure holds the
  * geometric coordinates of the midpoint, its connectivity, and metadata about
  * its relationship to facets and cycles.
+ *
+ * Within one cell a Voronoi edge borders exactly two facets of the cell, so a
+ * midpoint normally has two neighbours; the adjacency is a fixed-size array
+ * with some slack for degenerate facets instead of a heap-allocated list.
  */
 struct MidpointNode
 {
-    Point point;                   //!< Geometric coordinates of the midpoint.
-    std::vector<int> connected_to; //!< Indices of midpoints connected to this one, forming graph edges.
-    int facet_index;               //!< Index of the facet this midpoint lies on.
-    int cycle_index;               //!< Index of the cycle this midpoint belongs to.
-    int global_edge_index;
+    static constexpr int MaxConnections = 4; //!< Capacity of connected_to
+
+    Point point;                         //!< Geometric coordinates of the midpoint.
+    int connected_to[MaxConnections];    //!< Indices of midpoints connected to this one, forming graph edges.
+    int num_connected;                   //!< Number of valid entries in connected_to.
+    int facet_index;                     //!< Index of the facet this midpoint lies on.
+    int cycle_index;                     //!< Index of the cycle this midpoint belongs to, -1 until extracted.
+    int global_edge_index;               //!< Index of the Voronoi edge the midpoint lies on, -1 if unknown.
+
+    //! @brief Adds a graph edge to `other`.
+    /*!
+     * @return False if the adjacency is full and the edge was dropped.
+     */
+    bool connect(int other)
+    {
+        if (num_connected == MaxConnections)
+            return false;
+        connected_to[num_connected++] = other;
+        return true;
+    }
+};
+
+//! @brief Reusable scratch storage for extracting the cycles of one Voronoi cell.
+/*!
+ * Holds the midpoint graph of the cell being processed. clear() keeps every
+ * buffer's capacity, so once the scratch has seen the largest cell, processing
+ * further cells performs no heap allocation. One instance per thread.
+ */
+struct CycleScratch
+{
+    std::vector<MidpointNode> midpoints;             //!< Midpoints of the bipolar edges of the cell
+    VertexPairMap edgeToMidpoint;                    //!< Voronoi vertex pair -> index in midpoints
+    CsrArray<int> facetMidpoints;                    //!< facet of the cell -> midpoint indices, in facet order
+    CsrArray<int> cycles;                            //!< cycle -> midpoint indices, in traversal order
+    std::vector<int> stack;                          //!< Depth-first search stack
+    std::vector<std::pair<int, int>> cellEdgeCycles; //!< (cell edge, cycle) pairs of the cell, sorted
+    int droppedConnections = 0;                      //!< Graph edges lost to a full adjacency array
+
+    //! @brief Empties all buffers, keeping their capacity.
+    void clear()
+    {
+        midpoints.clear();
+        edgeToMidpoint.clear();
+        facetMidpoints.clear();
+        cycles.clear();
+        stack.clear();
+        cellEdgeCycles.clear();
+    }
 };
 
-//! @brief Represents a facet in a Voronoi diagram.
+//! @brief Signed reference from a Voronoi cell to a shared facet.
 /*!
- * A Voronoi facet is defined by a list of vertices and their scalar values.
- * Facets are part of Voronoi cells.
+ * A Voronoi facet is dual to one Delaunay edge and is stored once, as a row
+ * of VoronoiDiagram::facetVertices, shared by the (at most two) Voronoi cells
+ * it separates. The stored vertex order is the outward orientation for the
+ * first cell referencing it. The mirror of a facet is implicit: the two
+ * cells sharing a facet hold the same facet index with opposite orientations.
  */
-struct VoronoiCellFacet
+struct VoronoiFacetRef
 {
-    std::vector<int> vertices_indices; //!< Indices of vertices forming this facet, ordered.
-    int mirror_facet_index = -1;       //!< Index of the mirror facet in the adjacent cell
-    int facet_index = -1;              //!< Index of the facet within the VoronoiDiagram
-    //! @brief Default constructor.
-    VoronoiCellFacet() = default;
+    int facet_index; //!< Index of the facet within the VoronoiDiagram
+    int orientation; //!< +1 if the stored vertex order points outward from the cell, -1 if reversed
 };
 
 //! @brief Represents a closed cycle in a Voronoi cell formed by midpoints.
 /*!
- * A cycle is a loop of midpoints connected by edges. Each cycle is associated
- * with a Voronoi cell and may have its centroid computed as the cycle's isovertex.
+ * A cycle is a loop of midpoints connected by edges; its centroid is the
+ * cycle's isovertex. Cycles are stored in VoronoiDiagram::cycles, one per
+ * isovertex and in the same order, so the cycles of a cell are the range
+ * [isoVertexStartIndex, isoVertexStartIndex + numIsoVertices). The midpoint
+ * indices of cycle `i` are row `i` of VoronoiDiagram::cycleMidpoints; the
+ * edges of the cycle join consecutive midpoints of that row, closing the loop.
  */
 struct Cycle
 {
-    std::vector<int> midpoint_indices;      //!< Indices of midpoints forming this cycle.
-    std::vector<std::pair<int, int>> edges; //!< Edges forming the cycle, represented by pairs of midpoint indices.
-    Point isovertex;                        //!< Geometric centroid of the cycle, representing the isovertex.
-    int voronoi_cell_index;                 //!< Index of the Voronoi cell this cycle belongs to;
-
     // TODO: record it using the indices of the voronoi edges instead of the midpoints
-    //! @brief Computes the centroid of the cycle.
-    /*!
-     * The centroid (isovertex) is calculated using the CGAL `centroid` function
-     * based on the geometric positions of the midpoints.
-     *
-     * @param midpoints Vector of all midpoints in the diagram. Only the midpoints
-     *                  associated with this cycle are used in the computation.
-     */
-    void compute_centroid(const std::vector<MidpointNode> &midpoints);
-    // Compute centroid of the cycle using the positions in vertices.
-    void compute_centroid(const std::vector<VoronoiVertex> &vertices);
+    Point isovertex;        //!< Geometric centroid of the cycle, representing the isovertex.
+    int voronoi_cell_index; //!< Index of the Voronoi cell this cycle belongs to;
 };
 
 //! @brief Represents a Voronoi cell (polytope) in the Voronoi diagram.
 /*!
  * A Voronoi cell is a polyhedral region associated with a single Delaunay vertex.
- * It contains facets, vertices, and cycles, and may also include isosurface data.
+ * Its vertices and facets are rows of VoronoiDiagram::cellVertices and
+ * VoronoiDiagram::cellFacets; its cycles are the range of VoronoiDiagram::cycles
+ * matching its isosurface vertices.
+ * A half-edge representation is available on demand via VoronoiDiagram::cellPolyhedron().
  */
 struct VoronoiCell
 {
     Vertex_handle delaunay_vertex;     //!< Handle to the corresponding Delaunay vertex.
     int cellIndex;                     //!< Index of this cell in the Voronoi diagram.
-    std::vector<int> vertices_indices; //!< Indices of Voronoi vertices forming this cell.
-    std::vector<int> facet_indices;    //!< Indices of Voronoi facets belonging to this cell.
-    CGAL::Polyhedron_3<K> polyhedron;  //!< Geometric representation of the cell as a polyhedron.
-    std::vector<Cycle> cycles;         //!< Cycles (loops) within this cell.
     int isoVertexStartIndex;           //!< Starting index of isosurface vertices associated with this cell.
     int numIsoVertices;                //!< Number of isosurface vertices in this cell.
 
@@ -141,47 +302,77 @@ struct VoronoiCell
         : delaunay_vertex(vh), isoVertexStartIndex(-1), numIsoVertices(0) {}
 };
 
+//! @brief A Voronoi edge as seen from one of the cells containing it.
+/*!
+ * The cycles of the cell that cross this edge are stored in
+ * VoronoiDiagram::cellEdgeCycles.
+ */
 struct VoronoiCellEdge
 {
     int cellIndex;                 //!< Index of the VoronoiCell that contains this CellEdge
     int edgeIndex;                 //!< Index of this edge in the vector of edges in the VoronoiDiagram instance that contains the cell this egde is in
-    std::vector<int> cycleIndices; //!< Indices of cycles in this VoronoiCell that corresponding to this edge
     int nextCellEdge;              //!< Index of next cell edge around the Voronoi Edge ( VoronoiDiagram.edges[edgeIndex])
 };
 
-//! @brief Hash function for std::tuple<int,int,int>
-/*!
- * Provides a hash function for tuples of three integers,
- * used for vertex indexing in Voronoi diagrams.
- */
-struct TupleHash
+//! @brief Outcome of one validation check.
+struct ValidationResult
 {
-    std::size_t operator()(const std::tuple<int, int, int> &t) const
+    std::string name;    //!< Name of the check
+    bool passed = true;  //!< False if the check found a violation
+    std::string message; //!< First violation found, empty if passed
+    double ms = 0.0;     //!< Wall-clock time of the check
+};
+
+//! @brief Aggregated outcome of VoronoiDiagram::validate().
+struct ValidationReport
+{
+    ValidationLevel level = ValidationLevel::None; //!< Level that was run
+    std::vector<ValidationResult> results;         //!< One entry per check, in a fixed order
+    double ms = 0.0;                               //!< Wall-clock time of the whole validation
+
+    //! @brief Number of failed checks.
+    int violations() const
     {
-        std::size_t seed = 0;
-        seed ^= std::hash<int>{}(std::get<0>(t)) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-        seed ^= std::hash<int>{}(std::get<1>(t)) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-        seed ^= std::hash<int>{}(std::get<2>(t)) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-        return seed;
+        int n = 0;
+        for (const auto &r : results)
+            n += r.passed ? 0 : 1;
+        return n;
     }
+
+    //! @brief True if no check failed.
+    bool ok() const { return violations() == 0; }
+
+    //! @brief One-line JSON summary of the report.
+    std::string toJson() const;
 };
 
 //! @brief Represents the overall Voronoi diagram.
 /*!
  * The Voronoi diagram consists of vertices, edges, cells, facets, and isosurface data.
+ * Variable-length relations between them are stored in CSR form (one offset
+ * array plus one flat value array each) rather than as per-object vectors.
  */
 struct VoronoiDiagram
 {
-    std::vector<VoronoiVertex> vertices;                //!< List of Voronoi vertices in the diagram.
+    VoronoiVertexArray vertices;                        //!< Voronoi vertices of the diagram (SoA).
     std::vector<VoronoiEdge> edges;                     //!< List of edges in the diagram
     std::vector<VoronoiCellEdge> cellEdges;             //!< List of Cell Edges in the diagram
     std::vector<VoronoiCell> cells;                     //!< List of Voronoi cells in the diagram.
-    std::vector<VoronoiCellFacet> facets;               //!< List of facets in the diagram.
+    std::vector<Cycle> cycles;                          //!< Cycles of all cells, one per multi-mode isovertex
 
-    std::unordered_map<std::tuple<int, int, int>, std::vector<int>, TupleHash> vertexMap;   //!< A hash map with keys are a computed tuple of a Point(x,y,z) and value being the index of the Voronoi vertex in vertices with coordinates(x,y,z)
+    CsrArray<Facet> edgeFacets;                //!< edge -> Delaunay facets dual to the edge
+    CsrArray<int> facetVertices;               //!< facet -> ordered Voronoi vertex indices
+    CsrArray<int> cellVertices;                //!< cell -> Voronoi vertex indices, sorted
+    CsrArray<VoronoiFacetRef> cellFacets;      //!< cell -> signed facet references
+    CsrArray<int> cellEdgeCycles;              //!< cell edge -> indices of cycles in its cell crossing the edge
+    CsrArray<int> cycleMidpoints;              //!< cycle -> cell-local midpoint indices, in traversal order
+    CsrArray<int> vertexCells;                 //!< vertex -> indices of cells containing it (transpose of cellVertices)
 
-    std::map<std::pair<int, int>, int> cellEdgeLookup;               //!< Maps (cellIndex, edgeIndex) -> index in cellEdges
-    std::map<std::pair<int, int>, int> segmentVertexPairToEdgeIndex; //!< a map from a pair of Voronoi vertex indices (v_1, v_2) (in ascending order) to the edgeIndex in voronoiDiagram
+    VertexWeldIndex vertexWeld;                   //!< Spatial index from coordinates to the index of the Voronoi vertex at that location
+
+    CsrArray<std::pair<int, int>> cellEdgeLookup; //!< cell -> (edgeIndex, index in cellEdges), each row sorted by edgeIndex
+    VertexPairMap segmentVertexPairToEdgeIndex;   //!< a map from a pair of Voronoi vertex indices (v_1, v_2) to the edgeIndex in voronoiDiagram
+    std::vector<ClippedEdge> clippedEdges;        //!< Clipped rays and lines, referenced by VoronoiEdge::clipIndex
 
 
     // Member Functions
@@ -197,24 +388,49 @@ struct VoronoiDiagram
     /*!
      * @param v1 Index of the first vertex
      * @param v2 Index of the second vertex
-     * @param seg The CGAL segment object
      * @return Index of the newly added edge
      */
-    int AddSegmentEdge(int v1, int v2, const Segment3& seg);
+    int AddSegmentEdge(int v1, int v2);
 
     //! @brief Adds a ray edge to the Voronoi diagram.
     /*!
-     * @param ray The CGAL ray object
+     * @param sourceVertex Index of the Voronoi vertex the ray starts from
+     * @param direction Direction of the ray
      * @return Index of the newly added edge
      */
-    int AddRayEdge(const Ray3& ray);
+    int AddRayEdge(int sourceVertex, const Vector3& direction);
 
     //! @brief Adds a line edge to the Voronoi diagram.
     /*!
-     * @param line The CGAL line object
+     * @param anchorVertex Index of a Voronoi vertex on the line
+     * @param direction Direction of the line
      * @return Index of the newly added edge
      */
-    int AddLineEdge(const Line3& line);
+    int AddLineEdge(int anchorVertex, const Vector3& direction);
+
+    //! @brief Segment geometry of a type 0 edge.
+    Segment3 edgeSegment(const VoronoiEdge &edge) const
+    {
+        return Segment3(vertices.coords[edge.vertex1], vertices.coords[edge.vertex2]);
+    }
+
+    //! @brief Ray geometry of a type 1 edge.
+    Ray3 edgeRay(const VoronoiEdge &edge) const
+    {
+        return Ray3(vertices.coords[edge.vertex1], edge.directionVector());
+    }
+
+    //! @brief Line geometry of a type 2 edge.
+    Line3 edgeLine(const VoronoiEdge &edge) const
+    {
+        return Line3(vertices.coords[edge.vertex1], edge.directionVector());
+    }
+
+    //! @brief Clipped part of a ray or line edge, or nullptr if it misses the box or is a segment.
+    const ClippedEdge *clippedEdge(const VoronoiEdge &edge) const
+    {
+        return edge.clipIndex >= 0 ? &clippedEdges[edge.clipIndex] : nullptr;
+    }
 
     //! @brief Adds a facet to the Voronoi diagram.
     /*!
@@ -223,6 +439,27 @@ struct VoronoiDiagram
      */
     int AddFacet(const std::vector<int>& vertices_indices);
 
+    //! @brief Number of facets in the diagram.
+    int numFacets() const { return static_cast<int>(facetVertices.rows()); }
+
+    //! @brief Rebuilds `vertexCells` from `cellVertices`.
+    void buildVertexCells() { transposeCsr(cellVertices, vertices.size(), vertexCells); }
+
+    //! @brief Rebuilds cellEdgeLookup from cellEdges.
+    void buildCellEdgeLookup();
+
+    //! @brief Index in cellEdges of the (cellIndex, edgeIndex) cell edge, or -1 if there is none.
+    int findCellEdge(int cellIndex, int edgeIndex) const
+    {
+        if (cellIndex < 0 || cellIndex >= static_cast<int>(cellEdgeLookup.rows()))
+            return -1;
+        CsrSpan<const std::pair<int, int>> row = cellEdgeLookup.row(cellIndex);
+        auto it = std::lower_bound(row.begin(), row.end(), std::make_pair(edgeIndex, -1));
+        if (it == row.end() || it->first != edgeIndex)
+            return -1;
+        return it->second;
+    }
+
     //! @brief Adds a cell to the Voronoi diagram.
     /*!
      * @param delaunay_vertex Handle to the corresponding Delaunay vertex
@@ -233,6 +470,13 @@ struct VoronoiDiagram
     //! @brief Checks internal consistency of the VoronoiDiagram.
     void check() const;
 
+    //! @brief Runs the checks of the given level and collects their outcomes.
+    /*!
+     * Checks of the full level are independent and run concurrently. No
+     * exception is thrown; violations are reported in the result.
+     */
+    ValidationReport validate(ValidationLevel level) const;
+
     //! @brief Comprehensive checker for Voronoi diagram consistency.
     void checkAdvanced() const;
 
@@ -243,7 +487,42 @@ struct VoronoiDiagram
      */
     int find_vertex(const Point &p) const;
 
+    //! @brief Returns the k-th vertex of a facet as seen from the referencing cell.
+    /*!
+     * A reversed reference walks the stored cycle backwards starting at the
+     * same first vertex, so vertex k is `V[(n - k) % n]`.
+     *
+     * @param ref Signed facet reference held by a cell
+     * @param k Position in the outward-oriented cycle
+     * @return Index of the Voronoi vertex
+     */
+    int facetVertex(const VoronoiFacetRef &ref, int k) const
+    {
+        CsrSpan<const int> V = facetVertices.row(ref.facet_index);
+        const int n = static_cast<int>(V.size());
+        return (ref.orientation > 0) ? V[k % n] : V[(n - k % n) % n];
+    }
+
+    //! @brief Returns the polyhedron of a cell, building it on first request.
+    /*!
+     * Cells do not embed a Polyhedron_3. Consumers that need the half-edge
+     * structure get it from a lazily populated side table, built from the
+     * cell's outward-oriented facets. Not thread-safe.
+     *
+     * @param cellIndex Index of the cell in `cells`
+     * @return Reference to the cached polyhedron (valid until the cache is cleared)
+     */
+    const Polyhedron_3 &cellPolyhedron(int cellIndex) const;
+
+    //! @brief Releases all cached cell polyhedra.
+    void clearPolyhedronCache() const { polyhedronCache.clear(); }
+
+    //! @brief Number of cell polyhedra currently cached.
+    size_t polyhedronCacheSize() const { return polyhedronCache.size(); }
+
 private:
+    mutable std::unordered_map<int, Polyhedron_3> polyhedronCache; //!< Side table of cell polyhedra, keyed by cell index.
+
     //! @brief Verifies that `cellEdgeLookup` matches the data in `cellEdges`.
     void checkCellEdgeLookup() const;
 
@@ -253,6 +532,9 @@ private:
     //! @brief Checks each VoronoiCell's facets to ensure that every facet's vertices are in the cell's vertex set.
     void checkCellFacets() const;
 
+    //! @brief Checks that every stored index refers to an existing element.
+    void checkIndexRanges() const;
+
     //! @brief Helper methods for checkAdvanced
     void checkFacetVertexCount() const;
     void checkCellFacetCount() const;
@@ -264,17 +546,15 @@ private:
     //! @brief Helper methods for checkNextCellEdgeConsistency
     void checkNextCellEdgeValidity() const;
     void checkEdgeCycles() const;
-
-    /// Hash a facet by its three smallest vertex indices (for “at most two cells” check)
-    std::tuple<int, int, int> getFacetHashKey(const std::vector<int> &verts) const;
-
-    /// Do two facet‐vertex‐sequences represent the same cyclic orientation?
-    bool haveSameOrientation(const std::vector<int> &f1,
-                             const std::vector<int> &f2) const;
 };
 
-// Add standalone function declaration at the end of vdc_voronoi.h
-VoronoiDiagram collapseSmallEdges(const VoronoiDiagram &vd, double D, const CGAL::Epick::Iso_cuboid_3 &bbox);
+//! @brief Collapses Voronoi edges not longer than D, in place.
+/*!
+ * @param vd Voronoi diagram with vertices and edges (no cells yet)
+ * @param D Distance threshold; D <= 0 disables collapsing
+ * @param dt Delaunay triangulation whose cells are remapped to the surviving vertices
+ */
+void collapseSmallEdges(VoronoiDiagram &vd, double D, Delaunay &dt);
 
 //! @brief Represents an isosurface in the domain.
 /*!
@@ -377,77 +657,93 @@ struct LineKeyComparator
     }
 };
 
-//! @brief Overloaded output operator for VoronoiFacet.
-template <typename OSTREAM_TYPE>
-OSTREAM_TYPE &operator<<(OSTREAM_TYPE &os, const VoronoiCellFacet &vf)
-{
-    os << "VoronoiFacet:\n";
-    os << "  Vertices indices: ";
-    for (const int idx : vf.vertices_indices)
-        os << idx << " ";
-    os << "\n";
-
-
-    return os;
-}
-
-//! @brief Overloaded output operator for Cycle
+//! @brief Writes a Cycle, including its row of VoronoiDiagram::cycleMidpoints.
 template <typename OSTREAM_TYPE>
-OSTREAM_TYPE &operator<<(OSTREAM_TYPE &os, const Cycle &cycle)
+void printCycle(OSTREAM_TYPE &os, const VoronoiDiagram &vd, int cycleIndex)
 {
+    const Cycle &cycle = vd.cycles[cycleIndex];
     os << "Cycle:\n";
     os << "  Voronoi cell index: " << cycle.voronoi_cell_index << "\n";
     os << "  Isovertex: " << cycle.isovertex << "\n";
 
+    CsrSpan<const int> mids;
+    if (cycleIndex < static_cast<int>(vd.cycleMidpoints.rows()))
+        mids = vd.cycleMidpoints.row(cycleIndex);
+
     os << "  Midpoint indices: ";
-    for (const int idx : cycle.midpoint_indices)
+    for (const int idx : mids)
         os << idx << " ";
     os << "\n";
 
     os << "  Edges: ";
-    for (const auto &edge : cycle.edges)
-        os << "(" << edge.first << ", " << edge.second << ") ";
+    for (size_t i = 0; i < mids.size(); ++i)
+        os << "(" << mids[i] << ", " << mids[(i + 1) % mids.size()] << ") ";
     os << "\n";
-
-    return os;
-}
-
-//! @brief Overloaded output operator for VoronoiVertex
-template <typename OSTREAM_TYPE>
-OSTREAM_TYPE &operator<<(OSTREAM_TYPE &os, const VoronoiVertex &vv)
-{
-    os << "VoronoiVertex:\n";
-    os << "  Vertex: " << vv.coord << "\n";
-
-    return os;
 }
 
-//! @brief Overloaded output operator for VoronoiCell
+//! @brief Writes a VoronoiCell, including its rows of the diagram's cell relations.
 template <typename OSTREAM_TYPE>
-OSTREAM_TYPE &operator<<(OSTREAM_TYPE &os, const VoronoiCell &vc)
+void printVoronoiCell(OSTREAM_TYPE &os, const VoronoiDiagram &vd, int cellIndex)
 {
+    const VoronoiCell &vc = vd.cells[cellIndex];
     os << "VoronoiCell:\n";
     os << "  Cell index: " << vc.cellIndex << "\n";
     os << "  Delaunay vertex: " << vc.delaunay_vertex->point() << "\n";
 
     os << "  Voronoi Vertices indices: ";
-    for (const int idx : vc.vertices_indices)
+    for (const int idx : vd.cellVertices.row(cellIndex))
         os << idx << " ";
     os << "\n";
 
     os << "  Facet indices: ";
-    for (const int idx : vc.facet_indices)
-        os << idx << " ";
+    for (const auto &ref : vd.cellFacets.row(cellIndex))
+        os << ref.facet_index << " ";
     os << "\n";
 
     os << "  IsoVertex start index: " << vc.isoVertexStartIndex << "\n";
     os << "  Number of isoVertices: " << vc.numIsoVertices << "\n";
 
+    os << "  Facet orientations: ";
+    for (const auto &ref : vd.cellFacets.row(cellIndex))
+        os << ref.orientation << " ";
+    os << "\n";
+
     os << "  Cycles:\n";
-    for (const auto &cycle : vc.cycles)
-        os << cycle;
+    for (int i = 0; i < vc.numIsoVertices && vc.isoVertexStartIndex + i < static_cast<int>(vd.cycles.size()); ++i)
+        printCycle(os, vd, vc.isoVertexStartIndex + i);
+}
 
-    return os;
+//! @brief Writes a VoronoiCellEdge, including its cycle indices.
+template <typename OSTREAM_TYPE>
+void printVoronoiCellEdge(OSTREAM_TYPE &os, const VoronoiDiagram &vd, int cellEdgeIndex)
+{
+    const VoronoiCellEdge &ce = vd.cellEdges[cellEdgeIndex];
+    os << "VoronoiCellEdge:\n"
+       << "  cellIndex:    " << ce.cellIndex << "\n"
+       << "  edgeIndex:    " << ce.edgeIndex << "\n"
+       << "  nextCellEdge: " << ce.nextCellEdge << "\n"
+       << "  cycleIndices: ";
+
+    CsrSpan<const int> cycles;
+    if (cellEdgeIndex < static_cast<int>(vd.cellEdgeCycles.rows()))
+        cycles = vd.cellEdgeCycles.row(cellEdgeIndex);
+
+    if (cycles.empty())
+    {
+        os << "(none)";
+    }
+    else
+    {
+        os << "{ ";
+        for (size_t i = 0; i < cycles.size(); ++i)
+        {
+            os << cycles[i];
+            if (i + 1 < cycles.size())
+                os << ", ";
+        }
+        os << " }";
+    }
+    os << "\n";
 }
 
 //! @brief Overloaded output operator for VoronoiDiagram
@@ -461,7 +757,8 @@ OSTREAM_TYPE &operator<<(OSTREAM_TYPE &os, const VoronoiDiagram &vd)
     for (size_t i = 0; i < vd.vertices.size(); ++i)
     {
         os << "Index " << i << ":\n";
-        os << vd.vertices[i];
+        os << "VoronoiVertex:\n";
+        os << "  Vertex: " << vd.vertices.coords[i] << "\n";
     }
 
     // 2. Voronoi Edges
@@ -469,20 +766,20 @@ OSTREAM_TYPE &operator<<(OSTREAM_TYPE &os, const VoronoiDiagram &vd)
     for (const auto &edge : vd.edges)
     {
         os << "  Edge: ";
-        Segment3 segment;
-        Line3 line;
-        Ray3 ray;
 
-        if (CGAL::assign(segment, edge.edgeObject))
+        if (edge.type == 0)
         {
+            Segment3 segment = vd.edgeSegment(edge);
             os << "Segment(" << segment.source() << " - " << segment.target() << ")\n";
         }
-        else if (CGAL::assign(line, edge.edgeObject))
+        else if (edge.type == 2)
         {
+            Line3 line = vd.edgeLine(edge);
             os << "Line(" << line.point(0) << " - " << line.point(1) << ")\n";
         }
-        else if (CGAL::assign(ray, edge.edgeObject))
+        else if (edge.type == 1)
         {
+            Ray3 ray = vd.edgeRay(edge);
             os << "Ray(" << ray.source() << ", direction: " << ray.direction() << ")\n";
         }
         else
@@ -495,23 +792,27 @@ OSTREAM_TYPE &operator<<(OSTREAM_TYPE &os, const VoronoiDiagram &vd)
     os << "\nvertexValues:\n";
     for (size_t i = 0; i < vd.vertices.size(); ++i)
     {
-        os << "  Index " << i << ": " << vd.vertices[i].value << "\n";
+        os << "  Index " << i << ": " << vd.vertices.values[i] << "\n";
     }
 
     // 4. Voronoi Facets
     os << "\nVoronoiFacets:\n";
-    for (size_t i = 0; i < vd.facets.size(); ++i)
+    for (int i = 0; i < vd.numFacets(); ++i)
     {
         os << "Index " << i << ":\n";
-        os << vd.facets[i];
+        os << "VoronoiFacet:\n";
+        os << "  Vertices indices: ";
+        for (const int idx : vd.facetVertices.row(i))
+            os << idx << " ";
+        os << "\n";
     }
 
     // 5. Voronoi Cells
     os << "\ncells:\n";
-    for (const auto &cell : vd.cells)
+    for (int i = 0; i < static_cast<int>(vd.cells.size()); ++i)
     {
-        os << "\n"
-           << cell;
+        os << "\n";
+        printVoronoiCell(os, vd, i);
     }
 
     // 6. Voronoi CellEdges
@@ -519,63 +820,36 @@ OSTREAM_TYPE &operator<<(OSTREAM_TYPE &os, const VoronoiDiagram &vd)
     for (size_t i = 0; i < vd.cellEdges.size(); ++i)
     {
         os << "Index " << i << ":\n";
-        os << vd.cellEdges[i];
+        printVoronoiCellEdge(os, vd, static_cast<int>(i));
     }
 
     // 7. Print the two new maps
 
     // 7a. cellEdgeLookup
     os << "\ncellEdgeLookup ( (cellIndex, edgeIndex) -> cellEdges index ):\n";
-    for (const auto &kv : vd.cellEdgeLookup)
+    for (int cellIndex = 0; cellIndex < static_cast<int>(vd.cellEdgeLookup.rows()); ++cellIndex)
     {
-        int cellIndex = kv.first.first;
-        int edgeIndex = kv.first.second;
-        int ceIdx = kv.second;
-        os << "  ( " << cellIndex << ", " << edgeIndex << " ) -> " << ceIdx << "\n";
+        for (const auto &entry : vd.cellEdgeLookup.row(cellIndex))
+        {
+            os << "  ( " << cellIndex << ", " << entry.first << " ) -> " << entry.second << "\n";
+        }
     }
 
     // 7b. segmentVertexPairToEdgeIndex
     os << "\nsegmentVertexPairToEdgeIndex ( (v1, v2) -> edgeIndex ):\n";
-    for (const auto &kv : vd.segmentVertexPairToEdgeIndex)
+    std::vector<std::array<int, 3>> segmentPairs; // Sorted by vertex pair for stable output
+    segmentPairs.reserve(vd.segmentVertexPairToEdgeIndex.size());
+    vd.segmentVertexPairToEdgeIndex.forEach([&](int v1, int v2, int edgeIndex)
+                                            { segmentPairs.push_back({v1, v2, edgeIndex}); });
+    std::sort(segmentPairs.begin(), segmentPairs.end());
+    for (const auto &sp : segmentPairs)
     {
-        int v1 = kv.first.first;
-        int v2 = kv.first.second;
-        int edgeIndex = kv.second;
-        os << "  ( " << v1 << ", " << v2 << " ) -> " << edgeIndex << "\n";
+        os << "  ( " << sp[0] << ", " << sp[1] << " ) -> " << sp[2] << "\n";
     }
 
     return os;
 }
 
-//! @brief Stream operator for VoronoiCellEdge
-template <typename OSTREAM_TYPE>
-OSTREAM_TYPE &operator<<(OSTREAM_TYPE &os, const VoronoiCellEdge &ce)
-{
-    os << "VoronoiCellEdge:\n"
-       << "  cellIndex:    " << ce.cellIndex << "\n"
-       << "  edgeIndex:    " << ce.edgeIndex << "\n"
-       << "  nextCellEdge: " << ce.nextCellEdge << "\n"
-       << "  cycleIndices: ";
-
-    if (ce.cycleIndices.empty())
-    {
-        os << "(none)";
-    }
-    else
-    {
-        os << "{ ";
-        for (size_t i = 0; i < ce.cycleIndices.size(); ++i)
-        {
-            os << ce.cycleIndices[i];
-            if (i + 1 < ce.cycleIndices.size())
-                os << ", ";
-        }
-        os << " }";
-    }
-    os << "\n";
-    return os;
-}
-
 inline std::ostream& operator<<(std::ostream& os, IsoSurface const& iso) {
     os << "IsoSurface: "
        << iso.isosurfaceVertices.size() << " verts, "
@@ -598,7 +872,4 @@ inline std::ostream& operator<<(std::ostream& os, IsoSurface const& iso) {
     return os;
 }
 
-// Helper function declarations (internal linkage)
-std::tuple<int, int, int> getFacetHashKey(const std::vector<int> &vertices);
-bool haveSameOrientation(const std::vector<int> &facet1, const std::vector<int> &facet2);
 #endif
\ No newline at end of file
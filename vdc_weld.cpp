@@ -0,0 +1,161 @@
+#include "vdc_weld.h"
+
+#include <algorithm>
+#include <cmath>
+
+//! @brief Creates an empty index for the given tolerance.
+/*!
+ * Cubes have side `2 * tolerance`, so a point within the tolerance of a query
+ * lies either in the query's cube or in the adjacent cube on the nearer side
+ * along each axis.
+ *
+ * @param tolerance Per-axis matching tolerance (> 0).
+ */
+VertexWeldIndex::VertexWeldIndex(double tolerance)
+    : tol(tolerance), invCell(1.0 / (2.0 * tolerance))
+{
+}
+
+//! @brief 64-bit mix of a grid cube (nested splitmix64 finalizers).
+std::uint64_t VertexWeldIndex::hashCell(std::int64_t cx, std::int64_t cy, std::int64_t cz)
+{
+    auto mix = [](std::uint64_t x)
+    {
+        x += 0x9e3779b97f4a7c15ULL;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    };
+    return mix(static_cast<std::uint64_t>(cx) + mix(static_cast<std::uint64_t>(cy) + mix(static_cast<std::uint64_t>(cz))));
+}
+
+//! @brief Grid cube coordinate of `x` along one axis.
+std::int64_t VertexWeldIndex::quantize(double x) const
+{
+    return static_cast<std::int64_t>(std::floor(x * invCell));
+}
+
+//! @brief Removes all entries; keeps the table capacity and the statistics.
+void VertexWeldIndex::clear()
+{
+    for (Slot &s : slots)
+        s.index = -1;
+    count = 0;
+}
+
+//! @brief Sizes the table for `n` entries (load factor at most 1/2).
+void VertexWeldIndex::reserve(size_t n)
+{
+    size_t capacity = 16;
+    while (capacity < 2 * n)
+        capacity *= 2;
+    if (capacity > slots.size())
+        rehash(capacity);
+}
+
+//! @brief Bulk build: sizes the table once, then inserts every point without lookups.
+/*!
+ * Entry `i` refers to `coords[i]`. Coincident points all get entries; find()
+ * returns the smallest matching index.
+ *
+ * @param coords Vertex coordinates.
+ */
+void VertexWeldIndex::build(const std::vector<Point> &coords)
+{
+    clear();
+    reserve(coords.size());
+    for (size_t i = 0; i < coords.size(); ++i)
+    {
+        const Point &p = coords[i];
+        insertCell(quantize(p.x()), quantize(p.y()), quantize(p.z()), static_cast<int>(i));
+    }
+}
+
+//! @brief Adds an entry for vertex `index` located at `p`.
+void VertexWeldIndex::insert(const Point &p, int index)
+{
+    if (2 * (count + 1) > slots.size())
+        rehash(std::max<size_t>(16, 2 * slots.size()));
+    insertCell(quantize(p.x()), quantize(p.y()), quantize(p.z()), index);
+}
+
+//! @brief Places an entry in the first free slot of its probe sequence.
+void VertexWeldIndex::insertCell(std::int64_t cx, std::int64_t cy, std::int64_t cz, int index)
+{
+    size_t slot = hashCell(cx, cy, cz) & mask;
+    while (slots[slot].index >= 0)
+        slot = (slot + 1) & mask;
+    slots[slot] = {cx, cy, cz, index};
+    ++count;
+}
+
+//! @brief Moves all entries into a table of `capacity` slots (a power of two).
+void VertexWeldIndex::rehash(size_t capacity)
+{
+    std::vector<Slot> old(capacity, Slot{0, 0, 0, -1});
+    old.swap(slots);
+    mask = capacity - 1;
+    count = 0;
+    for (const Slot &s : old)
+    {
+        if (s.index >= 0)
+            insertCell(s.cx, s.cy, s.cz, s.index);
+    }
+}
+
+//! @brief Finds the smallest vertex index within `maxDist` of `p` along every axis.
+/*!
+ * @param p Query point.
+ * @param coords Vertex coordinates the stored indices refer to.
+ * @param maxDist Per-axis distance bound, at most tolerance().
+ * @return The vertex index, or -1 if no stored vertex is close enough.
+ */
+int VertexWeldIndex::find(const Point &p, const std::vector<Point> &coords, double maxDist) const
+{
+    ++counters.lookups;
+    if (count == 0)
+        return -1;
+
+    const double q[3] = {p.x() * invCell, p.y() * invCell, p.z() * invCell};
+    std::int64_t base[3], side[3];
+    for (int a = 0; a < 3; ++a)
+    {
+        const double c = std::floor(q[a]);
+        base[a] = static_cast<std::int64_t>(c);
+        side[a] = (q[a] - c < 0.5) ? -1 : 1; // Nearer neighbour along this axis
+    }
+
+    int best = -1;
+    for (int corner = 0; corner < 8; ++corner)
+    {
+        const std::int64_t cx = base[0] + ((corner & 1) ? side[0] : 0);
+        const std::int64_t cy = base[1] + ((corner & 2) ? side[1] : 0);
+        const std::int64_t cz = base[2] + ((corner & 4) ? side[2] : 0);
+        ++counters.cells;
+
+        for (size_t slot = hashCell(cx, cy, cz) & mask;; slot = (slot + 1) & mask)
+        {
+            const Slot &s = slots[slot];
+            ++counters.probes;
+            if (s.index < 0)
+                break;
+            if (s.cx != cx || s.cy != cy || s.cz != cz)
+            {
+                ++counters.collisions;
+                continue;
+            }
+            const Point &v = coords[s.index];
+            if (std::abs(v.x() - p.x()) < maxDist &&
+                std::abs(v.y() - p.y()) < maxDist &&
+                std::abs(v.z() - p.z()) < maxDist &&
+                (best < 0 || s.index < best))
+            {
+                best = s.index;
+            }
+        }
+    }
+
+    if (best >= 0)
+        ++counters.hits;
+    return best;
+}
@@ -0,0 +1,99 @@
+//! @file vdc_weld.h
+//! @brief Spatial welding index used to identify coincident Voronoi vertices.
+
+#ifndef VDC_WELD_H
+#define VDC_WELD_H
+
+#include "vdc_type.h"
+#include <cstdint>
+#include <vector>
+
+//! @brief Lookup counters of a VertexWeldIndex.
+struct WeldStats
+{
+    size_t lookups = 0;    //!< Calls to find()
+    size_t hits = 0;       //!< Lookups that returned a vertex
+    size_t cells = 0;      //!< Grid cells visited by lookups
+    size_t probes = 0;     //!< Table slots examined by lookups
+    size_t collisions = 0; //!< Examined slots holding an entry of another grid cell
+};
+
+//! @brief Open-addressing grid hash mapping points to vertex indices.
+/*!
+ * Space is divided into cubes of side twice the tolerance. Cube coordinates
+ * are 64-bit integers, so the index does not overflow for large domains.
+ * Entries are (cube, vertex index) records in a flat linear-probing table.
+ * A lookup visits the cube of the query and, along each axis, the neighbour
+ * on the side nearest to the query, so points straddling a cube boundary
+ * are found (at most 8 cubes).
+ *
+ * Coordinates are not stored; callers pass the vertex coordinate array that
+ * the indices refer to. Not thread-safe (lookups update the statistics).
+ */
+class VertexWeldIndex
+{
+public:
+    //! @brief Creates an empty index for the given tolerance.
+    explicit VertexWeldIndex(double tolerance = 5e-5);
+
+    //! @brief Matching tolerance (per axis) of the index.
+    double tolerance() const { return tol; }
+
+    //! @brief Removes all entries; keeps the table capacity and the statistics.
+    void clear();
+
+    //! @brief Sizes the table for `n` entries without rehashing.
+    void reserve(size_t n);
+
+    //! @brief Bulk build: replaces the contents with one entry per point of `coords`.
+    void build(const std::vector<Point> &coords);
+
+    //! @brief Adds an entry for vertex `index` located at `p`.
+    void insert(const Point &p, int index);
+
+    //! @brief Smallest vertex index within `tolerance()` of `p` (per axis), or -1.
+    int find(const Point &p, const std::vector<Point> &coords) const { return find(p, coords, tol); }
+
+    //! @brief Smallest vertex index within `maxDist` of `p` (per axis), or -1.
+    /*!
+     * `maxDist` must not exceed tolerance().
+     */
+    int find(const Point &p, const std::vector<Point> &coords, double maxDist) const;
+
+    //! @brief Number of entries.
+    size_t size() const { return count; }
+
+    //! @brief Fraction of table slots in use.
+    double loadFactor() const { return slots.empty() ? 0.0 : static_cast<double>(count) / slots.size(); }
+
+    //! @brief Lookup counters accumulated since construction or resetStats().
+    const WeldStats &stats() const { return counters; }
+
+    //! @brief Clears the lookup counters.
+    void resetStats() { counters = WeldStats(); }
+
+    //! @brief Approximate heap footprint in bytes.
+    size_t bytes() const { return slots.capacity() * sizeof(Slot); }
+
+private:
+    //! @brief One table entry; `index < 0` marks a free slot.
+    struct Slot
+    {
+        std::int64_t cx, cy, cz; //!< Grid cube of the vertex
+        int index;               //!< Vertex index
+    };
+
+    static std::uint64_t hashCell(std::int64_t cx, std::int64_t cy, std::int64_t cz);
+    std::int64_t quantize(double x) const;
+    void insertCell(std::int64_t cx, std::int64_t cy, std::int64_t cz, int index);
+    void rehash(size_t capacity);
+
+    double tol;                  //!< Matching tolerance
+    double invCell;              //!< 1 / cube side
+    std::vector<Slot> slots;     //!< Power-of-two table
+    size_t mask = 0;             //!< Table size minus one
+    size_t count = 0;            //!< Number of entries
+    mutable WeldStats counters;  //!< Lookup statistics
+};
+
+#endif // VDC_WELD_H
@@ -4,6 +4,7 @@ import sys
 import numpy as np
 import matplotlib.pyplot as plt
 from mpl_toolkits.mplot3d.art3d import Poly3DCollection, Line3DCollection
+from readVD import read_vd, to_vis_structures
 
 def parse_vd_info(filename):
     with open(filename, 'r') as f:
@@ -184,6 +185,7 @@ def main():
     if len(sys.argv) < 3:
         print("Usage: python3 visVD.py vd_info.txt [cell indices]")
         print("Example: python3 visVD.py vd_info.txt 1 2 3")
+        print("vd_info may also be a binary dump (VoronoiDiagram_<name>.vdb[.gz]).")
         sys.exit(1)
 
     filename = sys.argv[1]
@@ -196,8 +198,11 @@ def main():
     # Convert to integers
     cell_indices = [int(idx) for idx in cell_indices]
 
-    # Parse the vd_info.txt file
-    voronoi_vertices, voronoi_facets, voronoi_cells, isosurface_vertices = parse_vd_info(filename)
+    # Parse the vd_info.txt file, or load a binary dump
+    if filename.endswith('.vdb') or filename.endswith('.vdb.gz'):
+        voronoi_vertices, voronoi_facets, voronoi_cells, isosurface_vertices = to_vis_structures(read_vd(filename))
+    else:
+        voronoi_vertices, voronoi_facets, voronoi_cells, isosurface_vertices = parse_vd_info(filename)
 
     # Create a 3D plot
     fig = plt.figure()